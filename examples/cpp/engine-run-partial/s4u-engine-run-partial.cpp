@@ -0,0 +1,47 @@
+/* Copyright (c) 2021. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* This example shows how to use simgrid::s4u::Engine::run_until() to run the simulation up to a given date,
+ * inspect it from main(), and then resume it. This is useful to couple SimGrid with an external controller.
+ */
+
+#include <simgrid/s4u.hpp>
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(s4u_engine_run_partial, "Messages specific for this s4u example");
+
+static void worker()
+{
+  for (int i = 0; i < 3; i++) {
+    simgrid::s4u::this_actor::execute(98095000);
+    XBT_INFO("Computation %d done", i);
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  simgrid::s4u::Engine e(&argc, argv);
+  xbt_assert(argc > 1, "Usage: %s platform_file\n\tExample: %s ../platforms/small_platform.xml\n", argv[0], argv[0]);
+
+  e.load_platform(argv[1]);
+  simgrid::s4u::Actor::create("worker", simgrid::s4u::Host::by_name("Tremblay"), worker);
+  simgrid::s4u::Engine::on_simulation_end.connect(
+      []() { XBT_INFO("Simulation ended at %g", simgrid::s4u::Engine::get_clock()); });
+
+  /* Run the simulation step by step, and give control back to main() after each step */
+  for (double date : {0.5, 1.0, 2.0}) {
+    e.run_until(date);
+    XBT_INFO("Simulation stopped at %g, %zu actor(s) still alive", simgrid::s4u::Engine::get_clock(),
+             e.get_actor_count());
+  }
+
+  /* Asking for a date after the end of the simulation stops at its end, and does not notify that end twice */
+  e.run_until(10.0);
+  XBT_INFO("Simulation stopped at %g, %zu actor(s) still alive", simgrid::s4u::Engine::get_clock(),
+           e.get_actor_count());
+  e.run();
+  XBT_INFO("Simulation is over");
+
+  return 0;
+}
@@ -0,0 +1,78 @@
+/* Copyright (c) 2021. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* This example shows how to explore several variants of a simulation that share the same warm-up phase, without
+ * simulating that phase again for each variant. The simulation is run up to the end of the warm-up with
+ * simgrid::s4u::Engine::run_until(), and the process is then forked once per variant. Each child process modifies its
+ * copy of the simulation and runs it to its end, while the parent waits for it before forking the next variant.
+ *
+ * This does not work with the thread contexts, since only the thread calling fork() survives in the child process.
+ */
+
+#include <simgrid/s4u.hpp>
+#include <sys/wait.h>
+#include <unistd.h>
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(s4u_engine_run_variants, "Messages specific for this s4u example");
+
+static void sender()
+{
+  simgrid::s4u::Mailbox* mbox = simgrid::s4u::Mailbox::by_name("receiver");
+  for (int i = 0; i < 4; i++)
+    mbox->put(new int(i), 5e7);
+}
+
+static void receiver()
+{
+  simgrid::s4u::Mailbox* mbox = simgrid::s4u::Mailbox::by_name("receiver");
+  for (int i = 0; i < 4; i++) {
+    auto msg = mbox->get_unique<int>();
+    XBT_INFO("Message %d received", *msg);
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  simgrid::s4u::Engine e(&argc, argv);
+  xbt_assert(argc > 1, "Usage: %s platform_file\n\tExample: %s ../platforms/small_platform.xml\n", argv[0], argv[0]);
+
+  e.load_platform(argv[1]);
+  simgrid::s4u::Host* tremblay = simgrid::s4u::Host::by_name("Tremblay");
+  simgrid::s4u::Host* jupiter  = simgrid::s4u::Host::by_name("Jupiter");
+  simgrid::s4u::Actor::create("sender", tremblay, sender);
+  simgrid::s4u::Actor::create("receiver", jupiter, receiver);
+
+  /* The warm-up phase is simulated only once */
+  e.run_until(10.0);
+  XBT_INFO("End of the warm-up phase");
+
+  std::vector<simgrid::s4u::Link*> route;
+  double latency = 0;
+  tremblay->route_to(jupiter, route, &latency);
+
+  /* Each variant is simulated in a child process, that gets a copy of the simulation at the end of the warm-up */
+  for (double factor : {2.0, 4.0}) {
+    pid_t pid = fork();
+    xbt_assert(pid >= 0, "Cannot fork the simulation");
+    if (pid == 0) {
+      XBT_INFO("Variant: the bandwidth of the route is multiplied by %g", factor);
+      for (auto* link : route)
+        link->set_bandwidth(link->get_bandwidth() * factor);
+      e.run();
+      XBT_INFO("Variant over");
+      return 0;
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    xbt_assert(WIFEXITED(status) && WEXITSTATUS(status) == 0, "The variant failed");
+  }
+
+  /* The parent process goes on with the unmodified simulation */
+  XBT_INFO("Reference simulation");
+  e.run();
+  XBT_INFO("Simulation over");
+
+  return 0;
+}
@@ -106,6 +106,7 @@ template <class T> class Flag;
 
 namespace kernel {
 class EngineImpl;
+class Profiler;
 namespace actor {
 class ActorImpl;
 using ActorImplPtr = boost::intrusive_ptr<ActorImpl>;
@@ -0,0 +1,134 @@
+/* Copyright (c) 2021. The SimGrid Team.
+ * All rights reserved.                                                     */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#ifndef SIMGRID_KERNEL_PROFILER_HPP
+#define SIMGRID_KERNEL_PROFILER_HPP
+
+#include <simgrid/forward.h>
+#include <xbt/base.h>
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+namespace simgrid {
+namespace kernel {
+
+/** @brief Wall-clock time spent in a phase of the simulation kernel, and number of times it was entered */
+struct ProfiledPhase {
+  double elapsed           = 0.0; // in seconds
+  unsigned long long calls = 0;
+};
+
+/** @brief What a model cost, as measured by the Profiler */
+struct ProfiledModel {
+  ProfiledPhase solve;         // next_occurring_event(): sharing of the resources between the actions
+  ProfiledPhase update;        // update_actions_state()
+  size_t max_actions     = 0;  // peak number of started actions
+  size_t max_variables   = 0;  // peak number of variables in the LMM system
+  size_t max_constraints = 0;  // peak number of active constraints in the LMM system
+};
+
+/** @brief Self-profiler of the simulation kernel, enabled with --cfg=debug/profile:yes
+ *
+ * It accumulates the wall-clock time spent in each phase of the main loop, and in each model. The time of a model or of
+ * the tracing is not counted again in the phase from which it is reached, so all the times can be summed up.
+ * Everything is written as JSON at the end of the simulation, in the file given by debug/profile-file.
+ */
+class XBT_PUBLIC Profiler {
+public:
+  enum class Phase { ACTORS, SIMCALLS, TASKS, SOLVE, TIMERS, TRASH, TRACING };
+  static constexpr int PHASE_COUNT = static_cast<int>(Phase::TRACING) + 1;
+  static const char* to_c_str(Phase phase);
+
+  /** Accounts the time spent in a scope to a phase, when the profiler is enabled
+   *
+   * Scopes may be nested (the tracing or the models are reached from the solve phase): the time spent in a nested
+   * scope is only accounted to that scope, and subtracted from the enclosing one, so that no time is counted twice.
+   */
+  class Scope {
+    ProfiledPhase* phase_;
+    Scope* parent_ = nullptr;
+    double nested_ = 0.0; // time spent in the nested scopes
+    std::chrono::steady_clock::time_point start_;
+
+  public:
+    explicit Scope(ProfiledPhase* phase) : phase_(phase)
+    {
+      if (phase_ != nullptr) {
+        parent_        = current_scope_;
+        current_scope_ = this;
+        start_         = std::chrono::steady_clock::now();
+      }
+    }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope()
+    {
+      if (phase_ != nullptr) {
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+        phase_->elapsed += elapsed - nested_;
+        phase_->calls++;
+        if (parent_ != nullptr)
+          parent_->nested_ += elapsed;
+        current_scope_ = parent_;
+      }
+    }
+  };
+
+  static bool is_enabled() { return enabled_; }
+  static Profiler& get_instance();
+
+  /** Starts the profiler if debug/profile is set. Called at the beginning of each run of the simulation. */
+  static void start();
+  /** Accounts the time spent in the main loop since start() */
+  static void stop();
+
+  const ProfiledPhase& get_phase(Phase phase) const { return phases_[static_cast<int>(phase)]; }
+  /** The models that were profiled, by name */
+  const std::map<std::string, ProfiledModel, std::less<>>& get_models() const { return models_; }
+  /** Wall-clock time spent in the main loop of the simulation */
+  double get_total_time() const { return run_.elapsed; }
+
+  void dump_json(std::ostream& os) const;
+
+  /** Where to account the given phase, or nullptr when the profiler is disabled */
+  static ProfiledPhase* phase(Phase phase)
+  {
+    return enabled_ ? &get_instance().phases_[static_cast<int>(phase)] : nullptr;
+  }
+  /** Where to account the resource sharing of the given model, or nullptr when the profiler is disabled */
+  static ProfiledPhase* solve(const resource::Model* model)
+  {
+    return enabled_ ? &get_instance().get_model(model).solve : nullptr;
+  }
+  /** Where to account the update of the given model, or nullptr when the profiler is disabled */
+  static ProfiledPhase* update(const resource::Model* model)
+  {
+    return enabled_ ? &get_instance().get_model(model).update : nullptr;
+  }
+  /** Records the current number of actions and LMM elements of the model, to get their peak values */
+  static void sample(resource::Model* model);
+
+private:
+  static bool enabled_;
+  static Scope* current_scope_;
+  std::array<ProfiledPhase, PHASE_COUNT> phases_;
+  ProfiledPhase run_;
+  std::chrono::steady_clock::time_point run_start_;
+  std::map<std::string, ProfiledModel, std::less<>> models_;
+  std::unordered_map<const resource::Model*, ProfiledModel*> models_cache_;
+
+  ProfiledModel& get_model(const resource::Model* model);
+};
+
+} // namespace kernel
+} // namespace simgrid
+
+#endif
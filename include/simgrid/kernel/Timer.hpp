@@ -9,26 +9,36 @@
 
 #include <simgrid/forward.h>
 #include <xbt/functional.hpp>
+#include <xbt/indexed_heap.hpp>
 #include <xbt/utility.hpp>
 
-#include <boost/heap/fibonacci_heap.hpp>
+#include <tuple>
 
 namespace simgrid {
 namespace kernel {
 namespace timer {
 
+/* Heap elements: (date, insertion rank, timer). The insertion rank ensures that timers occurring at the same date are
+ * fired in the order in which they were set. */
+using TimerQelt = std::tuple<double, unsigned long long, Timer*>;
+
+class TimerPosition {
+public:
+  void operator()(const TimerQelt& elem, std::size_t pos) const;
+};
+
 inline auto& kernel_timers() // avoid static initialization order fiasco
 {
-  using TimerQelt = std::pair<double, Timer*>;
-  static boost::heap::fibonacci_heap<TimerQelt, boost::heap::compare<xbt::HeapComparator<TimerQelt>>> value;
+  static xbt::IndexedHeap<TimerQelt, std::less<TimerQelt>, TimerPosition> value;
   return value;
 }
 
 /** @brief Timer datatype */
 class Timer {
+  friend TimerPosition;
   const double date_;
   xbt::Task<void()> callback;
-  std::remove_reference_t<decltype(kernel_timers())>::handle_type handle_;
+  std::size_t heap_position_ = 0;
 
 public:
   double get_date() const { return date_; }
@@ -44,7 +54,7 @@ public:
   }
 
   static Timer* set(double date, xbt::Task<void()>&& callback);
-  static double next() { return kernel_timers().empty() ? -1.0 : kernel_timers().top().first; }
+  static double next() { return kernel_timers().empty() ? -1.0 : std::get<0>(kernel_timers().top()); }
 
   /** Handle any pending timer. Returns if something was actually run. */
   static bool execute_all();
@@ -7,12 +7,13 @@
 #define SIMGRID_KERNEL_RESOURCE_ACTION_HPP
 
 #include <simgrid/forward.h>
+#include <xbt/indexed_heap.hpp>
 #include <xbt/signal.hpp>
 #include <xbt/utility.hpp>
 
-#include <boost/heap/pairing_heap.hpp>
-#include <boost/optional.hpp>
+#include <boost/intrusive/list.hpp>
 #include <string>
+#include <tuple>
 
 static constexpr double NO_MAX_DURATION = -1.0;
 
@@ -20,13 +21,19 @@ namespace simgrid {
 namespace kernel {
 namespace resource {
 
-using heap_element_type = std::pair<double, Action*>;
-using heap_type =
-    boost::heap::pairing_heap<heap_element_type, boost::heap::constant_time_size<false>, boost::heap::stable<true>,
-                              boost::heap::compare<simgrid::xbt::HeapComparator<heap_element_type>>>;
+/* Heap elements: (date, insertion rank, action). The insertion rank ensures that actions ending at the same date are
+ * popped in the order in which they were inserted or updated, to keep the simulations reproducible. */
+using heap_element_type = std::tuple<double, unsigned long long, Action*>;
+
+class XBT_PUBLIC ActionHeapPosition {
+public:
+  void operator()(const heap_element_type& elem, std::size_t pos) const;
+};
+using heap_type = xbt::IndexedHeap<heap_element_type, std::less<heap_element_type>, ActionHeapPosition>;
 
 class XBT_PUBLIC ActionHeap : public heap_type {
   friend Action;
+  unsigned long long rank_ = 0;
 
 public:
   enum class Type {
@@ -57,6 +64,7 @@ public:
  */
 class XBT_PUBLIC Action {
   friend ActionHeap;
+  friend ActionHeapPosition;
 
   int refcount_           = 1;
   double sharing_penalty_ = 1.0;             /**< priority (1.0 by default) */
@@ -78,8 +86,9 @@ class XBT_PUBLIC Action {
   lmm::Variable* variable_ = nullptr;
   double user_bound_       = -1;
 
-  ActionHeap::Type type_                              = ActionHeap::Type::unset;
-  boost::optional<ActionHeap::handle_type> heap_hook_ = boost::none;
+  static constexpr std::size_t NOT_IN_HEAP = static_cast<std::size_t>(-1);
+  ActionHeap::Type type_     = ActionHeap::Type::unset;
+  std::size_t heap_position_ = NOT_IN_HEAP;
   boost::intrusive::list_member_hook<> modified_set_hook_;
   boost::intrusive::list_member_hook<> state_set_hook_;
 
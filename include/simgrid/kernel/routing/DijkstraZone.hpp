@@ -8,6 +8,8 @@
 
 #include <simgrid/kernel/routing/RoutedZone.hpp>
 
+#include <vector>
+
 namespace simgrid {
 namespace kernel {
 namespace routing {
@@ -20,6 +22,10 @@ namespace routing {
  *
  *  This result in rather small platform file, very fast initialization, and very low memory requirements, but somehow
  * long path resolution times.
+ *
+ *  The searches run on a compact copy of the route graph (in Compressed Sparse Row layout), built when the zone gets
+ * sealed. With a cache, the routes from every source can also be computed in parallel at that time
+ * (see network/dijkstra-precompute).
  */
 class XBT_PRIVATE DijkstraZone : public RoutedZone {
   static void route_graph_delete(xbt_graph_t);
@@ -28,11 +34,30 @@ class XBT_PRIVATE DijkstraZone : public RoutedZone {
       xbt_graph_new_graph(1, nullptr), &DijkstraZone::route_graph_delete};
   std::map<int, xbt_node_t> graph_node_map_;
   bool cached_;
-  std::map<int, std::vector<unsigned long>> route_cache_;
+
+  /* CSR copy of the route graph. The nodes are numbered as in the graph, and the out-edges of node i are
+   * edges_[out_begin_[i]] to edges_[out_begin_[i+1] - 1], in the order of the graph */
+  struct Edge {
+    unsigned int src;
+    unsigned int dst;
+    unsigned long cost; // count of links, old model assume 1
+    const Route* route;
+  };
+  std::vector<unsigned int> node_of_netpoint_; // graph node of each netpoint id, or UINT_MAX if it has no edge
+  std::vector<unsigned int> out_begin_;
+  std::vector<Edge> edges_;
+  bool csr_valid_ = false;
+
+  /* For each source node, the edge leading to each node in its shortest path tree (empty when not computed yet) */
+  std::vector<std::vector<unsigned int>> route_cache_;
+  std::vector<unsigned int> pred_scratch_; // used instead of the cache in uncached mode
 
   xbt_node_t route_graph_new_node(int id);
   xbt_node_t node_map_search(int id);
   void new_edge(int src_id, int dst_id, Route* e_route);
+  void build_csr();
+  void compute_pred_edges(unsigned int src_node, std::vector<unsigned int>& pred_edges) const;
+  void precompute_routes(int nthreads);
   void do_seal() override;
 
 public:
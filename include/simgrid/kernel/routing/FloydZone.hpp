@@ -26,8 +26,10 @@ class XBT_PRIVATE FloydZone : public RoutedZone {
   std::vector<std::vector<int>> predecessor_table_;
   std::vector<std::vector<unsigned long>> cost_table_;
   std::vector<std::vector<std::unique_ptr<Route>>> link_table_;
+  std::vector<std::vector<int>> precomputed_predecessors_;
 
   void init_tables(unsigned int table_size);
+  bool use_precomputed_predecessors();
   void do_seal() override;
 
 public:
@@ -38,6 +40,15 @@ public:
   void get_local_route(const NetPoint* src, const NetPoint* dst, Route* into, double* latency) override;
   void add_route(NetPoint* src, NetPoint* dst, NetPoint* gw_src, NetPoint* gw_dst,
                  const std::vector<s4u::LinkInRoute>& link_list, bool symmetrical) override;
+
+  /** @brief Predecessor of each destination on the path from each source, computed when sealing the zone */
+  const std::vector<std::vector<int>>& get_predecessor_table() const { return predecessor_table_; }
+  /** @brief Provides the predecessor table computed by a previous run, so that sealing the zone does not compute it
+   * again. It is ignored if it does not match the routes of the zone. */
+  void set_precomputed_predecessors(std::vector<std::vector<int>>&& table)
+  {
+    precomputed_predecessors_ = std::move(table);
+  }
 };
 } // namespace routing
 } // namespace kernel
@@ -8,8 +8,11 @@
 
 #include <simgrid/kernel/routing/ClusterZone.hpp>
 
+#include <functional>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace simgrid {
 namespace kernel {
@@ -93,6 +96,38 @@ private:
                              bool symmetrical) const;
   std::unordered_map<unsigned int, StarRoute> routes_;
 };
+
+/** @brief StarZone whose hosts are only created when they are first needed
+ *
+ * The hosts are named prefix + radical + suffix. Until one of them is looked up by name (by the deployment, by
+ * s4u::Host::by_name() or when parsing a route), it only exists as a radical in an interval, so that an idle host does
+ * not cost any memory. The materialization callback then creates that host with its links and routes.
+ */
+class LazyStarZone : public StarZone {
+public:
+  using MaterializeCb = std::function<s4u::Host*(int radical)>;
+
+  LazyStarZone(const std::string& name, const std::string& prefix, const std::string& suffix,
+               const std::vector<int>& radicals);
+  LazyStarZone(const LazyStarZone&) = delete;
+  LazyStarZone& operator=(const LazyStarZone&) = delete;
+  ~LazyStarZone() override;
+
+  void set_materialize_cb(const MaterializeCb& cb) { materialize_cb_ = cb; }
+  /** @brief Creates the host of that name if it belongs to this zone and was never created, or returns nullptr */
+  s4u::Host* materialize(const std::string& name);
+  /** @brief Amount of hosts described by this zone, whether they were created or not */
+  unsigned long get_member_count() const;
+
+private:
+  std::string prefix_;
+  std::string suffix_;
+  std::vector<std::pair<int, int>> radical_ranges_; //!< intervals [first, last] of the radicals of the hosts
+  std::unordered_set<int> materialized_;            //!< radicals of the hosts that were already created
+  MaterializeCb materialize_cb_;
+
+  bool has_radical(int radical) const;
+};
 } // namespace routing
 } // namespace kernel
 } // namespace simgrid
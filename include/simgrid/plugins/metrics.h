@@ -0,0 +1,20 @@
+/* Copyright (c) 2021. The SimGrid Team.
+ * All rights reserved.                                                     */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#ifndef SIMGRID_PLUGINS_METRICS_H_
+#define SIMGRID_PLUGINS_METRICS_H_
+
+#include <simgrid/config.h>
+#include <simgrid/forward.h>
+#include <xbt/base.h>
+
+SG_BEGIN_DECL
+
+XBT_PUBLIC void sg_metrics_plugin_init();
+
+SG_END_DECL
+
+#endif
@@ -45,6 +45,12 @@ public:
 
   /** Run the simulation after initialization */
   void run() const;
+  /** Run the simulation until the given date, after processing all events occurring at that date.
+   *
+   * The simulation can then be inspected or modified, and resumed with another call to run_until() or run().
+   * To explore several variants from the same point, fork() the process after run_until() and resume each variant in
+   * its own child process (this does not work with thread contexts). */
+  void run_until(double max_date) const;
 
   /** @brief Retrieve the simulation time (in seconds) */
   static double get_clock();
@@ -105,17 +111,24 @@ protected:
 #endif /*DOXYGEN*/
 
 public:
-  /** Returns the amount of hosts existing in the platform. */
+  /** Returns the amount of hosts existing in the platform.
+   *
+   * With the platform/lazy-clusters option, the hosts of the clusters that were not looked up yet are not created, and
+   * thus not counted.
+   */
   size_t get_host_count() const;
   /** Returns a vector of all hosts found in the platform.
    *
    * The order is generally different from the creation/declaration order in the XML platform because we use a hash
-   * table internally.
+   * table internally. With the platform/lazy-clusters option, only the cluster hosts that were already looked up by
+   * name are returned.
    */
   std::vector<Host*> get_all_hosts() const;
   std::vector<Host*> get_filtered_hosts(const std::function<bool(Host*)>& filter) const;
   Host* host_by_name(const std::string& name) const;
   Host* host_by_name_or_null(const std::string& name) const;
+  Host* host_by_id(unsigned long id) const;
+  Host* host_by_id_or_null(unsigned long id) const;
 
   size_t get_link_count() const;
   std::vector<Link*> get_all_links() const;
@@ -127,6 +140,8 @@ public:
    */
   SplitDuplexLink* split_duplex_link_by_name(const std::string& name) const;
   Link* link_by_name_or_null(const std::string& name) const;
+  Link* link_by_id(unsigned long id) const;
+  Link* link_by_id_or_null(unsigned long id) const;
 
   Mailbox* mailbox_by_name_or_create(const std::string& name) const;
 
@@ -161,6 +176,11 @@ public:
   /** @brief Get list of all models managed by this engine */
   const std::vector<simgrid::kernel::resource::Model*>& get_all_models() const;
 
+  /** @brief Get the wall-clock time spent in each phase of the simulation kernel and in each model
+   *
+   * It is only measured when the debug/profile configuration item is set. */
+  const kernel::Profiler& get_profiler() const;
+
   /** @brief Retrieves all netzones of the type indicated by the template argument */
   template <class T> std::vector<T*> get_filtered_netzones() const
   {
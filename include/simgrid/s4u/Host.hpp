@@ -85,6 +85,10 @@ public:
   xbt::string const& get_name() const;
   /** Retrieves the name of that host as a C string */
   const char* get_cname() const;
+  /** Retrieves the id of that host, usable with Engine::host_by_id() for constant-time lookups.
+   *
+   * The hosts are numbered from 0 in their creation order, and the ids of the destroyed hosts are not reused. */
+  unsigned long get_id() const;
 
   Host* set_cpu(kernel::resource::CpuImpl* cpu);
   kernel::resource::CpuImpl* get_cpu() const { return pimpl_cpu_; }
@@ -54,6 +54,10 @@ public:
   const std::string& get_name() const;
   /** @brief Retrieves the name of that link as a C string */
   const char* get_cname() const;
+  /** @brief Retrieves the id of that link, usable with Engine::link_by_id() for constant-time lookups
+   *
+   * A split-duplex link has its own id, distinct from the ids of its UP and DOWN members. */
+  unsigned long get_id() const;
 
   /** Get/Set the bandwidth of the current Link (in bytes per second) */
   double get_bandwidth() const;
@@ -0,0 +1,140 @@
+/* Copyright (c) 2021. The SimGrid Team.
+ * All rights reserved.                                                     */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#ifndef SIMGRID_XBT_INDEXED_HEAP_HPP
+#define SIMGRID_XBT_INDEXED_HEAP_HPP
+
+#include <xbt/asserts.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace simgrid {
+namespace xbt {
+
+/** @brief Position tracker of IndexedHeap that does not track anything, for plain priority queues */
+class NoHeapPosition {
+public:
+  template <class T> void operator()(const T&, std::size_t) const { /* positions are not tracked */ }
+};
+
+/** @brief A d-ary heap stored in a contiguous array, whose elements can be updated or removed in O(log n)
+ *
+ * The first element (as given by top()) is the one that comes before all others according to @p Compare.
+ *
+ * Each time an element is moved within the heap, its new position is given to the @p Position functor, that is
+ * expected to save it somewhere (e.g., in the object referenced by the element). This position can then be used to
+ * update() or erase() that element.
+ */
+template <class T, class Compare = std::less<T>, class Position = NoHeapPosition, unsigned Arity = 4>
+class IndexedHeap {
+  static_assert(Arity >= 2, "Heaps need at least 2 children per node");
+
+  std::vector<T> data_;
+  Compare compare_;
+  Position position_;
+
+  void place(std::size_t pos, T&& elem)
+  {
+    data_[pos] = std::move(elem);
+    position_(data_[pos], pos);
+  }
+
+  void sift_up(std::size_t pos)
+  {
+    T elem = std::move(data_[pos]);
+    while (pos > 0) {
+      std::size_t parent = (pos - 1) / Arity;
+      if (not compare_(elem, data_[parent]))
+        break;
+      place(pos, std::move(data_[parent]));
+      pos = parent;
+    }
+    place(pos, std::move(elem));
+  }
+
+  void sift_down(std::size_t pos)
+  {
+    T elem             = std::move(data_[pos]);
+    std::size_t length = data_.size();
+    while (true) {
+      std::size_t first = pos * Arity + 1;
+      if (first >= length)
+        break;
+      std::size_t last = std::min(first + Arity, length);
+      std::size_t best = first;
+      for (std::size_t child = first + 1; child < last; child++)
+        if (compare_(data_[child], data_[best]))
+          best = child;
+      if (not compare_(data_[best], elem))
+        break;
+      place(pos, std::move(data_[best]));
+      pos = best;
+    }
+    place(pos, std::move(elem));
+  }
+
+  /* Restore the heap property around pos, after the element stored there changed */
+  void sift(std::size_t pos)
+  {
+    if (pos > 0 && compare_(data_[pos], data_[(pos - 1) / Arity]))
+      sift_up(pos);
+    else
+      sift_down(pos);
+  }
+
+public:
+  explicit IndexedHeap(const Compare& compare = Compare(), const Position& position = Position())
+      : compare_(compare), position_(position)
+  {
+  }
+
+  bool empty() const { return data_.empty(); }
+  std::size_t size() const { return data_.size(); }
+  const T& top() const { return data_.front(); }
+  /** @brief Access the element at the given position, as reported to the Position functor */
+  const T& at(std::size_t pos) const { return data_[pos]; }
+
+  void push(T elem)
+  {
+    data_.emplace_back(std::move(elem));
+    sift_up(data_.size() - 1);
+  }
+  template <class... Args> void emplace(Args&&... args) { push(T(std::forward<Args>(args)...)); }
+
+  void pop() { erase(0); }
+
+  /** @brief Replaces the element at the given position, and moves it to its new place in the heap */
+  void update(std::size_t pos, T elem)
+  {
+    xbt_assert(pos < data_.size(), "Invalid heap position: %zu (heap size: %zu)", pos, data_.size());
+    data_[pos] = std::move(elem);
+    sift(pos);
+  }
+
+  /** @brief Removes the element at the given position */
+  void erase(std::size_t pos)
+  {
+    xbt_assert(pos < data_.size(), "Invalid heap position: %zu (heap size: %zu)", pos, data_.size());
+    if (pos + 1 < data_.size()) {
+      data_[pos] = std::move(data_.back());
+      data_.pop_back();
+      sift(pos);
+    } else {
+      data_.pop_back();
+    }
+  }
+
+  void clear() { data_.clear(); }
+};
+
+} // namespace xbt
+} // namespace simgrid
+
+#endif
@@ -182,6 +182,8 @@ PYBIND11_MODULE(simgrid, m)
       .def("load_platform", &Engine::load_platform, "Load a platform file describing the environment")
       .def("load_deployment", &Engine::load_deployment, "Load a deployment file and launch the actors that it contains")
       .def("run", &Engine::run, py::call_guard<GilScopedRelease>(), "Run the simulation")
+      .def("run_until", &Engine::run_until, py::call_guard<GilScopedRelease>(),
+           "Run the simulation until the given date")
       .def(
           "register_actor",
           [](Engine* e, const std::string& name, py::object fun_or_class) {
@@ -0,0 +1,532 @@
+/* Copyright (c) 2021. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Binary format of the Paje traces (tracing/paje/encoding:Binary).
+ *
+ * The file starts with the "SGBTRACE" magic, the version of the format, the tracing/precision of the trace and the
+ * header of the Paje trace (as a string). Then come the records, which are the lines of the Paje trace: the event type
+ * (one byte, whose 3 upper bits are the flags of the record) followed by the fields of the line.
+ *
+ *  - Integers are written as unsigned LEB128 varints, and the signed ones are zigzag-encoded first.
+ *  - Timestamps are converted into ticks of 10^-precision seconds, that are delta-encoded against the previous
+ *    timestamp. The other doubles are converted into ticks without delta. The lowest bit of the varint tells whether
+ *    the value is given in ticks (0) or as the 8 bytes of the raw double that follow (1), which is only used when the
+ *    conversion may not give the same digits as printing the double.
+ *  - Strings are a varint: 0 is followed by a literal string (length and bytes), and n > 0 refers to the (n-1)-th
+ *    string of the string table. When n-1 is the size of the table, the string that follows is appended to it. Only
+ *    the strings that repeat (link values, sizes and filenames) go through the table.
+ *  - The keys of the links are used twice (by the StartLink and the EndLink), and go through a table of slots. The
+ *    first time, the varint slot is followed by the key (length and bytes), and the second time it is given alone,
+ *    which frees the slot for a later key. The slot is free when the key is given, and used when it is referenced.
+ *  - The flags of the state events tell whether the state value, the size and the call location are given.
+ *  - The root container is implicit in the Paje trace. Its id and name are given by an extra record (of type 31)
+ *    before the creation of its first child, so that they can be written in the CSV files.
+ */
+
+#include "src/instr/instr_binary_trace.hpp"
+#include "simgrid/Exception.hpp"
+#include "xbt/string.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+namespace simgrid {
+namespace instr {
+
+static const char BINARY_TRACE_MAGIC[8]   = {'S', 'G', 'B', 'T', 'R', 'A', 'C', 'E'};
+constexpr unsigned BINARY_TRACE_VERSION   = 2;
+constexpr int BINARY_TRACE_MAX_PRECISION  = 15; // beyond that, 10^precision ticks do not fit in a double mantissa
+
+constexpr int EVENT_FLAGS_SHIFT           = 5;
+constexpr unsigned char EVENT_TYPE_MASK   = (1 << EVENT_FLAGS_SHIFT) - 1;
+constexpr unsigned char STATE_HAS_VALUE    = 1;
+constexpr unsigned char STATE_HAS_SIZE     = 2;
+constexpr unsigned char STATE_HAS_LOCATION = 4;
+constexpr unsigned char ROOT_CONTAINER     = EVENT_TYPE_MASK; // not a Paje event type
+
+static unsigned long long zigzag(long long value)
+{
+  return (static_cast<unsigned long long>(value) << 1) ^ static_cast<unsigned long long>(value >> 63);
+}
+
+static long long unzigzag(unsigned long long value)
+{
+  return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+}
+
+BinaryTraceWriter::BinaryTraceWriter(std::ostream& os, int precision, const std::string& paje_header)
+    : os_(os), precision_(precision), scale_(std::pow(10.0, precision))
+{
+  os_.write(BINARY_TRACE_MAGIC, sizeof BINARY_TRACE_MAGIC);
+  put_varint(BINARY_TRACE_VERSION);
+  put_varint(precision_);
+  put_literal(paje_header);
+  end();
+}
+
+void BinaryTraceWriter::put_varint(unsigned long long value)
+{
+  while (value >= 0x80) {
+    put_byte(static_cast<unsigned char>(value | 0x80));
+    value >>= 7;
+  }
+  put_byte(static_cast<unsigned char>(value));
+}
+
+void BinaryTraceWriter::put_signed(long long value)
+{
+  put_varint(zigzag(value));
+}
+
+void BinaryTraceWriter::put_raw_double(double value)
+{
+  unsigned long long bits;
+  memcpy(&bits, &value, sizeof bits);
+  for (int i = 0; i < 8; i++)
+    put_byte(static_cast<unsigned char>(bits >> (8 * i)));
+}
+
+/* Converts the value into ticks of 10^-precision, if the ticks give the same digits as printing the value with that
+ * precision. This is not the case when the rounding of value * 10^precision may differ from the exact rounding done
+ * when printing, i.e., when the product is too large or too close to a half tick. */
+bool BinaryTraceWriter::to_ticks(double value, long long& ticks) const
+{
+  if (precision_ > BINARY_TRACE_MAX_PRECISION)
+    return false;
+  double scaled = std::abs(value) * scale_;
+  if (not(scaled < 0x1p50))
+    return false;
+  double fraction = scaled - std::floor(scaled);
+  if (std::abs(fraction - 0.5) <= (scaled + 1) * 0x1p-50)
+    return false;
+  ticks = std::llround(scaled);
+  if (std::signbit(value)) {
+    if (ticks == 0) // printed as -0.000...
+      return false;
+    ticks = -ticks;
+  }
+  return true;
+}
+
+void BinaryTraceWriter::put_timestamp(double timestamp)
+{
+  long long ticks;
+  if (to_ticks(timestamp, ticks)) {
+    put_varint(zigzag(ticks - last_ticks_) << 1);
+    last_ticks_ = ticks;
+  } else {
+    put_varint(1);
+    put_raw_double(timestamp);
+  }
+}
+
+void BinaryTraceWriter::put_value(double value)
+{
+  long long ticks;
+  if (to_ticks(value, ticks)) {
+    put_varint(zigzag(ticks) << 1);
+  } else {
+    put_varint(1);
+    put_raw_double(value);
+  }
+}
+
+void BinaryTraceWriter::put_bytes(const std::string& str)
+{
+  put_varint(str.size());
+  record_.append(str);
+}
+
+void BinaryTraceWriter::put_literal(const std::string& str)
+{
+  put_varint(0);
+  put_bytes(str);
+}
+
+void BinaryTraceWriter::put_interned(const std::string& str)
+{
+  auto it = strings_.find(str);
+  if (it != strings_.end()) {
+    put_varint(it->second + 1);
+  } else {
+    unsigned long long index = strings_.size();
+    strings_.emplace(str, index);
+    put_varint(index + 1);
+    put_bytes(str);
+  }
+}
+
+void BinaryTraceWriter::put_key(const std::string& key)
+{
+  auto it = keys_.find(key);
+  if (it != keys_.end()) {
+    put_varint(it->second);
+    free_key_slots_.push_back(it->second);
+    keys_.erase(it);
+  } else {
+    unsigned long long slot = keys_.size() + free_key_slots_.size();
+    if (not free_key_slots_.empty()) {
+      slot = free_key_slots_.back();
+      free_key_slots_.pop_back();
+    }
+    keys_.emplace(key, slot);
+    put_varint(slot);
+    put_bytes(key);
+  }
+}
+
+void BinaryTraceWriter::begin(PajeEventType event_type, unsigned char flags)
+{
+  put_byte(static_cast<unsigned char>(static_cast<unsigned char>(event_type) | flags << EVENT_FLAGS_SHIFT));
+}
+
+void BinaryTraceWriter::end()
+{
+  os_.write(record_.data(), record_.size());
+  record_.clear();
+}
+
+void BinaryTraceWriter::define_type(PajeEventType event_type, long long id, long long parent, const std::string& name,
+                                    const std::string& color)
+{
+  begin(event_type);
+  put_varint(id);
+  put_varint(parent);
+  put_literal(name);
+  put_literal(color);
+  end();
+}
+
+void BinaryTraceWriter::define_link_type(long long id, long long parent, long long source, long long dest,
+                                         const std::string& name)
+{
+  begin(PajeEventType::DefineLinkType);
+  put_varint(id);
+  put_varint(parent);
+  put_varint(source);
+  put_varint(dest);
+  put_literal(name);
+  end();
+}
+
+void BinaryTraceWriter::define_entity_value(long long id, long long parent, const std::string& name,
+                                            const std::string& color)
+{
+  begin(PajeEventType::DefineEntityValue);
+  put_varint(id);
+  put_varint(parent);
+  put_literal(name);
+  put_literal(color);
+  end();
+}
+
+void BinaryTraceWriter::create_container(double timestamp, long long id, long long type, long long parent,
+                                         const std::string& name)
+{
+  begin(PajeEventType::CreateContainer);
+  put_timestamp(timestamp);
+  put_varint(id);
+  put_varint(type);
+  put_varint(parent);
+  put_literal(name);
+  end();
+}
+
+void BinaryTraceWriter::name_root_container(long long id, const std::string& name)
+{
+  if (root_container_named_)
+    return;
+  root_container_named_ = true;
+  put_byte(ROOT_CONTAINER);
+  put_varint(id);
+  put_literal(name);
+  end();
+}
+
+void BinaryTraceWriter::destroy_container(double timestamp, long long type, long long id)
+{
+  begin(PajeEventType::DestroyContainer);
+  put_timestamp(timestamp);
+  put_varint(type);
+  put_varint(id);
+  end();
+}
+
+void BinaryTraceWriter::variable(PajeEventType event_type, double timestamp, long long type, long long container,
+                                 double value)
+{
+  begin(event_type);
+  put_timestamp(timestamp);
+  put_varint(type);
+  put_varint(container);
+  put_value(value);
+  end();
+}
+
+void BinaryTraceWriter::state(PajeEventType event_type, double timestamp, long long type, long long container,
+                              long long value, const std::string* size, const std::string* filename, int linenumber)
+{
+  begin(event_type, (value != -1 ? STATE_HAS_VALUE : 0) | (size != nullptr ? STATE_HAS_SIZE : 0) |
+                        (filename != nullptr ? STATE_HAS_LOCATION : 0));
+  put_timestamp(timestamp);
+  put_varint(type);
+  put_varint(container);
+  if (value != -1)
+    put_varint(value);
+  if (size != nullptr)
+    put_interned(*size);
+  if (filename != nullptr) {
+    put_interned(*filename);
+    put_signed(linenumber);
+  }
+  end();
+}
+
+void BinaryTraceWriter::link(PajeEventType event_type, double timestamp, long long type, long long container,
+                             const std::string& value, long long endpoint, const std::string& key, size_t size)
+{
+  begin(event_type);
+  put_timestamp(timestamp);
+  put_varint(type);
+  put_varint(container);
+  put_interned(value);
+  put_varint(endpoint);
+  put_key(key);
+  put_varint(size == static_cast<size_t>(-1) ? 0 : static_cast<unsigned long long>(size) + 1);
+  end();
+}
+
+void BinaryTraceWriter::new_event(double timestamp, long long type, long long container, long long value)
+{
+  begin(PajeEventType::NewEvent);
+  put_timestamp(timestamp);
+  put_varint(type);
+  put_varint(container);
+  put_varint(value);
+  end();
+}
+
+BinaryTraceReader::BinaryTraceReader(std::istream& is) : is_(is)
+{
+  char magic[sizeof BINARY_TRACE_MAGIC];
+  if (not is_.read(magic, sizeof magic) || memcmp(magic, BINARY_TRACE_MAGIC, sizeof magic) != 0)
+    throw TracingError(XBT_THROW_POINT, "This is not a binary trace of SimGrid");
+  unsigned long long version = get_varint();
+  if (version != BINARY_TRACE_VERSION)
+    throw TracingError(XBT_THROW_POINT, xbt::string_printf("Unsupported version %llu of binary trace", version));
+  precision_   = static_cast<int>(get_varint());
+  paje_header_ = get_string();
+}
+
+unsigned char BinaryTraceReader::get_byte()
+{
+  int byte = is_.get();
+  if (byte == std::istream::traits_type::eof())
+    throw TracingError(XBT_THROW_POINT, "Truncated binary trace");
+  return static_cast<unsigned char>(byte);
+}
+
+unsigned long long BinaryTraceReader::get_varint()
+{
+  unsigned long long value = 0;
+  for (int shift = 0;; shift += 7) {
+    unsigned char byte = get_byte();
+    if (shift > 63)
+      throw TracingError(XBT_THROW_POINT, "Invalid integer in binary trace");
+    value |= static_cast<unsigned long long>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0)
+      return value;
+  }
+}
+
+long long BinaryTraceReader::get_signed()
+{
+  return unzigzag(get_varint());
+}
+
+double BinaryTraceReader::get_raw_double()
+{
+  unsigned long long bits = 0;
+  for (int i = 0; i < 8; i++)
+    bits |= static_cast<unsigned long long>(get_byte()) << (8 * i);
+  double value;
+  memcpy(&value, &bits, sizeof value);
+  return value;
+}
+
+/* Prints the ticks as the Paje writer prints the corresponding value */
+std::string BinaryTraceReader::format_ticks(long long ticks) const
+{
+  std::string digits = std::to_string(ticks < 0 ? -static_cast<unsigned long long>(ticks)
+                                                 : static_cast<unsigned long long>(ticks));
+  if (precision_ == 0)
+    return (ticks < 0 ? "-" : "") + digits;
+  if (digits.size() <= static_cast<size_t>(precision_))
+    digits.insert(0, precision_ + 1 - digits.size(), '0');
+  digits.insert(digits.size() - precision_, 1, '.');
+  return (ticks < 0 ? "-" : "") + digits;
+}
+
+std::string BinaryTraceReader::format_double(double value) const
+{
+  std::ostringstream stream;
+  stream << std::fixed << std::setprecision(precision_) << value;
+  return stream.str();
+}
+
+std::string BinaryTraceReader::get_timestamp()
+{
+  unsigned long long encoded = get_varint();
+  if (encoded & 1)
+    return format_double(get_raw_double());
+  last_ticks_ += unzigzag(encoded >> 1);
+  return format_ticks(last_ticks_);
+}
+
+std::string BinaryTraceReader::get_value()
+{
+  unsigned long long encoded = get_varint();
+  if (encoded & 1)
+    return format_double(get_raw_double());
+  return format_ticks(unzigzag(encoded >> 1));
+}
+
+std::string BinaryTraceReader::get_bytes()
+{
+  std::string str(get_varint(), '\0');
+  if (not is_.read(&str[0], str.size()))
+    throw TracingError(XBT_THROW_POINT, "Truncated binary trace");
+  return str;
+}
+
+std::string BinaryTraceReader::get_string()
+{
+  unsigned long long index = get_varint();
+  if (index > strings_.size() + 1)
+    throw TracingError(XBT_THROW_POINT, "Invalid string reference in binary trace");
+  if (index > 0 && index <= strings_.size())
+    return strings_[index - 1];
+  std::string str = get_bytes();
+  if (index > 0)
+    strings_.push_back(str);
+  return str;
+}
+
+std::string BinaryTraceReader::get_key()
+{
+  unsigned long long slot = get_varint();
+  if (slot > key_slots_.size())
+    throw TracingError(XBT_THROW_POINT, "Invalid key slot in binary trace");
+  if (slot == key_slots_.size()) {
+    key_slots_.emplace_back();
+    key_slot_used_.push_back(false);
+  }
+  if (key_slot_used_[slot]) {
+    key_slot_used_[slot] = false;
+    return std::move(key_slots_[slot]);
+  }
+  key_slots_[slot]     = get_bytes();
+  key_slot_used_[slot] = true;
+  return key_slots_[slot];
+}
+
+bool BinaryTraceReader::next(BinaryTraceRecord& record)
+{
+  int byte = is_.get();
+  if (byte == std::istream::traits_type::eof())
+    return false;
+  if (byte == ROOT_CONTAINER) {
+    root_container_id_   = std::to_string(get_varint());
+    root_container_name_ = get_string();
+    return next(record);
+  }
+  record.event_type      = static_cast<PajeEventType>(byte & EVENT_TYPE_MASK);
+  unsigned char flags    = static_cast<unsigned char>(byte) >> EVENT_FLAGS_SHIFT;
+  record.state_has_value = false;
+  record.fields.clear();
+  auto& fields = record.fields;
+
+  switch (record.event_type) {
+    case PajeEventType::DefineContainerType:
+    case PajeEventType::DefineVariableType:
+    case PajeEventType::DefineStateType:
+    case PajeEventType::DefineEventType:
+    case PajeEventType::DefineEntityValue: {
+      fields.push_back(std::to_string(get_varint()));
+      fields.push_back(std::to_string(get_varint()));
+      fields.push_back(get_string());
+      std::string color = get_string();
+      if (not color.empty())
+        fields.push_back("\"" + color + "\"");
+      break;
+    }
+    case PajeEventType::DefineLinkType:
+      for (int i = 0; i < 4; i++)
+        fields.push_back(std::to_string(get_varint()));
+      fields.push_back(get_string());
+      break;
+    case PajeEventType::CreateContainer:
+      fields.push_back(get_timestamp());
+      for (int i = 0; i < 3; i++)
+        fields.push_back(std::to_string(get_varint()));
+      fields.push_back("\"" + get_string() + "\"");
+      break;
+    case PajeEventType::DestroyContainer:
+      fields.push_back(get_timestamp());
+      fields.push_back(std::to_string(get_varint()));
+      fields.push_back(std::to_string(get_varint()));
+      break;
+    case PajeEventType::SetVariable:
+    case PajeEventType::AddVariable:
+    case PajeEventType::SubVariable:
+      fields.push_back(get_timestamp());
+      fields.push_back(std::to_string(get_varint()));
+      fields.push_back(std::to_string(get_varint()));
+      fields.push_back(get_value());
+      break;
+    case PajeEventType::SetState:
+    case PajeEventType::PushState:
+    case PajeEventType::PopState:
+    case PajeEventType::ResetState: {
+      fields.push_back(get_timestamp());
+      fields.push_back(std::to_string(get_varint()));
+      fields.push_back(std::to_string(get_varint()));
+      record.state_has_value = (flags & STATE_HAS_VALUE) != 0;
+      if (flags & STATE_HAS_VALUE)
+        fields.push_back(std::to_string(get_varint()));
+      if (flags & STATE_HAS_SIZE)
+        fields.push_back(get_string());
+      if (flags & STATE_HAS_LOCATION) {
+        fields.push_back("\"" + get_string() + "\"");
+        fields.push_back(std::to_string(get_signed()));
+      }
+      break;
+    }
+    case PajeEventType::StartLink:
+    case PajeEventType::EndLink: {
+      fields.push_back(get_timestamp());
+      fields.push_back(std::to_string(get_varint()));
+      fields.push_back(std::to_string(get_varint()));
+      fields.push_back(get_string());
+      fields.push_back(std::to_string(get_varint()));
+      fields.push_back(get_key());
+      unsigned long long size = get_varint();
+      if (size > 0)
+        fields.push_back(std::to_string(size - 1));
+      break;
+    }
+    case PajeEventType::NewEvent:
+      fields.push_back(get_timestamp());
+      for (int i = 0; i < 3; i++)
+        fields.push_back(std::to_string(get_varint()));
+      break;
+    default:
+      throw TracingError(XBT_THROW_POINT, xbt::string_printf("Invalid record type %d in binary trace", byte));
+  }
+  return true;
+}
+} // namespace instr
+} // namespace simgrid
@@ -0,0 +1,118 @@
+/* Copyright (c) 2021. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#ifndef INSTR_BINARY_TRACE_HPP
+#define INSTR_BINARY_TRACE_HPP
+
+#include "src/instr/instr_private.hpp"
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace simgrid {
+namespace instr {
+
+/** @brief Writes the records of a Paje trace in the binary format described in instr_binary_trace.cpp
+ *
+ * The ids are the ones of the Paje trace, and the doubles are stored so that they can be printed back exactly as the
+ * Paje writer prints them with the given precision.
+ */
+class BinaryTraceWriter {
+  std::ostream& os_;
+  int precision_;
+  double scale_;
+  long long last_ticks_ = 0;
+  std::unordered_map<std::string, unsigned long long> strings_;
+  std::unordered_map<std::string, unsigned long long> keys_; // link keys that were written once, and their slot
+  std::vector<unsigned long long> free_key_slots_;
+  std::string record_; // the record being encoded, written out at once
+  bool root_container_named_ = false;
+
+  void put_byte(unsigned char byte) { record_.push_back(static_cast<char>(byte)); }
+  void put_varint(unsigned long long value);
+  void put_signed(long long value);
+  void put_raw_double(double value);
+  bool to_ticks(double value, long long& ticks) const;
+  void put_timestamp(double timestamp);
+  void put_value(double value);
+  void put_bytes(const std::string& str);
+  void put_literal(const std::string& str);
+  void put_interned(const std::string& str);
+  void put_key(const std::string& key);
+  void begin(PajeEventType event_type, unsigned char flags = 0);
+  void end();
+
+public:
+  BinaryTraceWriter(std::ostream& os, int precision, const std::string& paje_header);
+
+  void define_type(PajeEventType event_type, long long id, long long parent, const std::string& name,
+                   const std::string& color);
+  void define_link_type(long long id, long long parent, long long source, long long dest, const std::string& name);
+  void define_entity_value(long long id, long long parent, const std::string& name, const std::string& color);
+  void create_container(double timestamp, long long id, long long type, long long parent, const std::string& name);
+  /* Records the root container, that is not created in the Paje trace. Only the first call has an effect. */
+  void name_root_container(long long id, const std::string& name);
+  void destroy_container(double timestamp, long long type, long long id);
+  void variable(PajeEventType event_type, double timestamp, long long type, long long container, double value);
+  /* value is -1 for the states without value. size, filename and linenumber are only written when size/filename are
+   * not nullptr */
+  void state(PajeEventType event_type, double timestamp, long long type, long long container, long long value,
+             const std::string* size, const std::string* filename, int linenumber);
+  /* size is only written if it is not -1 */
+  void link(PajeEventType event_type, double timestamp, long long type, long long container, const std::string& value,
+            long long endpoint, const std::string& key, size_t size);
+  void new_event(double timestamp, long long type, long long container, long long value);
+};
+
+/** @brief A record of a binary trace, given as the fields of the corresponding line of the Paje trace */
+struct BinaryTraceRecord {
+  PajeEventType event_type;
+  std::vector<std::string> fields;
+  bool state_has_value = false; // for the state events, whether the field that follows the container is the value
+};
+
+/** @brief Reads back the records written by a BinaryTraceWriter */
+class BinaryTraceReader {
+  std::istream& is_;
+  int precision_;
+  long long last_ticks_ = 0;
+  std::string paje_header_;
+  std::string root_container_id_;
+  std::string root_container_name_;
+  std::vector<std::string> strings_;
+  std::vector<std::string> key_slots_;
+  std::vector<bool> key_slot_used_;
+
+  unsigned char get_byte();
+  unsigned long long get_varint();
+  long long get_signed();
+  double get_raw_double();
+  std::string format_ticks(long long ticks) const;
+  std::string format_double(double value) const;
+  std::string get_timestamp();
+  std::string get_value();
+  std::string get_bytes();
+  std::string get_string();
+  std::string get_key();
+
+public:
+  explicit BinaryTraceReader(std::istream& is);
+
+  int get_precision() const { return precision_; }
+  /** Header of the Paje trace (comments and event definitions), as written by the Paje writer */
+  const std::string& get_paje_header() const { return paje_header_; }
+  /** Id and name of the root container (empty until the record naming it was read) */
+  const std::string& get_root_container_id() const { return root_container_id_; }
+  const std::string& get_root_container_name() const { return root_container_name_; }
+  /** Reads the next record, and returns false at the end of the trace */
+  bool next(BinaryTraceRecord& record);
+};
+} // namespace instr
+} // namespace simgrid
+
+#endif
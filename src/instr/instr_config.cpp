@@ -7,6 +7,7 @@
 #include "simgrid/Exception.hpp"
 #include "simgrid/s4u/Engine.hpp"
 #include "simgrid/version.h"
+#include "src/instr/instr_binary_trace.hpp"
 #include "src/instr/instr_private.hpp"
 #include "surf/surf.hpp"
 
@@ -24,13 +25,17 @@ XBT_LOG_NEW_DEFAULT_SUBCATEGORY (instr_config, instr, "Configuration");
 
 std::ofstream tracing_file;
 std::map<const simgrid::instr::Container*, std::ofstream*> tracing_files; // TI specific
+std::map<const simgrid::instr::Container*, simgrid::instr::TILoopFolder> ti_loop_folders; // TI specific
 
 constexpr char OPT_TRACING_BASIC[]             = "tracing/basic";
 constexpr char OPT_TRACING_COMMENT_FILE[]      = "tracing/comment-file";
 constexpr char OPT_TRACING_DISABLE_DESTROY[]   = "tracing/disable-destroy";
+constexpr char OPT_TRACING_PAJE_ENCODING[]     = "tracing/paje/encoding";
 constexpr char OPT_TRACING_FORMAT_TI_ONEFILE[] = "tracing/smpi/format/ti-one-file";
+constexpr char OPT_TRACING_FORMAT_TI_LOOPS[]   = "tracing/smpi/format/ti-loops";
 constexpr char OPT_TRACING_SMPI[]              = "tracing/smpi";
 constexpr char OPT_TRACING_TOPOLOGY[]          = "tracing/platform/topology";
+constexpr char OPT_TRACING_UTILIZATION_BIN[]   = "tracing/utilization-bin";
 
 static simgrid::config::Flag<bool> trace_enabled{
     "tracing", "Enable the tracing system. You have to enable this option to use other tracing options.", false};
@@ -72,6 +77,12 @@ static simgrid::config::Flag<bool> trace_uncategorized{
     "To use if the simulator does not use tracing categories but resource utilization have to be traced.",
     false};
 
+static simgrid::config::Flag<double> trace_utilization_bin{
+    OPT_TRACING_UTILIZATION_BIN,
+    "Width (in simulated seconds) of the time bins in which the resource utilization is averaged, or 0 to trace each "
+    "change of utilization.",
+    0.0, [](const double& val) { xbt_assert(val >= 0, "%s must be non-negative", OPT_TRACING_UTILIZATION_BIN); }};
+
 static simgrid::config::Flag<bool> trace_disable_destroy{OPT_TRACING_DISABLE_DESTROY,
                                                          "Disable platform containers destruction.", false};
 static simgrid::config::Flag<bool> trace_basic{OPT_TRACING_BASIC, "Avoid extended events (impoverished trace file).",
@@ -93,6 +104,11 @@ bool TRACE_needs_platform ()
          TRACE_platform() || (TRACE_smpi_is_enabled() && TRACE_smpi_is_grouped());
 }
 
+double TRACE_utilization_bin()
+{
+  return trace_utilization_bin;
+}
+
 bool TRACE_is_enabled()
 {
   return trace_enabled;
@@ -196,10 +212,23 @@ void TRACE_help()
              "  Use this option if you are using one of these tools to visualize the simulation\n"
              "  trace. Keep in mind that the trace might be incomplete, without all the\n"
              "  information that would be registered otherwise.");
+  print_line(OPT_TRACING_PAJE_ENCODING, "Encoding of the paje traces (Text or Binary)",
+             "  The Binary encoding is a compact encoding of the Paje trace, that is much smaller\n"
+             "  and quicker to write. It can be converted back into Paje or CSV with the\n"
+             "  trace-converter tool.");
   print_line(OPT_TRACING_FORMAT_TI_ONEFILE, "Only works for SMPI now, and TI output format",
              "  By default, each process outputs to a separate file, inside a filename_files folder\n"
              "  By setting this option to yes, all processes will output to only one file\n"
              "  This is meant to avoid opening thousands of files with large simulations");
+  print_line(OPT_TRACING_FORMAT_TI_LOOPS, "Only works for SMPI now, and TI output format",
+             "  By setting this option to yes, the sequences of actions that repeat (such as\n"
+             "  the iterations of a solver) are written once, as loops with an iteration count.\n"
+             "  This is meant to get much smaller traces for iterative applications");
+  print_line(OPT_TRACING_UTILIZATION_BIN, "Average the resource utilization in time bins",
+             "  Instead of a pair of events each time an activity changes the utilization of a\n"
+             "  host or link, the utilization is averaged in bins of this width (in simulated\n"
+             "  seconds) and each resource gets one value per bin. The trace size then depends\n"
+             "  on the simulated time rather than on the number of activities.");
   print_line(OPT_TRACING_TOPOLOGY, "Register the platform topology as a graph",
              "  This option (enabled by default) can be used to disable the tracing of\n"
              "  the platform topology in the trace file. Sometimes, such task is really\n"
@@ -211,6 +240,7 @@ namespace simgrid {
 namespace instr {
 static bool trace_active = false;
 TraceFormat trace_format = TraceFormat::Paje;
+std::unique_ptr<BinaryTraceWriter> binary_trace_writer;
 int trace_precision;
 
 /*************
@@ -220,11 +250,18 @@ xbt::signal<void(Container const&)> Container::on_creation;
 xbt::signal<void(Container const&)> Container::on_destruction;
 xbt::signal<void(Type const&, PajeEventType)> Type::on_creation;
 xbt::signal<void(LinkType const&, Type const&, Type const&)> LinkType::on_creation;
-xbt::signal<void(PajeEvent&)> PajeEvent::on_creation;
 xbt::signal<void(PajeEvent const&)> PajeEvent::on_destruction;
 xbt::signal<void(StateEvent const&)> StateEvent::on_destruction;
 xbt::signal<void(EntityValue const&)> EntityValue::on_creation;
 
+static std::string get_paje_container_name(const Container& c)
+{
+  if (c.get_name().find("rank-") != 0)
+    return c.get_name();
+  /* Subtract -1 because this is the process id and we transform it to the rank id */
+  return "rank-" + std::to_string(stoi(c.get_name().substr(5)) - 1);
+}
+
 static void on_container_creation_paje(const Container& c)
 {
   double timestamp = simgrid_get_clock();
@@ -235,14 +272,10 @@ static void on_container_creation_paje(const Container& c)
 
   stream << std::fixed << std::setprecision(trace_precision) << PajeEventType::CreateContainer << " ";
   stream << timestamp << " " << c.get_id() << " " << c.type_->get_id() << " " << c.parent_->get_id() << " \"";
-  if (c.get_name().find("rank-") != 0)
-    stream << c.get_name() << "\"";
-  else
-    /* Subtract -1 because this is the process id and we transform it to the rank id */
-    stream << "rank-" << stoi(c.get_name().substr(5)) - 1 << "\"";
+  stream << get_paje_container_name(c) << "\"";
 
   XBT_DEBUG("Dump %s", stream.str().c_str());
-  tracing_file << stream.str() << std::endl;
+  tracing_file << stream.str() << '\n';
 }
 
 static void on_container_destruction_paje(const Container& c)
@@ -258,10 +291,24 @@ static void on_container_destruction_paje(const Container& c)
     stream << std::fixed << std::setprecision(trace_precision) << PajeEventType::DestroyContainer << " ";
     stream << timestamp << " " << c.type_->get_id() << " " << c.get_id();
     XBT_DEBUG("Dump %s", stream.str().c_str());
-    tracing_file << stream.str() << std::endl;
+    tracing_file << stream.str() << '\n';
   }
 }
 
+static void on_container_creation_binary(const Container& c)
+{
+  binary_trace_writer->name_root_container(Container::get_root()->get_id(), Container::get_root()->get_name());
+  binary_trace_writer->create_container(simgrid_get_clock(), c.get_id(), c.type_->get_id(), c.parent_->get_id(),
+                                        get_paje_container_name(c));
+}
+
+static void on_container_destruction_binary(const Container& c)
+{
+  // trace my destruction, but not if user requests so or if the container is root
+  if (not trace_disable_destroy && &c != Container::get_root())
+    binary_trace_writer->destroy_container(simgrid_get_clock(), c.type_->get_id(), c.get_id());
+}
+
 static void on_container_creation_ti(const Container& c)
 {
   XBT_DEBUG("%s: event_type=%u, timestamp=%f", __func__, static_cast<unsigned>(PajeEventType::CreateContainer),
@@ -285,13 +332,20 @@ static void on_container_creation_ti(const Container& c)
 #endif
     ti_unique_file = new std::ofstream(filename.c_str(), std::ofstream::out);
     xbt_assert(not ti_unique_file->fail(), "Tracefile %s could not be opened for writing", filename.c_str());
-    tracing_file << filename << std::endl;
+    tracing_file << filename << '\n';
   }
   tracing_files.insert({&c, ti_unique_file});
+  if (simgrid::config::get_value<bool>(OPT_TRACING_FORMAT_TI_LOOPS))
+    ti_loop_folders.emplace(&c, simgrid::instr::TILoopFolder(ti_unique_file));
 }
 
 static void on_container_destruction_ti(const Container& c)
 {
+  auto folder = ti_loop_folders.find(&c);
+  if (folder != ti_loop_folders.end()) {
+    folder->second.flush();
+    ti_loop_folders.erase(folder);
+  }
   if (not trace_disable_destroy && &c != Container::get_root()) {
     if (not simgrid::config::get_value<bool>("tracing/smpi/format/ti-one-file") || tracing_files.size() == 1) {
       tracing_files.at(&c)->close();
@@ -310,28 +364,24 @@ static void on_entity_value_creation(const EntityValue& value)
   if (not value.get_color().empty())
     stream << " \"" << value.get_color() << "\"";
   XBT_DEBUG("Dump %s", stream.str().c_str());
-  tracing_file << stream.str() << std::endl;
-}
-
-static void on_event_creation(PajeEvent& event)
-{
-  XBT_DEBUG("%s: event_type=%u, timestamp=%.*f", __func__, static_cast<unsigned>(event.eventType_), trace_precision,
-            event.timestamp_);
-  event.stream_ << std::fixed << std::setprecision(trace_precision);
-  event.stream_ << event.eventType_ << " " << event.timestamp_ << " ";
-  event.stream_ << event.get_type()->get_id() << " " << event.get_container()->get_id();
+  tracing_file << stream.str() << '\n';
 }
 
 static void on_event_destruction(const PajeEvent& event)
 {
   XBT_DEBUG("Dump %s", event.stream_.str().c_str());
-  tracing_file << event.stream_.str() << std::endl;
+  tracing_file << event.stream_.rdbuf() << '\n';
 }
 
 static void on_state_event_destruction(const StateEvent& event)
 {
-  if (event.has_extra())
-    *tracing_files.at(event.get_container()) << event.stream_.str() << std::endl;
+  if (not event.has_extra())
+    return;
+  auto folder = ti_loop_folders.find(event.get_container());
+  if (folder != ti_loop_folders.end())
+    folder->second.add(event.stream_.str());
+  else
+    *tracing_files.at(event.get_container()) << event.stream_.str() << '\n';
 }
 
 static void on_type_creation(const Type& type, PajeEventType event_type)
@@ -346,7 +396,7 @@ static void on_type_creation(const Type& type, PajeEventType event_type)
   if (type.is_colored())
     stream << " \"" << type.get_color() << "\"";
   XBT_DEBUG("Dump %s", stream.str().c_str());
-  tracing_file << stream.str() << std::endl;
+  tracing_file << stream.str() << '\n';
 }
 
 static void on_link_type_creation(const Type& type, const Type& source, const Type& dest)
@@ -357,7 +407,27 @@ static void on_link_type_creation(const Type& type, const Type& source, const Ty
   stream << PajeEventType::DefineLinkType << " " << type.get_id() << " " << type.get_parent()->get_id();
   stream << " " << source.get_id() << " " << dest.get_id() << " " << type.get_name();
   XBT_DEBUG("Dump %s", stream.str().c_str());
-  tracing_file << stream.str() << std::endl;
+  tracing_file << stream.str() << '\n';
+}
+
+static void on_entity_value_creation_binary(const EntityValue& value)
+{
+  binary_trace_writer->define_entity_value(value.get_id(), value.get_parent()->get_id(), value.get_name(),
+                                           value.get_color());
+}
+
+static void on_type_creation_binary(const Type& type, PajeEventType event_type)
+{
+  if (event_type == PajeEventType::DefineLinkType)
+    return; // this kind of type has to be handled differently
+  binary_trace_writer->define_type(event_type, type.get_id(), type.get_parent()->get_id(), type.get_name(),
+                                   type.get_color());
+}
+
+static void on_link_type_creation_binary(const Type& type, const Type& source, const Type& dest)
+{
+  binary_trace_writer->define_link_type(type.get_id(), type.get_parent()->get_id(), source.get_id(), dest.get_id(),
+                                        type.get_name());
 }
 
 static void on_simulation_start()
@@ -368,15 +438,24 @@ static void on_simulation_start()
   define_callbacks();
 
   XBT_DEBUG("Tracing starts");
-  trace_precision = config::get_value<int>("tracing/precision");
+  trace_precision                = config::get_value<int>("tracing/precision");
+  utilization_bins_flushed_until = 0;
 
   /* init the tracing module to generate the right output */
-  std::string format = config::get_value<std::string>("tracing/smpi/format");
-  XBT_DEBUG("Tracing format %s", format.c_str());
-
-  /* open the trace file(s) */
+  std::string format   = config::get_value<std::string>("tracing/smpi/format");
+  std::string encoding = config::get_value<std::string>(OPT_TRACING_PAJE_ENCODING);
+  XBT_DEBUG("Tracing format %s (encoding %s)", format.c_str(), encoding.c_str());
+  xbt_assert(encoding == "Text" || encoding == "Binary",
+             "Unknown encoding '%s' for the paje traces. Valid encodings are 'Text' and 'Binary'.", encoding.c_str());
+  xbt_assert(format == "Paje" || encoding == "Text",
+             "The %s:%s option only applies to the paje traces, it cannot be used with tracing/smpi/format:%s.",
+             OPT_TRACING_PAJE_ENCODING, encoding.c_str(), format.c_str());
+
+  /* open the trace file(s), with a large buffer as it is written one line at a time */
+  static std::vector<char> tracing_file_buffer(1 << 20);
+  tracing_file.rdbuf()->pubsetbuf(tracing_file_buffer.data(), tracing_file_buffer.size());
   std::string filename = simgrid::config::get_value<std::string>("tracing/filename");
-  tracing_file.open(filename.c_str(), std::ofstream::out);
+  tracing_file.open(filename.c_str(), std::ofstream::out | std::ofstream::binary);
   if (tracing_file.fail()) {
     throw TracingError(XBT_THROW_POINT,
                        xbt::string_printf("Tracefile %s could not be opened for writing.", filename.c_str()));
@@ -385,24 +464,36 @@ static void on_simulation_start()
   XBT_DEBUG("Filename %s is open for writing", filename.c_str());
 
   if (format == "Paje") {
-    Container::on_creation.connect(on_container_creation_paje);
-    Container::on_destruction.connect(on_container_destruction_paje);
-    EntityValue::on_creation.connect(on_entity_value_creation);
-    Type::on_creation.connect(on_type_creation);
-    LinkType::on_creation.connect(on_link_type_creation);
-    PajeEvent::on_creation.connect(on_event_creation);
-    PajeEvent::on_destruction.connect(on_event_destruction);
-
-    paje::dump_generator_version();
+    /* the header is written as is in paje traces, and saved in the binary ones */
+    std::stringstream header;
+    paje::dump_generator_version(header);
 
     /* output one line comment */
     std::string comment = simgrid::config::get_value<std::string>("tracing/comment");
     if (not comment.empty())
-      tracing_file << "# " << comment << std::endl;
+      header << "# " << comment << '\n';
 
     /* output comment file */
-    paje::dump_comment_file(config::get_value<std::string>(OPT_TRACING_COMMENT_FILE));
-    paje::dump_header(trace_basic, TRACE_display_sizes());
+    paje::dump_comment_file(header, config::get_value<std::string>(OPT_TRACING_COMMENT_FILE));
+    paje::dump_header(header, trace_basic, TRACE_display_sizes());
+
+    if (encoding == "Binary") {
+      trace_format        = TraceFormat::Binary;
+      binary_trace_writer = std::make_unique<BinaryTraceWriter>(tracing_file, trace_precision, header.str());
+      Container::on_creation.connect(on_container_creation_binary);
+      Container::on_destruction.connect(on_container_destruction_binary);
+      EntityValue::on_creation.connect(on_entity_value_creation_binary);
+      Type::on_creation.connect(on_type_creation_binary);
+      LinkType::on_creation.connect(on_link_type_creation_binary);
+    } else {
+      Container::on_creation.connect(on_container_creation_paje);
+      Container::on_destruction.connect(on_container_destruction_paje);
+      EntityValue::on_creation.connect(on_entity_value_creation);
+      Type::on_creation.connect(on_type_creation);
+      LinkType::on_creation.connect(on_link_type_creation);
+      PajeEvent::on_destruction.connect(on_event_destruction);
+      tracing_file << header.rdbuf();
+    }
   } else {
     trace_format = TraceFormat::Ti;
     Container::on_creation.connect(on_container_creation_ti);
@@ -420,6 +511,7 @@ static void on_simulation_end()
     return;
 
   /* dump trace buffer */
+  flush_utilization_bins();
   last_timestamp_to_dump = surf_get_clock();
   dump_buffer(true);
 
@@ -429,6 +521,7 @@ static void on_simulation_end()
   delete root_type;
 
   /* close the trace files */
+  binary_trace_writer.reset();
   tracing_file.close();
   XBT_DEBUG("Filename %s is closed", config::get_value<std::string>("tracing/filename").c_str());
 
@@ -454,8 +547,16 @@ void init()
                                     "The 'TI' (Time-Independent) format allows for trace replay.",
                                     "Paje");
 
+  config::declare_flag<std::string>(OPT_TRACING_PAJE_ENCODING,
+                                    "Select the encoding of paje traces. The default is the 'Text' encoding. "
+                                    "The 'Binary' encoding is more compact, and can be converted back with "
+                                    "trace-converter.",
+                                    "Text");
   config::declare_flag<bool>(OPT_TRACING_FORMAT_TI_ONEFILE,
                              "(smpi only) For replay format only : output to one file only", false);
+  config::declare_flag<bool>(OPT_TRACING_FORMAT_TI_LOOPS,
+                             "(smpi only) For replay format only : fold the repeated sequences of actions into loops",
+                             false);
   config::declare_flag<std::string>("tracing/comment", "Add a comment line to the top of the trace file.", "");
   config::declare_flag<std::string>(OPT_TRACING_COMMENT_FILE,
                                     "Add the contents of a file as comments to the top of the trace.", "");
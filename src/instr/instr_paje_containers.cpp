@@ -6,6 +6,7 @@
 #include "simgrid/Exception.hpp"
 #include "simgrid/s4u/Engine.hpp"
 #include "simgrid/s4u/Host.hpp"
+#include "simgrid/s4u/Link.hpp"
 #include "src/instr/instr_private.hpp"
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY (instr_paje_containers, instr, "Paje tracing event system (containers)");
@@ -16,6 +17,10 @@ namespace instr {
 Container* Container::root_container_ = nullptr;              /* the root container */
 std::map<std::string, Container*, std::less<>> Container::all_containers_; /* all created containers indexed by name */
 
+xbt::Extension<s4u::Host, HostContainerExt> HostContainerExt::EXTENSION_ID;
+xbt::Extension<s4u::Link, LinkContainerExt> LinkContainerExt::EXTENSION_ID;
+xbt::Extension<s4u::Actor, ActorContainerExt> ActorContainerExt::EXTENSION_ID;
+
 NetZoneContainer::NetZoneContainer(const std::string& name, unsigned int level, NetZoneContainer* parent)
     : Container::Container(name, "", parent)
 {
@@ -87,9 +92,9 @@ Container::~Container()
   on_destruction(*this);
 }
 
-void Container::create_child(const std::string& name, const std::string& type_name)
+Container* Container::create_child(const std::string& name, const std::string& type_name)
 {
-  new Container(name, type_name, this);
+  return new Container(name, type_name, this);
 }
 
 Container* Container::by_name_or_null(const std::string& name)
@@ -130,6 +135,35 @@ VariableType* Container::get_variable(const std::string& name)
   return static_cast<VariableType*>(type_->by_name(name)->set_calling_container(this));
 }
 
+StateType* Container::get_state(StateType* state)
+{
+  xbt_assert(state->get_parent() == type_, "type %s is not a type of container %s", state->get_cname(), get_cname());
+  return static_cast<StateType*>(state->set_calling_container(this));
+}
+
+LinkType* Container::get_link(LinkType* link)
+{
+  xbt_assert(link->get_parent() == type_, "type %s is not a type of container %s", link->get_cname(), get_cname());
+  return static_cast<LinkType*>(link->set_calling_container(this));
+}
+
+VariableType* Container::get_variable(VariableType* variable)
+{
+  xbt_assert(variable->get_parent() == type_, "type %s is not a type of container %s", variable->get_cname(),
+             get_cname());
+  return static_cast<VariableType*>(variable->set_calling_container(this));
+}
+
+ActorContainerExt* ActorContainerExt::get(s4u::Actor& actor)
+{
+  auto* ext = actor.extension<ActorContainerExt>();
+  if (ext == nullptr) {
+    ext = new ActorContainerExt();
+    actor.extension_set(ext);
+  }
+  return ext;
+}
+
 EntityValue::EntityValue(const std::string& name, const std::string& color, Type* parent)
     : name_(name), color_(color), parent_(parent)
 {
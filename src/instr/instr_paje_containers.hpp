@@ -7,6 +7,7 @@
 #define INSTR_PAJE_CONTAINERS_HPP
 
 #include "src/instr/instr_private.hpp"
+#include <memory>
 #include <string>
 
 namespace simgrid {
@@ -15,6 +16,7 @@ class Type;
 class LinkType;
 class StateType;
 class VariableType;
+class UtilizationBins;
 
 class Container {
   static Container* root_container_;
@@ -49,7 +51,11 @@ public:
   StateType* get_state(const std::string& name);
   LinkType* get_link(const std::string& name);
   VariableType* get_variable(const std::string& name);
-  void create_child(const std::string& name, const std::string& type_name);
+  /* Same as above, with a type of this container that was already found */
+  StateType* get_state(StateType* state);
+  LinkType* get_link(LinkType* link);
+  VariableType* get_variable(VariableType* variable);
+  Container* create_child(const std::string& name, const std::string& type_name);
   static Container* get_root() { return root_container_; }
 };
 
@@ -67,6 +73,41 @@ class HostContainer : public Container {
 public:
   HostContainer(s4u::Host const& host, NetZoneContainer* parent);
 };
+
+/* The following extensions keep the container of a host, link or actor together with the types that are traced at each
+ * of its events. They are set when the container is created, so that the tracing callbacks do not search for them by
+ * name at each event. */
+class HostContainerExt {
+public:
+  static xbt::Extension<s4u::Host, HostContainerExt> EXTENSION_ID;
+  explicit HostContainerExt(Container* c) : container(c) {}
+  Container* container;
+  VariableType* speed      = nullptr;
+  VariableType* speed_used = nullptr;
+  std::unique_ptr<UtilizationBins> speed_used_bins; // With tracing/utilization-bin
+  StateType* vm_state = nullptr;                    // Only for the VMs
+};
+
+class LinkContainerExt {
+public:
+  static xbt::Extension<s4u::Link, LinkContainerExt> EXTENSION_ID;
+  explicit LinkContainerExt(Container* c) : container(c) {}
+  Container* container;
+  VariableType* bandwidth      = nullptr;
+  VariableType* bandwidth_used = nullptr;
+  std::unique_ptr<UtilizationBins> bandwidth_used_bins; // With tracing/utilization-bin
+};
+
+class ActorContainerExt {
+public:
+  static xbt::Extension<s4u::Actor, ActorContainerExt> EXTENSION_ID;
+  Container* container   = nullptr; // Container of the actor, with tracing/actor
+  StateType* actor_state = nullptr;
+  Container* rank        = nullptr; // Container of the MPI rank run by the actor, with tracing/smpi
+  StateType* mpi_state   = nullptr;
+
+  static ActorContainerExt* get(s4u::Actor& actor);
+};
 } // namespace instr
 } // namespace simgrid
 #endif
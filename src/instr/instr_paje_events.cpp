@@ -3,20 +3,24 @@
 /* This program is free software; you can redistribute it and/or modify it
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
+#include "src/instr/instr_binary_trace.hpp"
 #include "src/instr/instr_private.hpp"
 #include "src/instr/instr_smpi.hpp"
 #include "src/smpi/include/private.hpp"
 #include "src/surf/surf_interface.hpp"
 
+#include <iomanip>
+
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(instr_paje_events, instr, "Paje tracing event system (events)");
 
 namespace simgrid {
 namespace instr {
 
+std::stringstream PajeEvent::stream_;
+
 PajeEvent::PajeEvent(Container* container, Type* type, double timestamp, PajeEventType eventType)
     : container_(container), type_(type), timestamp_(timestamp), eventType_(eventType)
 {
-  on_creation(*this);
   insert_into_buffer();
 }
 
@@ -37,11 +41,36 @@ StateEvent::StateEvent(Container* container, Type* type, PajeEventType event_typ
 #endif
 }
 
+/* Formats the event into stream_, from which it is written out by on_destruction */
+void PajeEvent::format()
+{
+  if (trace_format == TraceFormat::Binary) {
+    encode(*binary_trace_writer);
+    return;
+  }
+  stream_.str("");
+  if (trace_format == TraceFormat::Paje) {
+    stream_ << std::fixed << std::setprecision(trace_precision);
+    stream_ << eventType_ << " " << timestamp_ << " " << type_->get_id() << " " << container_->get_id();
+  }
+  print();
+}
+
+void VariableEvent::encode(BinaryTraceWriter& writer) const
+{
+  writer.variable(eventType_, timestamp_, get_type()->get_id(), get_container()->get_id(), value_);
+}
+
 void NewEvent::print()
 {
   stream_ << " " << value->get_id();
 }
 
+void NewEvent::encode(BinaryTraceWriter& writer) const
+{
+  writer.new_event(timestamp_, get_type()->get_id(), get_container()->get_id(), value->get_id());
+}
+
 void LinkEvent::print()
 {
   stream_ << " " << value_ << " " << endpoint_->get_id() << " " << key_;
@@ -50,6 +79,12 @@ void LinkEvent::print()
     stream_ << " " << size_;
 }
 
+void LinkEvent::encode(BinaryTraceWriter& writer) const
+{
+  writer.link(eventType_, timestamp_, get_type()->get_id(), get_container()->get_id(), value_, endpoint_->get_id(), key_,
+              TRACE_display_sizes() ? size_ : static_cast<size_t>(-1));
+}
+
 void StateEvent::print()
 {
   if (trace_format == TraceFormat::Paje) {
@@ -83,5 +118,22 @@ void StateEvent::print()
     THROW_IMPOSSIBLE;
   }
 }
+
+void StateEvent::encode(BinaryTraceWriter& writer) const
+{
+  std::string size;
+  if (TRACE_display_sizes())
+    size = (extra_ != nullptr) ? extra_->display_size() : "";
+  const std::string* location = nullptr;
+#if HAVE_SMPI
+  if (smpi_cfg_trace_call_location())
+    location = &filename;
+  int line = linenumber;
+#else
+  int line = -1;
+#endif
+  writer.state(eventType_, timestamp_, get_type()->get_id(), get_container()->get_id(),
+               value != nullptr ? value->get_id() : -1, TRACE_display_sizes() ? &size : nullptr, location, line);
+}
 } // namespace instr
 } // namespace simgrid
@@ -14,6 +14,7 @@
 
 namespace simgrid {
 namespace instr {
+class BinaryTraceWriter;
 class EntityValue;
 class TIData;
 
@@ -47,12 +48,12 @@ class PajeEvent {
   Container* container_;
   Type* type_;
 public:
-  static xbt::signal<void(PajeEvent&)> on_creation;
   static xbt::signal<void(PajeEvent const&)> on_destruction;
 
   double timestamp_;
   PajeEventType eventType_;
-  std::stringstream stream_;
+  /* The events are formatted one at a time when the buffer is dumped, so they all share the same stream */
+  static std::stringstream stream_;
 
   PajeEvent(Container* container, Type* type, double timestamp, PajeEventType eventType);
   virtual ~PajeEvent();
@@ -60,7 +61,9 @@ public:
   Container* get_container() const { return container_; }
   Type* get_type() const { return type_; }
 
+  void format();
   virtual void print() = 0;
+  virtual void encode(BinaryTraceWriter& writer) const = 0;
   void insert_into_buffer();
 };
 
@@ -73,6 +76,7 @@ public:
   {
   }
   void print() override { stream_ << " " << value_; }
+  void encode(BinaryTraceWriter& writer) const override;
 };
 
 class StateEvent : public PajeEvent {
@@ -89,6 +93,7 @@ public:
   ~StateEvent() override { on_destruction(*this); }
   bool has_extra() const { return extra_ != nullptr; }
   void print() override;
+  void encode(BinaryTraceWriter& writer) const override;
 };
 
 class LinkEvent : public PajeEvent {
@@ -108,6 +113,7 @@ public:
   {
   }
   void print() override;
+  void encode(BinaryTraceWriter& writer) const override;
 };
 
 class NewEvent : public PajeEvent {
@@ -119,6 +125,7 @@ public:
   {
   }
   void print() override;
+  void encode(BinaryTraceWriter& writer) const override;
 };
 } // namespace instr
 } // namespace simgrid
@@ -5,17 +5,19 @@
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
 #include "simgrid/Exception.hpp"
+#include "simgrid/kernel/Profiler.hpp"
 #include "simgrid/sg_config.hpp"
 #include "src/instr/instr_private.hpp"
 #include "src/instr/instr_smpi.hpp"
 #include "src/smpi/include/private.hpp"
+#include <deque>
 #include <fstream>
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(instr_paje_trace, instr, "tracing event system");
 
 namespace simgrid {
 namespace instr {
-static std::vector<PajeEvent*> buffer;
+static std::deque<PajeEvent*> buffer;
 
 double last_timestamp_to_dump = 0;
 // dumps the trace file until the last_timestamp_to_dump
@@ -23,10 +25,13 @@ void dump_buffer(bool force)
 {
   if (not TRACE_is_enabled())
     return;
+  kernel::Profiler::Scope scope(kernel::Profiler::phase(kernel::Profiler::Phase::TRACING));
   XBT_DEBUG("%s: dump until %f. starts", __func__, last_timestamp_to_dump);
+  // The pending utilization bins would otherwise give events before the dumped ones
+  flush_utilization_bins(force ? simgrid_get_clock() : last_timestamp_to_dump);
   if (force){
     for (auto const& event : buffer) {
-      event->print();
+      event->format();
       delete event;
     }
     buffer.clear();
@@ -36,7 +41,7 @@ void dump_buffer(bool force)
       double head_timestamp = event->timestamp_;
       if (head_timestamp > last_timestamp_to_dump)
         break;
-      event->print();
+      event->format();
       delete event;
       ++i;
     }
@@ -50,7 +55,7 @@ void PajeEvent::insert_into_buffer()
 {
   XBT_DEBUG("%s: insert event_type=%u, timestamp=%f, buffersize=%zu)", __func__, static_cast<unsigned>(eventType_),
             timestamp_, buffer.size());
-  std::vector<PajeEvent*>::reverse_iterator i;
+  std::deque<PajeEvent*>::reverse_iterator i;
   for (i = buffer.rbegin(); i != buffer.rend(); ++i) {
     PajeEvent* e1 = *i;
     XBT_DEBUG("compare to %p is of type %u; timestamp:%f", e1, static_cast<unsigned>(e1->eventType_), e1->timestamp_);
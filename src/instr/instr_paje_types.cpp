@@ -58,7 +58,7 @@ void StateType::pop_event(TIData* extra)
   events_.push_back(new StateEvent(get_issuer(), this, PajeEventType::PopState, nullptr, extra));
 }
 
-void VariableType::instr_event(double now, double delta, const char* resource, double value)
+void VariableType::instr_event(double now, double delta, double value)
 {
   /* To trace resource utilization, we use AddEvent and SubEvent only. This implies to add a SetEvent first to set the
    * initial value of all variables for subsequent adds/subs. If we don't do so, the first AddEvent would be added to a
@@ -66,16 +66,11 @@ void VariableType::instr_event(double now, double delta, const char* resource, d
    */
 
   // to check if variables were previously set to 0, otherwise paje won't simulate them
-  static std::set<std::string, std::less<>> platform_variables;
+  static std::set<std::pair<long long int, long long int>> platform_variables;
 
-  // create a key considering the resource and variable
-  std::string key = std::string(resource) + get_name();
-
-  // check if key exists: if it doesn't, set the variable to zero and mark this in the global map.
-  if (platform_variables.find(key) == platform_variables.end()) {
+  // the first time this variable of this resource is used, set it to zero and mark this in the global set
+  if (platform_variables.emplace(get_issuer()->get_id(), get_id()).second)
     set_event(now, 0);
-    platform_variables.insert(key);
-  }
 
   add_event(now, value);
   sub_event(now + delta, value);
@@ -7,6 +7,7 @@
 #define INSTR_PAJE_TYPES_HPP
 
 #include "src/instr/instr_private.hpp"
+#include <deque>
 #include <memory>
 #include <string>
 #include <vector>
@@ -75,12 +76,43 @@ public:
       : Type(PajeEventType::DefineVariableType, name, name, color, parent)
   {
   }
-  void instr_event(double now, double delta, const char* resource, double value);
+  void instr_event(double now, double delta, double value);
   void set_event(double timestamp, double value);
   void add_event(double timestamp, double value);
   void sub_event(double timestamp, double value);
 };
 
+/** @brief Utilization of a resource averaged over bins of simulated time (with tracing/utilization-bin)
+ *
+ * The pending bins are written out as changes of the variable at the bin boundaries, when there are too many of them,
+ * before the trace buffer is dumped and at the end of the simulation. The utilization reported later for bins that
+ * were already written out is traced with separate Add/Sub events, so that the traced value remains exact. No event is
+ * ever timestamped before the date until which the trace was dumped, nor after the current date.
+ */
+class UtilizationBins {
+  static constexpr long long MAX_PENDING_BINS = 4096;
+  Container* container_;
+  VariableType* variable_;
+  double width_;
+  long long first_bin_;     // index of the first pending bin
+  std::deque<double> sums_; // integral of the utilization over each pending bin
+  double level_ = 0;        // value of the variable at the beginning of the first pending bin
+
+  long long bin_of(double timestamp) const;
+  double overlap(long long bin, double start, double end) const;
+  void change(double timestamp, double delta);
+  void write_out(double start, double end, double value);
+
+public:
+  UtilizationBins(Container* container, VariableType* variable, double width, double start);
+  /** Adds a utilization of the given value during [start, end) */
+  void add(double start, double end, double value);
+  /** Writes out the pending bins before the given one */
+  void flush(long long until_bin);
+  /** Writes out all the pending bins */
+  void flush() { flush(first_bin_ + static_cast<long long>(sums_.size())); }
+};
+
 class ValueType : public Type {
 public:
   std::map<std::string, EntityValue, std::less<>> values_;
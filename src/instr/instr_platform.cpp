@@ -280,39 +280,45 @@ static void on_netzone_creation(s4u::NetZone const& netzone)
   }
 }
 
-static void on_link_creation(s4u::Link const& link)
+static void on_link_creation(s4u::Link& link)
 {
   if (currentContainer.empty()) // No ongoing parsing. Are you creating the loopback?
     return;
 
   auto* container = new Container(link.get_name(), "LINK", currentContainer.back());
+  auto* ext       = new LinkContainerExt(container);
+  link.extension_set(ext);
 
   if ((TRACE_categorized() || TRACE_uncategorized() || TRACE_platform()) && (not TRACE_disable_link())) {
     VariableType* bandwidth = container->type_->by_name_or_create("bandwidth", "");
     bandwidth->set_calling_container(container);
     bandwidth->set_event(0, link.get_bandwidth());
+    ext->bandwidth        = bandwidth;
     VariableType* latency = container->type_->by_name_or_create("latency", "");
     latency->set_calling_container(container);
     latency->set_event(0, link.get_latency());
   }
 
   if (TRACE_uncategorized()) {
-    container->type_->by_name_or_create("bandwidth_used", "0.5 0.5 0.5");
+    ext->bandwidth_used = container->type_->by_name_or_create("bandwidth_used", "0.5 0.5 0.5");
   }
 }
 
-static void on_host_creation(s4u::Host const& host)
+static void on_host_creation(s4u::Host& host)
 {
   if (Container::by_name_or_null(host.get_name())) // This host already exists, do nothing
     return;
 
   Container* container  = new HostContainer(host, currentContainer.back());
   const Container* root = Container::get_root();
+  auto* ext             = new HostContainerExt(container);
+  host.extension_set(ext);
 
   if ((TRACE_categorized() || TRACE_uncategorized() || TRACE_platform()) && (not TRACE_disable_speed())) {
     VariableType* speed = container->type_->by_name_or_create("speed", "");
     speed->set_calling_container(container);
     speed->set_event(0, host.get_speed());
+    ext->speed = speed;
 
     VariableType* cores = container->type_->by_name_or_create("core_count", "");
     cores->set_calling_container(container);
@@ -320,7 +326,7 @@ static void on_host_creation(s4u::Host const& host)
   }
 
   if (TRACE_uncategorized())
-    container->type_->by_name_or_create("speed_used", "0.5 0.5 0.5");
+    ext->speed_used = container->type_->by_name_or_create("speed_used", "0.5 0.5 0.5");
 
   if (TRACE_smpi_is_enabled() && TRACE_smpi_is_grouped()) {
     auto* mpi = container->type_->by_name_or_create<ContainerType>("MPI");
@@ -342,14 +348,14 @@ static void on_action_state_change(kernel::resource::Action const& action,
     const kernel::resource::CpuImpl* cpu = dynamic_cast<kernel::resource::CpuImpl*>(resource);
 
     if (cpu != nullptr)
-      resource_set_utilization("HOST", "speed_used", cpu->get_cname(), action.get_category(), value,
-                               action.get_last_update(), simgrid_get_clock() - action.get_last_update());
+      resource_set_utilization(*cpu->get_iface(), action.get_category(), value, action.get_last_update(),
+                               simgrid_get_clock() - action.get_last_update());
 
     const kernel::resource::LinkImpl* link = dynamic_cast<kernel::resource::LinkImpl*>(resource);
 
     if (link != nullptr)
-      resource_set_utilization("LINK", "bandwidth_used", link->get_cname(), action.get_category(), value,
-                               action.get_last_update(), simgrid_get_clock() - action.get_last_update());
+      resource_set_utilization(*link->get_iface(), action.get_category(), value, action.get_last_update(),
+                               simgrid_get_clock() - action.get_last_update());
   }
 }
 
@@ -363,13 +369,13 @@ static void on_platform_created()
   dump_buffer(true);
 }
 
-static void on_actor_creation(s4u::Actor const& actor)
+static void on_actor_creation(s4u::Actor& actor)
 {
-  const Container* root      = Container::get_root();
-  Container* container       = Container::by_name(actor.get_host()->get_name());
-  std::string container_name = instr_pid(actor);
+  const Container* root = Container::get_root();
+  Container* container  = actor.get_host()->extension<HostContainerExt>()->container;
+  auto* ext             = ActorContainerExt::get(actor);
 
-  container->create_child(container_name, "ACTOR");
+  ext->container   = container->create_child(instr_pid(actor), "ACTOR");
   auto* actor_type = container->type_->by_name_or_create<ContainerType>("ACTOR");
   auto* state      = actor_type->by_name_or_create<StateType>("ACTOR_STATE");
   state->add_entity_value("suspend", "1 0 1");
@@ -377,38 +383,48 @@ static void on_actor_creation(s4u::Actor const& actor)
   state->add_entity_value("receive", "1 0 0");
   state->add_entity_value("send", "0 0 1");
   state->add_entity_value("execute", "0 1 1");
+  ext->actor_state = state;
   root->type_->by_name_or_create("ACTOR_LINK", actor_type, actor_type);
 
-  actor.on_exit([container_name](bool failed) {
-    if (failed)
+  actor.on_exit([ext](bool failed) {
+    if (failed) {
       // kill means that this actor no longer exists, let's destroy it
-      Container::by_name(container_name)->remove_from_parent();
+      ext->container->remove_from_parent();
+      ext->container = nullptr;
+    }
   });
 }
 
+static StateType* actor_state(s4u::Actor const& actor)
+{
+  const auto* ext = actor.extension<ActorContainerExt>();
+  return ext->container->get_state(ext->actor_state);
+}
+
 static void on_actor_host_change(s4u::Actor const& actor, s4u::Host const& /*previous_location*/)
 {
   static long long int counter = 0;
-  Container* container         = Container::by_name(instr_pid(actor));
+  auto* ext                    = actor.extension<ActorContainerExt>();
   LinkType* link               = Container::get_root()->get_link("ACTOR_LINK");
 
   // start link
-  link->start_event(container, "M", std::to_string(counter));
+  link->start_event(ext->container, "M", std::to_string(counter));
   // destroy existing container of this process
-  container->remove_from_parent();
+  ext->container->remove_from_parent();
   // create new container on the new_host location
-  Container::by_name(actor.get_host()->get_name())->create_child(instr_pid(actor), "ACTOR");
+  ext->container = actor.get_host()->extension<HostContainerExt>()->container->create_child(instr_pid(actor), "ACTOR");
   // end link
-  link->end_event(Container::by_name(instr_pid(actor)), "M", std::to_string(counter));
+  link->end_event(ext->container, "M", std::to_string(counter));
   counter++;
 }
 
-static void on_vm_creation(s4u::Host const& host)
+static void on_vm_creation(s4u::Host& host)
 {
-  const Container* container = new HostContainer(host, currentContainer.back());
-  const Container* root      = Container::get_root();
-  auto* vm                   = container->type_->by_name_or_create<ContainerType>("VM");
-  auto* state                = vm->by_name_or_create<StateType>("VM_STATE");
+  auto* ext             = host.extension<HostContainerExt>(); // Already set if on_host_creation() traced that host
+  Container* container  = ext != nullptr ? ext->container : new HostContainer(host, currentContainer.back());
+  const Container* root = Container::get_root();
+  auto* vm              = container->type_->by_name_or_create<ContainerType>("VM");
+  auto* state           = vm->by_name_or_create<StateType>("VM_STATE");
   state->add_entity_value("suspend", "1 0 1");
   state->add_entity_value("sleep", "1 1 0");
   state->add_entity_value("receive", "1 0 0");
@@ -416,25 +432,45 @@ static void on_vm_creation(s4u::Host const& host)
   state->add_entity_value("execute", "0 1 1");
   root->type_->by_name_or_create("VM_LINK", vm, vm);
   root->type_->by_name_or_create("VM_ACTOR_LINK", vm, vm);
+
+  if (ext == nullptr) {
+    ext = new HostContainerExt(container);
+    host.extension_set(ext);
+  }
+  ext->vm_state = state;
+}
+
+static StateType* vm_state(s4u::VirtualMachine const& vm)
+{
+  const auto* ext = vm.extension<HostContainerExt>();
+  return ext->container->get_state(ext->vm_state);
 }
 
 void define_callbacks()
 {
+  if (not HostContainerExt::EXTENSION_ID.valid()) {
+    HostContainerExt::EXTENSION_ID  = s4u::Host::extension_create<HostContainerExt>();
+    LinkContainerExt::EXTENSION_ID  = s4u::Link::extension_create<LinkContainerExt>();
+    ActorContainerExt::EXTENSION_ID = s4u::Actor::extension_create<ActorContainerExt>();
+  }
+
   // always need the callbacks to zones (we need only the root zone), to create the rootContainer and the rootType
   // properly
   if (TRACE_needs_platform()) {
     s4u::Engine::on_platform_created.connect(on_platform_created);
     s4u::Host::on_creation.connect(on_host_creation);
     s4u::Host::on_speed_change.connect([](s4u::Host const& host) {
-      Container::by_name(host.get_name())
-          ->get_variable("speed")
-          ->set_event(surf_get_clock(), host.get_core_count() * host.get_available_speed());
+      const auto* ext = host.extension<HostContainerExt>();
+      if (ext != nullptr && ext->speed != nullptr)
+        ext->container->get_variable(ext->speed)
+            ->set_event(surf_get_clock(), host.get_core_count() * host.get_available_speed());
     });
     s4u::Link::on_creation.connect(on_link_creation);
     s4u::Link::on_bandwidth_change.connect([](s4u::Link const& link) {
-      Container::by_name(link.get_name())
-          ->get_variable("bandwidth")
-          ->set_event(surf_get_clock(), sg_bandwidth_factor * link.get_bandwidth());
+      const auto* ext = link.extension<LinkContainerExt>();
+      if (ext != nullptr && ext->bandwidth != nullptr)
+        ext->container->get_variable(ext->bandwidth)
+            ->set_event(surf_get_clock(), sg_bandwidth_factor * link.get_bandwidth());
     });
     s4u::NetZone::on_seal.connect([](s4u::NetZone const& /*netzone*/) { currentContainer.pop_back(); });
     kernel::routing::NetPoint::on_creation.connect([](kernel::routing::NetPoint const& netpoint) {
@@ -451,64 +487,48 @@ void define_callbacks()
   if (TRACE_actor_is_enabled()) {
     s4u::Actor::on_creation.connect(on_actor_creation);
     s4u::Actor::on_destruction.connect([](s4u::Actor const& actor) {
-      auto container = Container::by_name_or_null(instr_pid(actor));
-      if (container != nullptr)
-        container->remove_from_parent();
-    });
-    s4u::Actor::on_suspend.connect([](s4u::Actor const& actor) {
-      Container::by_name(instr_pid(actor))->get_state("ACTOR_STATE")->push_event("suspend");
-    });
-    s4u::Actor::on_resume.connect(
-        [](s4u::Actor const& actor) { Container::by_name(instr_pid(actor))->get_state("ACTOR_STATE")->pop_event(); });
-    s4u::Actor::on_sleep.connect([](s4u::Actor const& actor) {
-      Container::by_name(instr_pid(actor))->get_state("ACTOR_STATE")->push_event("sleep");
-    });
-    s4u::Actor::on_wake_up.connect(
-        [](s4u::Actor const& actor) { Container::by_name(instr_pid(actor))->get_state("ACTOR_STATE")->pop_event(); });
-    s4u::Exec::on_start.connect([](s4u::Exec const&) {
-      Container::by_name(instr_pid(*s4u::Actor::self()))->get_state("ACTOR_STATE")->push_event("execute");
-    });
-    s4u::Exec::on_completion.connect([](s4u::Exec const&) {
-      Container::by_name(instr_pid(*s4u::Actor::self()))->get_state("ACTOR_STATE")->pop_event();
+      auto* ext = actor.extension<ActorContainerExt>();
+      if (ext != nullptr && ext->container != nullptr) {
+        ext->container->remove_from_parent();
+        ext->container = nullptr;
+      }
     });
+    s4u::Actor::on_suspend.connect([](s4u::Actor const& actor) { actor_state(actor)->push_event("suspend"); });
+    s4u::Actor::on_resume.connect([](s4u::Actor const& actor) { actor_state(actor)->pop_event(); });
+    s4u::Actor::on_sleep.connect([](s4u::Actor const& actor) { actor_state(actor)->push_event("sleep"); });
+    s4u::Actor::on_wake_up.connect([](s4u::Actor const& actor) { actor_state(actor)->pop_event(); });
+    s4u::Exec::on_start.connect([](s4u::Exec const&) { actor_state(*s4u::Actor::self())->push_event("execute"); });
+    s4u::Exec::on_completion.connect([](s4u::Exec const&) { actor_state(*s4u::Actor::self())->pop_event(); });
     s4u::Comm::on_start.connect([](s4u::Comm const&, bool is_sender) {
-      Container::by_name(instr_pid(*s4u::Actor::self()))
-          ->get_state("ACTOR_STATE")
-          ->push_event(is_sender ? "send" : "receive");
-    });
-    s4u::Comm::on_completion.connect([](s4u::Comm const&) {
-      Container::by_name(instr_pid(*s4u::Actor::self()))->get_state("ACTOR_STATE")->pop_event();
+      actor_state(*s4u::Actor::self())->push_event(is_sender ? "send" : "receive");
     });
+    s4u::Comm::on_completion.connect([](s4u::Comm const&) { actor_state(*s4u::Actor::self())->pop_event(); });
     s4u::Actor::on_host_change.connect(on_actor_host_change);
   }
 
   if (TRACE_smpi_is_enabled() && TRACE_smpi_is_computing()) {
     s4u::Exec::on_start.connect([](s4u::Exec const& exec) {
-      Container::by_name(std::string("rank-") + std::to_string(s4u::Actor::self()->get_pid()))
-          ->get_state("MPI_STATE")
-          ->push_event("computing", new CpuTIData("compute", exec.get_cost()));
+      const auto* ext = s4u::Actor::self()->extension<ActorContainerExt>();
+      ext->rank->get_state(ext->mpi_state)->push_event("computing", new CpuTIData("compute", exec.get_cost()));
     });
     s4u::Exec::on_completion.connect([](s4u::Exec const&) {
-      Container::by_name(std::string("rank-") + std::to_string(s4u::Actor::self()->get_pid()))
-          ->get_state("MPI_STATE")
-          ->pop_event();
+      const auto* ext = s4u::Actor::self()->extension<ActorContainerExt>();
+      ext->rank->get_state(ext->mpi_state)->pop_event();
     });
   }
 
   if (TRACE_vm_is_enabled()) {
     s4u::Host::on_creation.connect(on_vm_creation);
-    s4u::VirtualMachine::on_start.connect([](s4u::VirtualMachine const& vm) {
-      Container::by_name(vm.get_name())->get_state("VM_STATE")->push_event("start");
-    });
-    s4u::VirtualMachine::on_started.connect(
-        [](s4u::VirtualMachine const& vm) { Container::by_name(vm.get_name())->get_state("VM_STATE")->pop_event(); });
-    s4u::VirtualMachine::on_suspend.connect([](s4u::VirtualMachine const& vm) {
-      Container::by_name(vm.get_name())->get_state("VM_STATE")->push_event("suspend");
+    s4u::VirtualMachine::on_start.connect(
+        [](s4u::VirtualMachine const& vm) { vm_state(vm)->push_event("start"); });
+    s4u::VirtualMachine::on_started.connect([](s4u::VirtualMachine const& vm) { vm_state(vm)->pop_event(); });
+    s4u::VirtualMachine::on_suspend.connect(
+        [](s4u::VirtualMachine const& vm) { vm_state(vm)->push_event("suspend"); });
+    s4u::VirtualMachine::on_resume.connect([](s4u::VirtualMachine const& vm) { vm_state(vm)->pop_event(); });
+    s4u::Host::on_destruction.connect([](s4u::Host const& host) {
+      const auto* ext = host.extension<HostContainerExt>();
+      ext->container->remove_from_parent();
     });
-    s4u::VirtualMachine::on_resume.connect(
-        [](s4u::VirtualMachine const& vm) { Container::by_name(vm.get_name())->get_state("VM_STATE")->pop_event(); });
-    s4u::Host::on_destruction.connect(
-        [](s4u::Host const& host) { Container::by_name(host.get_name())->remove_from_parent(); });
   }
 }
 } // namespace instr
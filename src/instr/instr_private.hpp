@@ -15,6 +15,7 @@
 #include "src/instr/instr_paje_types.hpp"
 #include "src/instr/instr_paje_values.hpp"
 
+#include <deque>
 #include <fstream>
 #include <iomanip> /** std::setprecision **/
 #include <iostream>
@@ -23,14 +24,15 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace simgrid {
 namespace instr {
 namespace paje {
 
-void dump_generator_version();
-void dump_comment_file(const std::string& filename);
-void dump_header(bool basic, bool display_sizes);
+void dump_generator_version(std::ostream& os);
+void dump_comment_file(std::ostream& os, const std::string& filename);
+void dump_header(std::ostream& os, bool basic, bool display_sizes);
 } // namespace paje
 
 /* Format of TRACING output.
@@ -38,19 +40,27 @@ void dump_header(bool basic, bool display_sizes);
  *   - TI is a trick to reuse the tracing functions to generate a time independent trace during the execution. Such
  *     trace can easily be replayed with smpi_replay afterward. This trick should be removed and replaced by some code
  *     using the signal that we will create to cleanup the TRACING
+ *   - binary is a compact encoding of the paje trace (see instr_binary_trace.cpp), that can be converted back to paje
  */
-enum class TraceFormat { Paje, /*TimeIndependent*/ Ti };
+enum class TraceFormat { Paje, /*TimeIndependent*/ Ti, Binary };
 extern TraceFormat trace_format;
+extern std::unique_ptr<BinaryTraceWriter> binary_trace_writer;
 extern int trace_precision;
 extern double last_timestamp_to_dump;
+/* The utilization bins before this one are written out for all resources (reset for each simulation) */
+extern long long utilization_bins_flushed_until;
 
 void init();
 void define_callbacks();
 
 void platform_graph_export_graphviz(const std::string& output_filename);
 
-void resource_set_utilization(const char* type, const char* name, const char* resource, const std::string& category,
-                              double value, double now, double delta);
+void resource_set_utilization(s4u::Host const& host, const std::string& category, double value, double now,
+                              double delta);
+void resource_set_utilization(s4u::Link const& link, const std::string& category, double value, double now,
+                              double delta);
+/* Writes out the utilization bins that end before the given date, or all of them by default */
+void flush_utilization_bins(double until = -1.0);
 void dump_buffer(bool force);
 
 class TIData {
@@ -232,6 +242,44 @@ public:
   }
   std::string display_size() override { return "NA"; }
 };
+
+/** @brief Folds the repeated sequences of actions of a TI trace into loops, before writing them into a file
+ *
+ * The last actions of a process are kept in a window. Each time that an action is added, the sequence that repeats at
+ * the end of the window becomes a loop (or another iteration of the loop that precedes it). The actions leaving the
+ * window cannot change anymore, and are written into the file. Loops are written as follows:
+ *
+ *    <rank> loop <iterations>
+ *    ... body of the loop, possibly containing other loops ...
+ *    <rank> end_loop
+ */
+class TILoopFolder {
+  struct Item {
+    std::string lines;                             // for actions only
+    unsigned long iterations = 0;                  // 0 for actions
+    std::shared_ptr<const std::vector<Item>> body; // for loops only
+    size_t hash;
+
+    explicit Item(const std::string& action_lines);
+    Item(unsigned long loop_iterations, std::shared_ptr<const std::vector<Item>> loop_body);
+    void update_hash();
+    bool operator==(const Item& other) const;
+  };
+
+  std::ofstream* file_;
+  std::string rank_;
+  std::deque<Item> window_;
+
+  bool fold();
+  void write(const Item& item);
+
+public:
+  static constexpr size_t WINDOW_SIZE = 256;
+
+  explicit TILoopFolder(std::ofstream* file) : file_(file) {}
+  void add(const std::string& action_lines);
+  void flush();
+};
 } // namespace instr
 } // namespace simgrid
 
@@ -255,6 +303,7 @@ XBT_PRIVATE bool TRACE_vm_is_enabled();
 XBT_PRIVATE bool TRACE_disable_link();
 XBT_PRIVATE bool TRACE_disable_speed();
 XBT_PRIVATE bool TRACE_display_sizes();
+XBT_PRIVATE double TRACE_utilization_bin();
 
 /* Public functions used in SMPI */
 XBT_PUBLIC bool TRACE_smpi_is_enabled();
@@ -4,32 +4,198 @@
 /* This program is free software; you can redistribute it and/or modify it
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
+#include "simgrid/s4u/Engine.hpp"
+#include "simgrid/s4u/Host.hpp"
+#include "simgrid/s4u/Link.hpp"
 #include "src/instr/instr_private.hpp"
+#include <algorithm>
+#include <cmath>
 #include <string>
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY (instr_resource, instr, "tracing (un)-categorized resource utilization");
 
 namespace simgrid {
 namespace instr {
-void resource_set_utilization(const char* type, const char* name, const char* resource, const std::string& category,
-                              double value, double now, double delta)
+UtilizationBins::UtilizationBins(Container* container, VariableType* variable, double width, double start)
+    : container_(container), variable_(variable), width_(width), first_bin_(bin_of(start))
+{
+  // set the variable to zero first, so that the subsequent adds/subs are not added to a non-determined value
+  container_->get_variable(variable_)->set_event(
+      std::max(static_cast<double>(first_bin_) * width_, last_timestamp_to_dump), 0);
+}
+
+long long UtilizationBins::bin_of(double timestamp) const
+{
+  return static_cast<long long>(std::floor(timestamp / width_));
+}
+
+double UtilizationBins::overlap(long long bin, double start, double end) const
+{
+  return std::min(end, static_cast<double>(bin + 1) * width_) - std::max(start, static_cast<double>(bin) * width_);
+}
+
+void UtilizationBins::change(double timestamp, double delta)
+{
+  // The part of the trace before last_timestamp_to_dump is already written: shift the changes that would come before
+  timestamp = std::max(timestamp, last_timestamp_to_dump);
+  if (delta > 0)
+    container_->get_variable(variable_)->add_event(timestamp, delta);
+  else if (delta < 0)
+    container_->get_variable(variable_)->sub_event(timestamp, -delta);
+}
+
+/* Traces a utilization without going through the pending bins, as its average over its first and last bins and its
+ * value on the bins in between: it takes at most 4 events whatever its length. */
+void UtilizationBins::write_out(double start, double end, double value)
+{
+  long long first = bin_of(start);
+  long long last  = std::max(first, bin_of(end) - (std::fmod(end, width_) == 0 ? 1 : 0));
+  double current  = 0;
+  auto step_to    = [this, &current](long long bin, double average) {
+    change(static_cast<double>(bin) * width_, average - current);
+    current = average;
+  };
+
+  step_to(first, value * overlap(first, start, end) / width_);
+  if (last > first + 1)
+    step_to(first + 1, value);
+  if (last > first)
+    step_to(last, value * overlap(last, start, end) / width_);
+  step_to(last + 1, 0);
+}
+
+void UtilizationBins::add(double start, double end, double value)
+{
+  if (end <= start)
+    return;
+
+  double written_until = static_cast<double>(first_bin_) * width_;
+  if (start < written_until) { // these bins were already written out
+    write_out(start, std::min(end, written_until), value);
+    if (end <= written_until)
+      return;
+    start = written_until;
+  }
+
+  long long first = std::max(first_bin_, bin_of(start));
+  long long last  = std::max(first, bin_of(end) - (std::fmod(end, width_) == 0 ? 1 : 0));
+  if (last - first >= MAX_PENDING_BINS) { // Long enough to be traced on its own, but for its last bin
+    // that last bin stays pending, as writing it out would give an event after the current date
+    double last_start = static_cast<double>(last) * width_;
+    write_out(start, last_start, value);
+    start = last_start;
+    first = last;
+  }
+  if (first > first_bin_ + static_cast<long long>(sums_.size())) // nothing happened in between
+    flush(first);
+  if (last >= first_bin_ + MAX_PENDING_BINS)
+    flush(last - MAX_PENDING_BINS + 1);
+
+  if (static_cast<long long>(sums_.size()) <= last - first_bin_)
+    sums_.resize(last - first_bin_ + 1, 0.0);
+  for (long long bin = first; bin <= last; bin++)
+    sums_[bin - first_bin_] += value * overlap(bin, start, end);
+}
+
+void UtilizationBins::flush(long long until_bin)
+{
+  long long pending_end = first_bin_ + static_cast<long long>(sums_.size());
+  for (; first_bin_ < std::min(until_bin, pending_end); first_bin_++) {
+    // the last bin may be cut by the end of the simulation
+    double duration = std::min(width_, simgrid_get_clock() - static_cast<double>(first_bin_) * width_);
+    double average  = duration > 0 ? sums_.front() / duration : 0;
+    sums_.pop_front();
+    change(static_cast<double>(first_bin_) * width_, average - level_);
+    level_ = average;
+  }
+  if (until_bin >= pending_end) { // Back to zero after the last pending bin
+    change(std::min(static_cast<double>(pending_end) * width_, simgrid_get_clock()), -level_);
+    level_     = 0;
+    first_bin_ = until_bin;
+  }
+}
+
+static void add_utilization(Container* container, VariableType* variable, std::unique_ptr<UtilizationBins>& bins,
+                            double now, double delta, double value)
+{
+  if (TRACE_utilization_bin() > 0) {
+    if (not bins)
+      bins = std::make_unique<UtilizationBins>(container, variable, TRACE_utilization_bin(), now);
+    bins->add(now, now + delta, value);
+  } else {
+    container->get_variable(variable)->instr_event(now, delta, value);
+  }
+}
+
+static void set_utilization(const char* type, Container* container, VariableType* variable,
+                            std::unique_ptr<UtilizationBins>& bins, const std::string& category, double value,
+                            double now, double delta)
 {
   // only trace resource utilization if resource is known by tracing mechanism
-  Container* container = Container::by_name_or_null(resource);
-  if (container == nullptr || value == 0.0)
+  if (container == nullptr || variable == nullptr || value == 0.0)
     return;
 
   // trace uncategorized resource utilization
   if (TRACE_uncategorized()){
-    XBT_VERB("UNCAT %s [%f - %f] %s %s %f", type, now, now + delta, resource, name, value);
-    container->get_variable(name)->instr_event(now, delta, resource, value);
+    XBT_VERB("UNCAT %s [%f - %f] %s %s %f", type, now, now + delta, container->get_cname(), variable->get_cname(),
+             value);
+    add_utilization(container, variable, bins, now, delta, value);
   }
 
   // trace categorized resource utilization
   if (TRACE_categorized() && not category.empty()) {
-    std::string category_type = name[0] + category;
-    XBT_DEBUG("CAT %s [%f - %f] %s %s %f", type, now, now + delta, resource, category_type.c_str(), value);
-    container->get_variable(name)->instr_event(now, delta, resource, value);
+    std::string category_type = variable->get_name()[0] + category;
+    XBT_DEBUG("CAT %s [%f - %f] %s %s %f", type, now, now + delta, container->get_cname(), category_type.c_str(),
+              value);
+    add_utilization(container, variable, bins, now, delta, value);
+  }
+}
+
+void resource_set_utilization(s4u::Host const& host, const std::string& category, double value, double now,
+                              double delta)
+{
+  auto* ext = host.extension<HostContainerExt>();
+  if (ext != nullptr)
+    set_utilization("HOST", ext->container, ext->speed_used, ext->speed_used_bins, category, value, now, delta);
+}
+
+void resource_set_utilization(s4u::Link const& link, const std::string& category, double value, double now,
+                              double delta)
+{
+  auto* ext = link.extension<LinkContainerExt>();
+  if (ext != nullptr)
+    set_utilization("LINK", ext->container, ext->bandwidth_used, ext->bandwidth_used_bins, category, value, now,
+                    delta);
+}
+
+long long utilization_bins_flushed_until = 0;
+
+void flush_utilization_bins(double until)
+{
+  if (TRACE_utilization_bin() <= 0)
+    return;
+  long long until_bin = until < 0 ? 0 : static_cast<long long>(std::floor(until / TRACE_utilization_bin()));
+  if (until >= 0) {
+    // Most time advances stay within the same bin: there is nothing new to flush then
+    if (until_bin <= utilization_bins_flushed_until)
+      return;
+    utilization_bins_flushed_until = until_bin;
+  }
+  auto flush = [until, until_bin](UtilizationBins& bins) {
+    if (until < 0)
+      bins.flush();
+    else
+      bins.flush(until_bin);
+  };
+  for (auto const* host : s4u::Engine::get_instance()->get_all_hosts()) {
+    const auto* ext = host->extension<HostContainerExt>();
+    if (ext != nullptr && ext->speed_used_bins)
+      flush(*ext->speed_used_bins);
+  }
+  for (auto const* link : s4u::Engine::get_instance()->get_all_links()) {
+    const auto* ext = link->extension<LinkContainerExt>();
+    if (ext != nullptr && ext->bandwidth_used_bins)
+      flush(*ext->bandwidth_used_bins);
   }
 }
 } // namespace instr
@@ -0,0 +1,102 @@
+/* Copyright (c) 2021. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "src/instr/instr_private.hpp"
+
+#include <algorithm>
+#include <functional>
+
+namespace simgrid {
+namespace instr {
+
+TILoopFolder::Item::Item(const std::string& action_lines) : lines(action_lines), hash(std::hash<std::string>()(lines))
+{
+}
+
+TILoopFolder::Item::Item(unsigned long loop_iterations, std::shared_ptr<const std::vector<Item>> loop_body)
+    : iterations(loop_iterations), body(std::move(loop_body))
+{
+  update_hash();
+}
+
+void TILoopFolder::Item::update_hash()
+{
+  hash = iterations;
+  for (Item const& item : *body)
+    hash = hash * 31 + item.hash;
+}
+
+bool TILoopFolder::Item::operator==(const Item& other) const
+{
+  if (hash != other.hash || iterations != other.iterations)
+    return false;
+  if (iterations == 0)
+    return lines == other.lines;
+  return body == other.body || *body == *other.body;
+}
+
+/* Folds the end of the window once, and returns whether something changed */
+bool TILoopFolder::fold()
+{
+  size_t size = window_.size();
+  auto end    = window_.end();
+
+  /* The last actions may be another iteration of the loop that precedes them */
+  for (size_t len = 1; len < size; len++) {
+    Item& loop = window_[size - 1 - len];
+    if (loop.iterations > 0 && loop.body->size() == len && std::equal(end - len, end, loop.body->begin())) {
+      loop.iterations++;
+      loop.update_hash();
+      window_.erase(end - len, end);
+      return true;
+    }
+  }
+
+  /* Or the same sequence may appear twice at the end of the window */
+  for (size_t len = 1; 2 * len <= size; len++) {
+    if (window_[size - 1].hash == window_[size - 1 - len].hash && std::equal(end - len, end, end - 2 * len)) {
+      auto body = std::make_shared<const std::vector<Item>>(end - len, end);
+      window_.erase(end - 2 * len, end);
+      window_.emplace_back(2, std::move(body));
+      return true;
+    }
+  }
+  return false;
+}
+
+void TILoopFolder::write(const Item& item)
+{
+  if (item.iterations == 0) {
+    *file_ << item.lines << '\n';
+  } else {
+    *file_ << rank_ << " loop " << item.iterations << '\n';
+    for (Item const& elm : *item.body)
+      write(elm);
+    *file_ << rank_ << " end_loop\n";
+  }
+}
+
+void TILoopFolder::add(const std::string& action_lines)
+{
+  if (rank_.empty())
+    rank_ = action_lines.substr(0, action_lines.find(' '));
+  window_.emplace_back(action_lines);
+  while (fold())
+    continue;
+  while (window_.size() > WINDOW_SIZE) {
+    write(window_.front());
+    window_.pop_front();
+  }
+}
+
+void TILoopFolder::flush()
+{
+  for (Item const& item : window_)
+    write(item);
+  window_.clear();
+  file_->flush();
+}
+} // namespace instr
+} // namespace simgrid
@@ -6,9 +6,11 @@
 #include "src/kernel/EngineImpl.hpp"
 #include "mc/mc.h"
 #include "simgrid/Exception.hpp"
+#include "simgrid/kernel/Profiler.hpp"
 #include "simgrid/kernel/Timer.hpp"
 #include "simgrid/kernel/routing/NetPoint.hpp"
 #include "simgrid/kernel/routing/NetZoneImpl.hpp"
+#include "simgrid/kernel/routing/StarZone.hpp"
 #include "simgrid/s4u/Host.hpp"
 #include "simgrid/sg_config.hpp"
 #include "src/include/surf/surf.hpp" //get_clock() and surf_solve()
@@ -20,6 +22,7 @@
 #include "src/surf/network_interface.hpp"
 #include "src/surf/xml/platf.hpp" // FIXME: KILLME. There must be a better way than mimicking XML here
 
+#include <algorithm>
 #include <boost/algorithm/string/predicate.hpp>
 #ifndef _WIN32
 #include <dlfcn.h>
@@ -35,7 +38,7 @@ config::Flag<double> cfg_breakpoint{"debug/breakpoint",
 EngineImpl::~EngineImpl()
 {
   while (not timer::kernel_timers().empty()) {
-    delete timer::kernel_timers().top().second;
+    delete std::get<2>(timer::kernel_timers().top());
     timer::kernel_timers().pop();
   }
 
@@ -128,6 +131,28 @@ void EngineImpl::add_split_duplex_link(const std::string& name, std::unique_ptr<
   split_duplex_links_[name] = std::move(link);
 }
 
+void EngineImpl::remove_lazy_zone(const routing::LazyStarZone* zone)
+{
+  lazy_zones_.erase(std::remove(lazy_zones_.begin(), lazy_zones_.end(), zone), lazy_zones_.end());
+}
+
+s4u::Host* EngineImpl::materialize_host(const std::string& name) const
+{
+  if (lazy_zones_.empty())
+    return nullptr;
+  /* Creating a host modifies the platform and fires signals: when looked up by an actor, this is done by maestro */
+  return actor::simcall([this, &name]() -> s4u::Host* {
+    /* Another actor may have created that host while this one was waiting for maestro */
+    auto existing = hosts_.find(name);
+    if (existing != hosts_.end())
+      return existing->second;
+    for (auto* zone : lazy_zones_)
+      if (s4u::Host* host = zone->materialize(name))
+        return host;
+    return nullptr;
+  });
+}
+
 /** Wake up all actors waiting for a Surf action to finish */
 void EngineImpl::wake_all_waiting_actors() const
 {
@@ -268,7 +293,7 @@ void EngineImpl::display_all_actor_status() const
   }
 }
 
-void EngineImpl::run()
+void EngineImpl::run(double max_date)
 {
   if (MC_record_replay_is_active()) {
     mc::replay(MC_record_path());
@@ -277,6 +302,7 @@ void EngineImpl::run()
   }
 
   double time = 0;
+  Profiler::start();
 
   do {
     XBT_DEBUG("New Schedule Round; size(queue)=%zu", actors_to_run_.size());
@@ -291,13 +317,19 @@ void EngineImpl::run()
 #endif
     }
 
-    execute_tasks();
+    {
+      Profiler::Scope scope(Profiler::phase(Profiler::Phase::TASKS));
+      execute_tasks();
+    }
 
     while (not actors_to_run_.empty()) {
       XBT_DEBUG("New Sub-Schedule Round; size(queue)=%zu", actors_to_run_.size());
 
       /* Run all actors that are ready to run, possibly in parallel */
-      run_all_actors();
+      {
+        Profiler::Scope scope(Profiler::phase(Profiler::Phase::ACTORS));
+        run_all_actors();
+      }
 
       /* answer sequentially and in a fixed arbitrary order all the simcalls that were issued during that sub-round */
 
@@ -361,16 +393,22 @@ void EngineImpl::run()
        *   That would thus be a pure waste of time.
        */
 
-      for (auto const& actor : actors_that_ran_) {
-        if (actor->simcall_.call_ != simix::Simcall::NONE) {
-          actor->simcall_handle(0);
+      {
+        Profiler::Scope scope(Profiler::phase(Profiler::Phase::SIMCALLS));
+        for (auto const& actor : actors_that_ran_) {
+          if (actor->simcall_.call_ != simix::Simcall::NONE) {
+            actor->simcall_handle(0);
+          }
         }
       }
 
-      execute_tasks();
-      do {
-        wake_all_waiting_actors();
-      } while (execute_tasks());
+      {
+        Profiler::Scope scope(Profiler::phase(Profiler::Phase::TASKS));
+        execute_tasks();
+        do {
+          wake_all_waiting_actors();
+        } while (execute_tasks());
+      }
 
       /* If only daemon actors remain, cancel their actions, mark them to die and reschedule them */
       if (actor_list_.size() == daemons_.size())
@@ -380,9 +418,14 @@ void EngineImpl::run()
         }
     }
 
+    // Compute the date of the next solve: either when a timer fires, or when the requested deadline is reached if
+    // something may still happen after it (a later timer, or the actions of the remaining actors)
     time = timer::Timer::next();
+    if (max_date > -1.0 && (time > max_date || (time < 0.0 && not actor_list_.empty())))
+      time = max_date;
     if (time > -1.0 || not actor_list_.empty()) {
       XBT_DEBUG("Calling surf_solve");
+      Profiler::Scope scope(Profiler::phase(Profiler::Phase::SOLVE));
       time = surf_solve(time);
       XBT_DEBUG("Moving time ahead : %g", time);
     }
@@ -392,16 +435,22 @@ void EngineImpl::run()
     /* as failed. On each host, signal all the running actors with host_fail */
 
     // Execute timers and tasks until there isn't anything to be done:
-    bool again = false;
-    do {
-      again = timer::Timer::execute_all();
-      if (execute_tasks())
-        again = true;
-      wake_all_waiting_actors();
-    } while (again);
+    {
+      Profiler::Scope scope(Profiler::phase(Profiler::Phase::TIMERS));
+      bool again = false;
+      do {
+        again = timer::Timer::execute_all();
+        if (execute_tasks())
+          again = true;
+        wake_all_waiting_actors();
+      } while (again);
+    }
 
     /* Clean actors to destroy */
-    empty_trash();
+    {
+      Profiler::Scope scope(Profiler::phase(Profiler::Phase::TRASH));
+      empty_trash();
+    }
 
     XBT_DEBUG("### time %f, #actors %zu, #to_run %zu", time, actor_list_.size(), actors_to_run_.size());
 
@@ -419,12 +468,22 @@ void EngineImpl::run()
         simix_global->get_maestro()->kill(kv.second);
       }
     }
-  } while (time > -1.0 || has_actors_to_run());
+  } while ((time > -1.0 && (max_date < 0.0 || not double_equals(surf_get_clock(), max_date, sg_surf_precision))) ||
+           has_actors_to_run());
+  Profiler::stop();
+
+  /* Stopped at the requested date: the simulation can be resumed later on */
+  if (max_date > -1.0 && not actor_list_.empty())
+    return;
 
   if (not actor_list_.empty())
     THROW_IMPOSSIBLE;
 
-  simgrid::s4u::Engine::on_simulation_end();
+  /* Only notify the end once, even if run() is called again after run_until() reached the end */
+  if (not end_notified_) {
+    end_notified_ = true;
+    simgrid::s4u::Engine::on_simulation_end();
+  }
 }
 } // namespace kernel
 } // namespace simgrid
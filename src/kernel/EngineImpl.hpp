@@ -31,14 +31,20 @@
 
 namespace simgrid {
 namespace kernel {
+namespace routing {
+class LazyStarZone;
+}
 
 class EngineImpl {
   std::map<std::string, s4u::Host*, std::less<>> hosts_;
   std::map<std::string, resource::LinkImpl*, std::less<>> links_;
+  std::vector<s4u::Host*> hosts_by_id_;          // Indexed by Host::get_id(), nullptr once the host is destroyed
+  std::vector<s4u::Link*> links_by_id_;          // Indexed by Link::get_id(), nullptr once the link is destroyed
   /* save split-duplex links separately, keep links_ with only LinkImpl* seen by the user
    * members of a split-duplex are saved in the links_ */
   std::map<std::string, std::unique_ptr<resource::SplitDuplexLinkImpl>, std::less<>> split_duplex_links_;
   std::unordered_map<std::string, routing::NetPoint*> netpoints_;
+  std::vector<routing::LazyStarZone*> lazy_zones_; // Zones creating their hosts when they are first looked up
   std::unordered_map<std::string, activity::MailboxImpl*> mailboxes_;
 
   std::unordered_map<std::string, actor::ActorCodeFactory> registered_functions; // Maps function names to actor code
@@ -54,6 +60,7 @@ class EngineImpl {
                          boost::intrusive::member_hook<actor::ActorImpl, boost::intrusive::list_member_hook<>,
                                                        &actor::ActorImpl::kernel_destroy_list_hook>>
       actors_to_destroy_;
+  bool end_notified_ = false; // Whether on_simulation_end was fired since the last actor creation
 #if SIMGRID_HAVE_MC
   /* MCer cannot read members actor_list_ and actors_to_destroy_ above in the remote process, so we copy the info it
    * needs in a dynar.
@@ -118,9 +125,31 @@ public:
   unsigned long int get_actor_to_run_count() const { return actors_to_run_.size(); }
   size_t get_actor_count() const { return actor_list_.size(); }
   actor::ActorImpl* get_actor_by_pid(aid_t pid);
-  void add_actor(aid_t pid, actor::ActorImpl* actor) { actor_list_[pid] = actor; }
+  void add_actor(aid_t pid, actor::ActorImpl* actor)
+  {
+    actor_list_[pid] = actor;
+    end_notified_    = false;
+  }
   void remove_actor(aid_t pid) { actor_list_.erase(pid); }
   void add_split_duplex_link(const std::string& name, std::unique_ptr<resource::SplitDuplexLinkImpl> link);
+  /** @brief Gives the next dense id to a new host. The ids of the destroyed hosts are not reused. */
+  unsigned long add_host_id(s4u::Host* host)
+  {
+    hosts_by_id_.push_back(host);
+    return hosts_by_id_.size() - 1;
+  }
+  void remove_host_id(unsigned long id) { hosts_by_id_[id] = nullptr; }
+  /** @brief Gives the next dense id to a new link. The ids of the destroyed links are not reused. */
+  unsigned long add_link_id(s4u::Link* link)
+  {
+    links_by_id_.push_back(link);
+    return links_by_id_.size() - 1;
+  }
+  void remove_link_id(unsigned long id) { links_by_id_[id] = nullptr; }
+  void add_lazy_zone(routing::LazyStarZone* zone) { lazy_zones_.push_back(zone); }
+  void remove_lazy_zone(const routing::LazyStarZone* zone);
+  /** @brief Creates the host of that name if a lazy zone describes it without having created it yet */
+  s4u::Host* materialize_host(const std::string& name) const;
 
 #if SIMGRID_HAVE_MC
   xbt_dynar_t get_actors_vector() const { return actors_vector_; }
@@ -150,8 +179,8 @@ public:
   void display_all_actor_status() const;
   void run_all_actors();
 
-  /** @brief Run the main simulation loop. */
-  void run();
+  /** @brief Run the main simulation loop until the given date (or until the end if @p max_date is negative). */
+  void run(double max_date);
 };
 
 } // namespace kernel
@@ -0,0 +1,140 @@
+/* Copyright (c) 2021. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "simgrid/kernel/Profiler.hpp"
+#include "simgrid/Exception.hpp"
+#include "simgrid/kernel/resource/Model.hpp"
+#include "simgrid/s4u/Engine.hpp"
+#include "simgrid/sg_config.hpp"
+#include "src/kernel/lmm/maxmin.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+XBT_LOG_NEW_DEFAULT_SUBCATEGORY(ker_profiler, kernel, "Self-profiler of the simulation kernel");
+
+namespace simgrid {
+namespace kernel {
+
+static config::Flag<bool> cfg_profile{"debug/profile",
+                                      "Measure the wall-clock time spent in each phase of the simulation kernel", false};
+static config::Flag<std::string> cfg_profile_file{
+    "debug/profile-file", "File in which the profile is written as JSON at the end of the simulation",
+    "simgrid-profile.json"};
+
+bool Profiler::enabled_                 = false;
+Profiler::Scope* Profiler::current_scope_ = nullptr;
+
+const char* Profiler::to_c_str(Phase phase)
+{
+  switch (phase) {
+    case Phase::ACTORS:
+      return "actors";
+    case Phase::SIMCALLS:
+      return "simcalls";
+    case Phase::TASKS:
+      return "tasks";
+    case Phase::SOLVE:
+      return "solve";
+    case Phase::TIMERS:
+      return "timers";
+    case Phase::TRASH:
+      return "trash";
+    case Phase::TRACING:
+      return "tracing";
+    default:
+      THROW_IMPOSSIBLE;
+  }
+}
+
+Profiler& Profiler::get_instance()
+{
+  static Profiler instance;
+  return instance;
+}
+
+void Profiler::start()
+{
+  static bool dump_connected = false;
+  enabled_                   = cfg_profile;
+  if (enabled_ && not dump_connected) {
+    dump_connected = true;
+    s4u::Engine::on_simulation_end.connect([]() {
+      std::ofstream os(cfg_profile_file.get());
+      xbt_assert(not os.fail(), "Cannot open %s to write the profile of the simulation", cfg_profile_file.get().c_str());
+      get_instance().dump_json(os);
+      XBT_VERB("Profile of the simulation written to %s", cfg_profile_file.get().c_str());
+    });
+  }
+  if (enabled_)
+    get_instance().run_start_ = std::chrono::steady_clock::now();
+}
+
+void Profiler::stop()
+{
+  if (not enabled_)
+    return;
+  Profiler& profiler = get_instance();
+  profiler.run_.elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - profiler.run_start_).count();
+  profiler.run_.calls++;
+}
+
+ProfiledModel& Profiler::get_model(const resource::Model* model)
+{
+  auto cached = models_cache_.find(model);
+  if (cached != models_cache_.end())
+    return *cached->second;
+  ProfiledModel* res = &models_[model->get_name()];
+  models_cache_.emplace(model, res);
+  return *res;
+}
+
+void Profiler::sample(resource::Model* model)
+{
+  if (not enabled_)
+    return;
+  ProfiledModel& prof = get_instance().get_model(model);
+  prof.max_actions    = std::max(prof.max_actions, model->get_started_action_set()->size());
+  if (const lmm::System* system = model->get_maxmin_system()) {
+    prof.max_variables   = std::max(prof.max_variables, system->variable_set.size());
+    prof.max_constraints = std::max(prof.max_constraints, system->active_constraint_set.size());
+  }
+}
+
+static void dump_phase(std::ostream& os, const ProfiledPhase& phase)
+{
+  os << "{\"time\": " << phase.elapsed << ", \"calls\": " << phase.calls << "}";
+}
+
+void Profiler::dump_json(std::ostream& os) const
+{
+  os << "{\n";
+  os << "  \"wall_time\": " << run_.elapsed << ",\n";
+  os << "  \"simulated_time\": " << s4u::Engine::get_clock() << ",\n";
+  os << "  \"phases\": {";
+  for (int i = 0; i < PHASE_COUNT; i++) {
+    os << (i == 0 ? "\n" : ",\n") << "    \"" << to_c_str(static_cast<Phase>(i)) << "\": ";
+    dump_phase(os, phases_[i]);
+  }
+  os << "\n  },\n";
+  os << "  \"models\": {";
+  bool first = true;
+  for (auto const& kv : models_) {
+    os << (first ? "\n" : ",\n") << "    \"" << kv.first << "\": {\n";
+    os << "      \"solve\": ";
+    dump_phase(os, kv.second.solve);
+    os << ",\n      \"update\": ";
+    dump_phase(os, kv.second.update);
+    os << ",\n      \"max_actions\": " << kv.second.max_actions;
+    os << ",\n      \"max_lmm_variables\": " << kv.second.max_variables;
+    os << ",\n      \"max_lmm_constraints\": " << kv.second.max_constraints << "\n    }";
+    first = false;
+  }
+  os << "\n  }\n";
+  os << "}\n";
+}
+
+} // namespace kernel
+} // namespace simgrid
@@ -210,41 +210,46 @@ void Action::set_last_update()
   last_update_ = surf_get_clock();
 }
 
+void ActionHeapPosition::operator()(const heap_element_type& elem, std::size_t pos) const
+{
+  std::get<2>(elem)->heap_position_ = pos;
+}
+
 double ActionHeap::top_date() const
 {
-  return top().first;
+  return std::get<0>(top());
 }
 
 void ActionHeap::insert(Action* action, double date, ActionHeap::Type type)
 {
-  action->type_      = type;
-  action->heap_hook_ = emplace(std::make_pair(date, action));
+  action->type_ = type;
+  push(std::make_tuple(date, rank_++, action));
 }
 
 void ActionHeap::remove(Action* action)
 {
   action->type_ = ActionHeap::Type::unset;
-  if (action->heap_hook_) {
-    erase(*action->heap_hook_);
-    action->heap_hook_ = boost::none;
+  if (action->heap_position_ != Action::NOT_IN_HEAP) {
+    erase(action->heap_position_);
+    action->heap_position_ = Action::NOT_IN_HEAP;
   }
 }
 
 void ActionHeap::update(Action* action, double date, ActionHeap::Type type)
 {
   action->type_ = type;
-  if (action->heap_hook_) {
-    heap_type::update(*action->heap_hook_, std::make_pair(date, action));
+  if (action->heap_position_ != Action::NOT_IN_HEAP) {
+    heap_type::update(action->heap_position_, std::make_tuple(date, rank_++, action));
   } else {
-    action->heap_hook_ = emplace(std::make_pair(date, action));
+    push(std::make_tuple(date, rank_++, action));
   }
 }
 
 Action* ActionHeap::pop()
 {
-  Action* action = top().second;
+  Action* action = std::get<2>(top());
   heap_type::pop();
-  action->heap_hook_ = boost::none;
+  action->heap_position_ = Action::NOT_IN_HEAP;
   return action;
 }
 
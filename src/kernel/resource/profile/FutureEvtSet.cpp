@@ -4,51 +4,187 @@
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
 #include "src/kernel/resource/profile/FutureEvtSet.hpp"
+#include "simgrid/sg_config.hpp"
 #include "src/kernel/resource/profile/Event.hpp"
 #include "src/kernel/resource/profile/Profile.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 namespace simgrid {
 namespace kernel {
 namespace profile {
 
 simgrid::kernel::profile::FutureEvtSet future_evt_set; // FIXME: singleton antipattern
 
+static simgrid::config::Flag<std::string> cfg_event_set{
+    "profile/event-set",
+    "Data structure storing the future events of the resource profiles",
+    "heap",
+    {{"heap", "4-ary indexed heap: O(log n) insertions and extractions."},
+     {"calendar", "Calendar queue: O(1) amortized insertions and extractions for dense, near-periodic profiles."}},
+    [](const std::string& value) { future_evt_set.set_calendar_queue(value == "calendar"); }};
+
+/*****************
+ * CalendarQueue *
+ *****************/
+
+double CalendarQueue::day_of(double date) const
+{
+  return std::floor(date / width_);
+}
+
+size_t CalendarQueue::bucket_of(double day) const
+{
+  return static_cast<size_t>(std::fmod(day, static_cast<double>(buckets_.size())));
+}
+
+/** @brief Finds the bucket containing the next event: the first bucket of the current year with an event of that
+ * year, or the earliest event of all buckets if none is found in the coming year */
+size_t CalendarQueue::find_min() const
+{
+  if (min_bucket_ != NO_BUCKET)
+    return min_bucket_;
+
+  for (size_t i = 0; i < buckets_.size(); i++) {
+    double day         = current_day_ + static_cast<double>(i);
+    size_t bucket      = bucket_of(day);
+    auto const& events = buckets_[bucket];
+    if (not events.empty() && day_of(events.back().first) <= day) {
+      current_day_ = day;
+      min_bucket_  = bucket;
+      return bucket;
+    }
+  }
+
+  // Nothing happens in the coming year: search for the earliest event in all buckets
+  for (size_t bucket = 0; bucket < buckets_.size(); bucket++) {
+    auto const& events = buckets_[bucket];
+    if (not events.empty() && (min_bucket_ == NO_BUCKET || events.back() < buckets_[min_bucket_].back()))
+      min_bucket_ = bucket;
+  }
+  xbt_assert(min_bucket_ != NO_BUCKET, "Cannot get the next event of an empty calendar queue");
+  current_day_ = day_of(buckets_[min_bucket_].back().first);
+  return min_bucket_;
+}
+
+void CalendarQueue::push(const Qelt& elem)
+{
+  double day = day_of(elem.first);
+  if (size_ == 0 || day < current_day_)
+    current_day_ = day;
+
+  auto& events = buckets_[bucket_of(day)];
+  events.insert(std::upper_bound(events.begin(), events.end(), elem, std::greater<>()), elem);
+  size_++;
+  min_bucket_ = NO_BUCKET;
+
+  if (size_ > 2 * buckets_.size())
+    resize(2 * buckets_.size());
+}
+
+void CalendarQueue::pop()
+{
+  buckets_[find_min()].pop_back();
+  size_--;
+  min_bucket_ = NO_BUCKET;
+
+  if (buckets_.size() > 2 && size_ < buckets_.size() / 2)
+    resize(buckets_.size() / 2);
+}
+
+/** @brief Redistributes all events over the given amount of buckets, with a width computed from the separation of the
+ * earliest events */
+void CalendarQueue::resize(size_t bucket_count)
+{
+  std::vector<Qelt> events;
+  events.reserve(size_);
+  for (auto& bucket : buckets_) {
+    events.insert(events.end(), bucket.begin(), bucket.end());
+    bucket.clear();
+  }
+
+  // Estimate the average separation of the events from a sample of the earliest ones, skipping outliers
+  size_t samples = std::min<size_t>(events.size(), 25);
+  std::partial_sort(events.begin(), events.begin() + samples, events.end());
+  if (samples > 1) {
+    double average = (events[samples - 1].first - events[0].first) / static_cast<double>(samples - 1);
+    double total   = 0.0;
+    int count      = 0;
+    for (size_t i = 1; i < samples; i++) {
+      double separation = events[i].first - events[i - 1].first;
+      if (separation <= 2 * average) {
+        total += separation;
+        count++;
+      }
+    }
+    if (count > 0 && total > 0.0)
+      width_ = 3.0 * total / count;
+  }
+
+  buckets_ = std::vector<std::vector<Qelt>>(bucket_count);
+  size_    = 0;
+  for (auto const& elem : events)
+    push(elem);
+}
+
+/****************
+ * FutureEvtSet *
+ ****************/
+
 FutureEvtSet::FutureEvtSet() = default;
 FutureEvtSet::~FutureEvtSet()
 {
-  while (not heap_.empty()) {
-    delete heap_.top().second;
-    heap_.pop();
+  while (not empty()) {
+    delete top().second;
+    pop();
   }
 }
 
+void FutureEvtSet::set_calendar_queue(bool use_calendar)
+{
+  xbt_assert(empty(), "Cannot change the data structure of a non-empty future event set");
+  use_calendar_ = use_calendar;
+}
+
+void FutureEvtSet::pop()
+{
+  if (use_calendar_)
+    calendar_.pop();
+  else
+    heap_.pop();
+}
+
 /** @brief Schedules an event to a future date */
 void FutureEvtSet::add_event(double date, Event* evt)
 {
-  heap_.emplace(date, evt);
+  if (use_calendar_)
+    calendar_.push(std::make_pair(date, evt));
+  else
+    heap_.emplace(date, evt);
 }
 
 /** @brief returns the date of the next occurring event (or -1 if empty) */
 double FutureEvtSet::next_date() const
 {
-  return heap_.empty() ? -1.0 : heap_.top().first;
+  return empty() ? -1.0 : top().first;
 }
 
 /** @brief Retrieves the next occurring event, or nullptr if none happens before date */
 Event* FutureEvtSet::pop_leq(double date, double* value, resource::Resource** resource)
 {
   double event_date = next_date();
-  if (event_date > date || heap_.empty())
+  if (event_date > date || empty())
     return nullptr;
 
-  Event* event       = heap_.top().second;
+  Event* event       = top().second;
   Profile* profile   = event->profile;
   DatedValue dateVal = profile->next(event);
 
   *resource = event->resource;
   *value    = dateVal.value_;
 
-  heap_.pop();
+  pop();
 
   return event;
 }
@@ -7,12 +7,47 @@
 #define FUTUREEVTSET_HPP
 
 #include "simgrid/forward.h"
-#include <queue>
+#include <xbt/indexed_heap.hpp>
+
+#include <utility>
+#include <vector>
 
 namespace simgrid {
 namespace kernel {
 namespace profile {
 
+/** @brief Calendar queue (R. Brown, 1988) of dated events
+ *
+ * Events are hashed into buckets (the days of a year) according to their date, so that insertions and extractions take
+ * O(1) amortized time when dates are dense and evenly spread, as with many near-periodic profiles. The amount of
+ * buckets and their width are adapted to the amount of events. Events occurring at the same date are ordered as in a
+ * heap of (date, Event*) pairs.
+ */
+class XBT_PUBLIC CalendarQueue {
+public:
+  using Qelt = std::pair<double, Event*>;
+
+  bool empty() const { return size_ == 0; }
+  size_t size() const { return size_; }
+  const Qelt& top() const { return buckets_[find_min()].back(); }
+  void push(const Qelt& elem);
+  void pop();
+
+private:
+  static constexpr size_t NO_BUCKET = static_cast<size_t>(-1);
+
+  std::vector<std::vector<Qelt>> buckets_ = std::vector<std::vector<Qelt>>(2); // Each bucket is sorted by decreasing date
+  double width_  = 1.0;
+  size_t size_   = 0;
+  mutable double current_day_   = 0.0;       // Day of the last extracted event, where the search for the next one starts
+  mutable size_t min_bucket_    = NO_BUCKET; // Cached position of the next event
+
+  double day_of(double date) const;
+  size_t bucket_of(double day) const;
+  size_t find_min() const;
+  void resize(size_t bucket_count);
+};
+
 /** @brief Future Event Set (collection of iterators over the traces)
  * That's useful to quickly know which is the next occurring event in a set of traces. */
 class XBT_PUBLIC FutureEvtSet {
@@ -22,12 +57,22 @@ public:
   FutureEvtSet& operator=(const FutureEvtSet&) = delete;
   virtual ~FutureEvtSet();
   double next_date() const;
+  /** @brief Number of pending events */
+  size_t size() const { return use_calendar_ ? calendar_.size() : heap_.size(); }
   Event* pop_leq(double date, double* value, resource::Resource** resource);
   void add_event(double date, Event* evt);
+  /** @brief Selects whether the events are stored in a calendar queue instead of a heap (only when empty) */
+  void set_calendar_queue(bool use_calendar);
 
 private:
   using Qelt = std::pair<double, Event*>;
-  std::priority_queue<Qelt, std::vector<Qelt>, std::greater<>> heap_;
+  xbt::IndexedHeap<Qelt> heap_;
+  CalendarQueue calendar_;
+  bool use_calendar_ = false;
+
+  bool empty() const { return use_calendar_ ? calendar_.empty() : heap_.empty(); }
+  const Qelt& top() const { return use_calendar_ ? calendar_.top() : heap_.top(); }
+  void pop();
 };
 
 // FIXME: kill that singleton
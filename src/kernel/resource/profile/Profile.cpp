@@ -98,6 +98,7 @@ Profile* Profile::from_string(const std::string& name, const std::string& input,
   simgrid::kernel::profile::DatedValue* last_event = &(profile->event_list.back());
 
   xbt_assert(trace_list.find(name) == trace_list.end(), "Refusing to define trace %s twice", name.c_str());
+  profile->name_ = name;
 
   std::vector<std::string> list;
   boost::split(list, input, boost::is_any_of("\n\r"));
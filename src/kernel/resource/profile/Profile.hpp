@@ -12,6 +12,7 @@
 #include "src/kernel/resource/profile/StochasticDatedValue.hpp"
 
 #include <queue>
+#include <string>
 #include <vector>
 
 namespace simgrid {
@@ -34,6 +35,8 @@ public:
 
   const std::vector<DatedValue>& get_event_list() const { return event_list; }
   const std::vector<StochasticDatedValue>& get_stochastic_event_list() const { return stochastic_event_list; }
+  /** @brief The name of that profile: the path of its file, or the name given to from_string() */
+  const std::string& get_name() const { return name_; }
 
   static Profile* from_file(const std::string& path);
   static Profile* from_string(const std::string& name, const std::string& input, double periodicity);
@@ -42,6 +45,7 @@ private:
   std::vector<DatedValue> event_list;
   std::vector<StochasticDatedValue> stochastic_event_list;
 
+  std::string name_;
   FutureEvtSet* fes_  = nullptr;
   bool stochastic     = false;
   bool stochasticloop = false;
@@ -8,6 +8,7 @@
 #include "simgrid/kernel/resource/Resource.hpp"
 #include "src/kernel/resource/profile/DatedValue.hpp"
 #include "src/kernel/resource/profile/Event.hpp"
+#include "src/kernel/resource/profile/FutureEvtSet.hpp"
 #include "src/kernel/resource/profile/Profile.hpp"
 #include "src/kernel/resource/profile/StochasticDatedValue.hpp"
 #include "src/surf/surf_interface.hpp"
@@ -17,6 +18,7 @@
 #include "xbt/random.hpp"
 
 #include <cmath>
+#include <random>
 
 XBT_LOG_NEW_DEFAULT_CATEGORY(unit, "Unit tests of the Trace Manager");
 
@@ -35,7 +37,7 @@ public:
 
 double MockedResource::the_date;
 
-static std::vector<simgrid::kernel::profile::DatedValue> trace2vector(const char* str)
+static std::vector<simgrid::kernel::profile::DatedValue> trace2vector(const char* str, bool calendar = false)
 {
   std::vector<simgrid::kernel::profile::DatedValue> res;
   simgrid::kernel::profile::Profile* trace = simgrid::kernel::profile::Profile::from_string("TheName", str, 0);
@@ -46,6 +48,7 @@ static std::vector<simgrid::kernel::profile::DatedValue> trace2vector(const char
 
   MockedResource daResource;
   simgrid::kernel::profile::FutureEvtSet fes;
+  fes.set_calendar_queue(calendar);
   simgrid::kernel::profile::Event* insertedIt = trace->schedule(&fes, &daResource);
 
   while (fes.next_date() <= 20.0 && fes.next_date() >= 0) {
@@ -223,3 +226,53 @@ TEST_CASE("kernel::profile: Resource profiles, defining the external load", "ker
     REQUIRE(want == got);
   }
 }
+
+TEST_CASE("kernel::profile: Calendar queue of future events", "kernel::profile")
+{
+  SECTION("Same profiles as with the heap")
+  {
+    for (const char* str : {"9.0 3.0\n", "3.0 1.0\n5.0 2.0\n9.0 3.0\n", "1.0 1.0\n3.0 3.0\nLOOPAFTER 2\n",
+                            "0.0 1\n5.0 2\nLOOPAFTER 5\n", "0.0 1\n0.1 2\n0.3 3\n1.7 4\nLOOPAFTER 0.2\n"}) {
+      INFO("Profile: " << str);
+      REQUIRE(trace2vector(str, true) == trace2vector(str, false));
+    }
+  }
+
+  SECTION("Same event order as a heap, with interleaved insertions and extractions")
+  {
+    using Qelt = std::pair<double, simgrid::kernel::profile::Event*>;
+    simgrid::kernel::profile::CalendarQueue calendar;
+    simgrid::xbt::IndexedHeap<Qelt> heap;
+    std::vector<simgrid::kernel::profile::Event> events(100);
+    std::mt19937 gen(4242);
+    std::uniform_int_distribution<size_t> pick(0, events.size() - 1);
+    std::uniform_real_distribution<double> delay(0.0, 10.0);
+
+    /* Start with a burst of events, then reinsert each extracted event in the future, as profiles do */
+    for (int i = 0; i < 2000; i++) {
+      Qelt elem(delay(gen) * 100, &events[pick(gen)]);
+      calendar.push(elem);
+      heap.push(elem);
+    }
+    for (int i = 0; i < 20000; i++) {
+      REQUIRE(calendar.size() == heap.size());
+      REQUIRE(calendar.top() == heap.top());
+      double now = heap.top().first;
+      calendar.pop();
+      heap.pop();
+      if (i % 3 != 0) {
+        Qelt elem(now + (i % 7 == 0 ? 0.0 : delay(gen)), &events[pick(gen)]);
+        calendar.push(elem);
+        heap.push(elem);
+      }
+      if (heap.empty())
+        break;
+    }
+    while (not heap.empty()) {
+      REQUIRE(calendar.top() == heap.top());
+      calendar.pop();
+      heap.pop();
+    }
+    REQUIRE(calendar.empty());
+  }
+}
@@ -5,25 +5,38 @@
 
 #include "simgrid/kernel/routing/DijkstraZone.hpp"
 #include "simgrid/kernel/routing/NetPoint.hpp"
+#include "src/include/simgrid/sg_config.hpp"
 #include "src/surf/network_interface.hpp"
 #include "surf/surf.hpp"
+#include "xbt/indexed_heap.hpp"
 #include "xbt/string.hpp"
 
+#include <atomic>
 #include <climits>
-#include <queue>
+#include <cstdint>
+#include <thread>
 #include <vector>
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(surf_route_dijkstra, surf, "Routing part of surf -- dijkstra routing logic");
 
+static simgrid::config::Flag<int> cfg_dijkstra_precompute{
+    "network/dijkstra-precompute",
+    "Amount of threads computing all the routes of the DijkstraCache zones when they get sealed (0 to compute them on "
+    "need)",
+    0, [](int val) { xbt_assert(val >= 0, "network/dijkstra-precompute must be non-negative"); }};
+
 namespace simgrid {
 namespace kernel {
 namespace routing {
 
+constexpr unsigned int NO_NODE = UINT_MAX; // Netpoint that is not in the graph
+constexpr unsigned int NO_EDGE = UINT_MAX; // Node that cannot be reached (or source node) in a shortest path tree
+
 class GraphNodeData {
 public:
   explicit GraphNodeData(int id) : id_(id) {}
   int id_;
-  unsigned long graph_id_ = UINT_MAX; /* used for caching internal graph id's */
+  unsigned int graph_id_ = NO_NODE; /* used for caching internal graph id's */
 };
 
 void DijkstraZone::route_graph_delete(xbt_graph_t g)
@@ -59,13 +72,108 @@ void DijkstraZone::do_seal()
     }
   }
 
-  /* initialize graph indexes in nodes after graph has been built */
+  build_csr();
+
+  if (cached_ && cfg_dijkstra_precompute > 0)
+    precompute_routes(cfg_dijkstra_precompute);
+}
+
+/* Copy the graph into the CSR arrays. This also drops the cached routes, that may be outdated */
+void DijkstraZone::build_csr()
+{
   const_xbt_dynar_t nodes = xbt_graph_get_nodes(route_graph_.get());
+  unsigned int cursor;
+  xbt_node_t node = nullptr;
 
+  /* initialize graph indexes in nodes after graph has been built */
+  node_of_netpoint_.clear();
   xbt_dynar_foreach (nodes, cursor, node) {
     auto* data      = static_cast<GraphNodeData*>(xbt_graph_node_get_data(node));
     data->graph_id_ = cursor;
+    if (node_of_netpoint_.size() <= static_cast<unsigned>(data->id_))
+      node_of_netpoint_.resize(data->id_ + 1, NO_NODE);
+    node_of_netpoint_[data->id_] = cursor;
+  }
+
+  out_begin_.clear();
+  edges_.clear();
+  xbt_dynar_foreach (nodes, cursor, node) {
+    out_begin_.push_back(edges_.size());
+    xbt_edge_t edge = nullptr;
+    unsigned int cursor2;
+    xbt_dynar_foreach (xbt_graph_node_get_outedges(node), cursor2, edge) {
+      const auto* data    = static_cast<GraphNodeData*>(xbt_graph_node_get_data(xbt_graph_edge_get_target(edge)));
+      const auto* e_route = static_cast<Route*>(xbt_graph_edge_get_data(edge));
+      edges_.push_back({cursor, data->graph_id_, e_route->link_list_.size(), e_route});
+    }
   }
+  out_begin_.push_back(edges_.size());
+
+  route_cache_.clear();
+  route_cache_.resize(cached_ ? xbt_dynar_length(nodes) : 0);
+  csr_valid_ = true;
+}
+
+/* Compute the shortest path tree from that node. Among the paths of same cost, the one found first when the nodes are
+ * visited by increasing cost and then by increasing index is kept, so that the routes do not depend on the cache. */
+void DijkstraZone::compute_pred_edges(unsigned int src_node, std::vector<unsigned int>& pred_edges) const
+{
+  using Qelt = std::pair<unsigned long, unsigned int>; // (cost from src, node)
+  constexpr size_t NOT_IN_HEAP = SIZE_MAX;
+  class HeapPosition {
+    std::vector<size_t>* positions_;
+
+  public:
+    explicit HeapPosition(std::vector<size_t>* positions) : positions_(positions) {}
+    void operator()(const Qelt& elem, size_t pos) const { (*positions_)[elem.second] = pos; }
+  };
+
+  size_t nr_nodes = out_begin_.size() - 1;
+  std::vector<unsigned long> cost_arr(nr_nodes, ULONG_MAX); /* link cost from src to other hosts */
+  std::vector<size_t> heap_pos(nr_nodes, NOT_IN_HEAP);
+  pred_edges.assign(nr_nodes, NO_EDGE);
+
+  xbt::IndexedHeap<Qelt, std::less<Qelt>, HeapPosition> pqueue{std::less<Qelt>(), HeapPosition(&heap_pos)};
+  cost_arr[src_node] = 0;
+  pqueue.emplace(0, src_node);
+
+  while (not pqueue.empty()) {
+    unsigned int v_id = pqueue.top().second;
+    pqueue.pop();
+    heap_pos[v_id] = NOT_IN_HEAP;
+
+    for (unsigned int e = out_begin_[v_id]; e < out_begin_[v_id + 1]; e++) {
+      const Edge& edge   = edges_[e];
+      unsigned long cost = cost_arr[v_id] + edge.cost;
+      if (cost < cost_arr[edge.dst]) {
+        pred_edges[edge.dst] = e;
+        cost_arr[edge.dst]   = cost;
+        if (heap_pos[edge.dst] == NOT_IN_HEAP)
+          pqueue.emplace(cost, edge.dst);
+        else
+          pqueue.update(heap_pos[edge.dst], Qelt(cost, edge.dst));
+      }
+    }
+  }
+}
+
+/* Fill the whole cache. Each thread takes the next source to compute, and only writes the cache entry of that source */
+void DijkstraZone::precompute_routes(int nthreads)
+{
+  XBT_DEBUG("Precompute the routes from the %zu nodes of %s with %d threads", route_cache_.size(), get_cname(),
+            nthreads);
+  std::atomic<unsigned int> next_src{0};
+  auto worker = [this, &next_src]() {
+    for (unsigned int src = next_src++; src < route_cache_.size(); src = next_src++)
+      compute_pred_edges(src, route_cache_[src]);
+  };
+
+  std::vector<std::thread> threads;
+  for (int i = 1; i < nthreads; i++)
+    threads.emplace_back(worker);
+  worker();
+  for (auto& thread : threads)
+    thread.join();
 }
 
 xbt_node_t DijkstraZone::route_graph_new_node(int id)
@@ -87,93 +195,42 @@ xbt_node_t DijkstraZone::node_map_search(int id)
 void DijkstraZone::get_local_route(const NetPoint* src, const NetPoint* dst, Route* route, double* lat)
 {
   get_route_check_params(src, dst);
-  int src_id = src->id();
-  int dst_id = dst->id();
-
-  const_xbt_dynar_t nodes = xbt_graph_get_nodes(route_graph_.get());
-
-  /* Use the graph_node id mapping set to quickly find the nodes */
-  const s_xbt_node_t* src_elm = node_map_search(src_id);
-  const s_xbt_node_t* dst_elm = node_map_search(dst_id);
+  if (not csr_valid_)
+    build_csr();
 
-  unsigned long src_node_id = static_cast<GraphNodeData*>(xbt_graph_node_get_data(src_elm))->graph_id_;
-  unsigned long dst_node_id = static_cast<GraphNodeData*>(xbt_graph_node_get_data(dst_elm))->graph_id_;
+  /* Use the netpoint id mapping to quickly find the nodes */
+  unsigned int src_node_id = src->id() < node_of_netpoint_.size() ? node_of_netpoint_[src->id()] : NO_NODE;
+  unsigned int dst_node_id = dst->id() < node_of_netpoint_.size() ? node_of_netpoint_[dst->id()] : NO_NODE;
+  if (src_node_id == NO_NODE || dst_node_id == NO_NODE)
+    throw std::invalid_argument(xbt::string_printf("No route from '%s' to '%s'", src->get_cname(), dst->get_cname()));
 
   /* if the src and dst are the same */
   if (src_node_id == dst_node_id) {
-    const s_xbt_node_t* node_s_v = xbt_dynar_get_as(nodes, src_node_id, xbt_node_t);
-    const s_xbt_node_t* node_e_v = xbt_dynar_get_as(nodes, dst_node_id, xbt_node_t);
-    const s_xbt_edge_t* edge     = xbt_graph_get_edge(route_graph_.get(), node_s_v, node_e_v);
+    const Edge* loopback = nullptr;
+    for (unsigned int e = out_begin_[src_node_id]; e < out_begin_[src_node_id + 1] && loopback == nullptr; e++)
+      if (edges_[e].dst == src_node_id)
+        loopback = &edges_[e];
 
-    if (edge == nullptr)
+    if (loopback == nullptr)
       throw std::invalid_argument(xbt::string_printf("No route from '%s' to '%s'", src->get_cname(), dst->get_cname()));
 
-    const Route* e_route = static_cast<Route*>(xbt_graph_edge_get_data(edge));
-
-    insert_link_latency(route->link_list_, e_route->link_list_, lat);
-  }
-
-  auto elm                             = route_cache_.emplace(src_id, std::vector<unsigned long>());
-  std::vector<unsigned long>& pred_arr = elm.first->second;
-
-  if (elm.second) { /* new element was inserted (not cached mode, or cache miss) */
-    unsigned long nr_nodes = xbt_dynar_length(nodes);
-    std::vector<unsigned long> cost_arr(nr_nodes); /* link cost from src to other hosts */
-    pred_arr.resize(nr_nodes);              /* predecessors in path from src */
-    using Qelt = std::pair<double, unsigned long>;
-    std::priority_queue<Qelt, std::vector<Qelt>, std::greater<>> pqueue;
-
-    /* initialize */
-    cost_arr[src_node_id] = 0;
-
-    for (unsigned long i = 0; i < nr_nodes; i++) {
-      if (i != src_node_id) {
-        cost_arr[i] = ULONG_MAX;
-      }
-
-      pred_arr[i] = 0;
-
-      /* initialize priority queue */
-      pqueue.emplace(cost_arr[i], i);
-    }
-
-    /* apply dijkstra using the indexes from the graph's node array */
-    while (not pqueue.empty()) {
-      unsigned long v_id = pqueue.top().second;
-      pqueue.pop();
-      const s_xbt_node_t* v_node = xbt_dynar_get_as(nodes, v_id, xbt_node_t);
-      xbt_edge_t edge            = nullptr;
-      unsigned int cursor;
-
-      xbt_dynar_foreach (xbt_graph_node_get_outedges(v_node), cursor, edge) {
-        const s_xbt_node_t* u_node           = xbt_graph_edge_get_target(edge);
-        const GraphNodeData* data            = static_cast<GraphNodeData*>(xbt_graph_node_get_data(u_node));
-        unsigned long u_id                   = data->graph_id_;
-        const Route* tmp_e_route             = static_cast<Route*>(xbt_graph_edge_get_data(edge));
-        unsigned long cost_v_u               = tmp_e_route->link_list_.size(); /* count of links, old model assume 1 */
-
-        if (cost_v_u + cost_arr[v_id] < cost_arr[u_id]) {
-          pred_arr[u_id] = v_id;
-          cost_arr[u_id] = cost_v_u + cost_arr[v_id];
-          pqueue.emplace(cost_arr[u_id], u_id);
-        }
-      }
-    }
+    insert_link_latency(route->link_list_, loopback->route->link_list_, lat);
+  } else if (not cached_) {
+    compute_pred_edges(src_node_id, pred_scratch_);
+  } else if (route_cache_[src_node_id].empty()) { /* cache miss */
+    compute_pred_edges(src_node_id, route_cache_[src_node_id]);
   }
+  const std::vector<unsigned int>& pred_edges = cached_ ? route_cache_[src_node_id] : pred_scratch_;
 
   /* compose route path with links */
   NetPoint* gw_src   = nullptr;
   NetPoint* first_gw = nullptr;
 
-  for (unsigned long v = dst_node_id; v != src_node_id; v = pred_arr[v]) {
-    const s_xbt_node_t* node_pred_v = xbt_dynar_get_as(nodes, pred_arr[v], xbt_node_t);
-    const s_xbt_node_t* node_v      = xbt_dynar_get_as(nodes, v, xbt_node_t);
-    const s_xbt_edge_t* edge        = xbt_graph_get_edge(route_graph_.get(), node_pred_v, node_v);
-
-    if (edge == nullptr)
+  for (unsigned int v = dst_node_id; v != src_node_id; v = edges_[pred_edges[v]].src) {
+    if (pred_edges[v] == NO_EDGE)
       throw std::invalid_argument(xbt::string_printf("No route from '%s' to '%s'", src->get_cname(), dst->get_cname()));
 
-    const Route* e_route = static_cast<Route*>(xbt_graph_edge_get_data(edge));
+    const Route* e_route = edges_[pred_edges[v]].route;
 
     const NetPoint* prev_gw_src = gw_src;
     gw_src                      = e_route->gw_src_;
@@ -200,9 +257,6 @@ void DijkstraZone::get_local_route(const NetPoint* src, const NetPoint* dst, Rou
     route->gw_src_ = gw_src;
     route->gw_dst_ = first_gw;
   }
-
-  if (not cached_)
-    route_cache_.clear();
 }
 
 void DijkstraZone::add_route(NetPoint* src, NetPoint* dst, NetPoint* gw_src, NetPoint* gw_dst,
@@ -244,6 +298,7 @@ void DijkstraZone::new_edge(int src_id, int dst_id, Route* route)
 
   // Finally add it
   xbt_graph_new_edge(route_graph_.get(), src, dst, route);
+  csr_valid_ = false;
 }
 } // namespace routing
 } // namespace kernel
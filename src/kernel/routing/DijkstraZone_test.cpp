@@ -34,3 +34,73 @@ TEST_CASE("kernel::routing::DijkstraZone: mix new routes and hosts", "")
                                     {simgrid::s4u::LinkInRoute(link)}, true));
   }
 }
+
+TEST_CASE("kernel::routing::DijkstraZone: routes do not depend on the cache", "")
+{
+  simgrid::s4u::Engine e("test");
+  auto* root = simgrid::s4u::create_full_zone("root");
+  using Ring = std::pair<simgrid::kernel::routing::DijkstraZone*, std::vector<const simgrid::s4u::Host*>>;
+
+  /* A ring of 8 hosts, where both directions are equally long between opposite hosts, with a shortcut from h1 to h6
+   * and an isolated host h8 that can only be reached from h0 */
+  auto create_ring = [root](const std::string& name, bool cached) {
+    auto* zone = simgrid::s4u::create_dijkstra_zone(name, cached);
+    zone->set_parent(root);
+    std::vector<const simgrid::s4u::Host*> hosts;
+    for (int i = 0; i < 9; i++)
+      hosts.push_back(zone->create_host(name + "-h" + std::to_string(i), 1e9)->seal());
+    auto add_route = [zone, &hosts, &name](int src, int dst, const std::string& link_name, bool symmetrical) {
+      const simgrid::s4u::Link* link = zone->create_link(name + "-" + link_name, 1e6)->seal();
+      zone->add_route(hosts[src]->get_netpoint(), hosts[dst]->get_netpoint(), nullptr, nullptr,
+                      {simgrid::s4u::LinkInRoute(link)}, symmetrical);
+    };
+    for (int i = 0; i < 8; i++)
+      add_route(i, (i + 1) % 8, "l" + std::to_string(i), true);
+    add_route(1, 6, "shortcut", false);
+    add_route(0, 8, "l8", false);
+    zone->seal();
+    return Ring(static_cast<simgrid::kernel::routing::DijkstraZone*>(zone->get_impl()), hosts);
+  };
+  auto get_route = [](const Ring& ring, int src, int dst) {
+    simgrid::kernel::routing::Route route;
+    double lat = 0.0;
+    ring.first->get_local_route(ring.second[src]->get_netpoint(), ring.second[dst]->get_netpoint(), &route, &lat);
+    std::vector<std::string> names;
+    for (auto const* link : route.link_list_)
+      names.push_back(link->get_name().substr(link->get_name().find('-') + 1));
+    return names;
+  };
+
+  auto regular = create_ring("regular", false);
+  auto cached  = create_ring("cached", true);
+  simgrid::s4u::Engine::set_config("network/dijkstra-precompute:2");
+  auto precomputed = create_ring("precomputed", true);
+  simgrid::s4u::Engine::set_config("network/dijkstra-precompute:0");
+
+  SECTION("Shortest routes")
+  {
+    REQUIRE(get_route(regular, 0, 3) == std::vector<std::string>{"l0", "l1", "l2"});
+    REQUIRE(get_route(regular, 1, 6) == std::vector<std::string>{"shortcut"});
+    REQUIRE(get_route(regular, 6, 1) == std::vector<std::string>{"l6", "l7", "l0"});
+    REQUIRE(get_route(regular, 0, 8) == std::vector<std::string>{"l8"});
+    REQUIRE(get_route(regular, 0, 4) == std::vector<std::string>{"l0", "l1", "l2", "l3"});
+  }
+
+  SECTION("Ties are broken the same way in all modes")
+  {
+    for (int src = 0; src < 8; src++)
+      for (int dst = 0; dst < 9; dst++) {
+        INFO("Route from h" << src << " to h" << dst);
+        auto route = get_route(regular, src, dst);
+        REQUIRE(get_route(cached, src, dst) == route);
+        REQUIRE(get_route(precomputed, src, dst) == route);
+      }
+  }
+
+  SECTION("Unreachable hosts")
+  {
+    REQUIRE_THROWS_AS(get_route(regular, 8, 0), std::invalid_argument);
+    REQUIRE_THROWS_AS(get_route(cached, 8, 0), std::invalid_argument);
+    REQUIRE_THROWS_AS(get_route(precomputed, 8, 0), std::invalid_argument);
+  }
+}
@@ -123,6 +123,33 @@ void FloydZone::add_route(NetPoint* src, NetPoint* dst, NetPoint* gw_src, NetPoi
   }
 }
 
+/** @brief Uses the predecessor table given by set_precomputed_predecessors(), if every hop it contains is a route of
+ * this zone */
+bool FloydZone::use_precomputed_predecessors()
+{
+  std::vector<std::vector<int>> table = std::move(precomputed_predecessors_);
+  precomputed_predecessors_.clear();
+  if (table.empty())
+    return false;
+
+  auto table_size = static_cast<int>(link_table_.size());
+  bool valid      = table.size() == link_table_.size();
+  for (int a = 0; valid && a < table_size; a++) {
+    valid = table[a].size() == link_table_.size();
+    for (int b = 0; valid && b < table_size; b++) {
+      int pred = table[a][b];
+      valid    = pred == -1 || (pred >= 0 && pred < table_size && link_table_[pred][b] != nullptr);
+    }
+  }
+  if (not valid) {
+    XBT_WARN("Ignoring the precomputed routes of zone %s, that do not match its current routes", get_cname());
+    return false;
+  }
+  XBT_DEBUG("Using the precomputed routes of zone %s", get_cname());
+  predecessor_table_ = std::move(table);
+  return true;
+}
+
 void FloydZone::do_seal()
 {
   /* set the size of table routing */
@@ -141,6 +168,9 @@ void FloydZone::do_seal()
       }
     }
   }
+  if (use_precomputed_predecessors())
+    return;
+
   /* Calculate path costs */
   for (unsigned int c = 0; c < table_size; c++) {
     for (unsigned int a = 0; a < table_size; a++) {
@@ -6,9 +6,14 @@
 #include "simgrid/kernel/routing/StarZone.hpp"
 #include "simgrid/kernel/routing/NetPoint.hpp"
 #include "simgrid/kernel/routing/RoutedZone.hpp"
+#include "src/kernel/EngineImpl.hpp"
 #include "src/surf/network_interface.hpp"
 #include "xbt/string.hpp"
 
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(surf_route_star, surf, "Routing part of surf");
 
 namespace simgrid {
@@ -178,6 +183,71 @@ void StarZone::do_seal()
   }
 }
 
+LazyStarZone::LazyStarZone(const std::string& name, const std::string& prefix, const std::string& suffix,
+                           const std::vector<int>& radicals)
+    : StarZone(name), prefix_(prefix), suffix_(suffix)
+{
+  for (int radical : radicals) {
+    if (not radical_ranges_.empty() && radical_ranges_.back().second + 1 == radical)
+      radical_ranges_.back().second = radical;
+    else
+      radical_ranges_.emplace_back(radical, radical);
+  }
+  EngineImpl::get_instance()->add_lazy_zone(this);
+}
+
+LazyStarZone::~LazyStarZone()
+{
+  EngineImpl::get_instance()->remove_lazy_zone(this);
+}
+
+bool LazyStarZone::has_radical(int radical) const
+{
+  return std::any_of(radical_ranges_.begin(), radical_ranges_.end(),
+                     [radical](const std::pair<int, int>& range) {
+                       return range.first <= radical && radical <= range.second;
+                     });
+}
+
+unsigned long LazyStarZone::get_member_count() const
+{
+  unsigned long count = 0;
+  for (auto const& range : radical_ranges_)
+    count += static_cast<unsigned long>(range.second - range.first) + 1;
+  return count;
+}
+
+s4u::Host* LazyStarZone::materialize(const std::string& name)
+{
+  if (name.size() <= prefix_.size() + suffix_.size() || name.compare(0, prefix_.size(), prefix_) != 0 ||
+      name.compare(name.size() - suffix_.size(), suffix_.size(), suffix_) != 0)
+    return nullptr;
+
+  /* Only accept the radicals written as std::to_string() does when creating the names (no sign, no leading 0) */
+  std::string radical_str = name.substr(prefix_.size(), name.size() - prefix_.size() - suffix_.size());
+  long radical            = std::strtol(radical_str.c_str(), nullptr, 10);
+  if (radical < INT_MIN || radical > INT_MAX || std::to_string(radical) != radical_str)
+    return nullptr;
+
+  /* Mark the host before creating it, since its creation looks its name up to reject duplicates */
+  if (not has_radical(static_cast<int>(radical)) || not materialized_.insert(static_cast<int>(radical)).second)
+    return nullptr;
+
+  XBT_DEBUG("Materializing the host %s of zone %s", name.c_str(), get_cname());
+  xbt_assert(materialize_cb_, "No materialization callback set for the lazy zone %s", get_cname());
+  s4u::Host* host = nullptr;
+  try {
+    host = materialize_cb_(static_cast<int>(radical));
+  } catch (...) {
+    /* Unmark the host so that its creation is attempted again on the next lookup */
+    materialized_.erase(static_cast<int>(radical));
+    throw;
+  }
+  if (host == nullptr)
+    materialized_.erase(static_cast<int>(radical));
+  return host;
+}
+
 } // namespace routing
 } // namespace kernel
 
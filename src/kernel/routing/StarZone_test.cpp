@@ -291,3 +291,73 @@ TEST_CASE("kernel::routing::StarZone: mix new routes and hosts", "")
         zone->add_route(cpu->get_netpoint(), nullptr, nullptr, nullptr, {simgrid::s4u::LinkInRoute(link)}, true));
   }
 }
+
+TEST_CASE("kernel::routing::LazyStarZone: hosts created on demand", "")
+{
+  simgrid::s4u::Engine e("test");
+  auto* zone = new simgrid::kernel::routing::LazyStarZone("test", "node-", ".me", {0, 1, 2, 5, 6});
+  const simgrid::s4u::Link* link = zone->create_link("my_link", {1e6})->seal();
+  int created                    = 0;
+  zone->set_materialize_cb([zone, link, &created](int radical) {
+    created++;
+    auto* host = zone->create_host("node-" + std::to_string(radical) + ".me", {1e9})->seal();
+    zone->add_route(host->get_netpoint(), nullptr, nullptr, nullptr, {simgrid::s4u::LinkInRoute(link)}, true);
+    return host;
+  });
+  zone->seal();
+
+  REQUIRE(zone->get_member_count() == 5);
+  REQUIRE(e.get_host_count() == 0);
+
+  SECTION("Look up hosts")
+  {
+    const simgrid::s4u::Host* host = simgrid::s4u::Host::by_name_or_null("node-5.me");
+    REQUIRE(host != nullptr);
+    REQUIRE(host->get_name() == "node-5.me");
+    REQUIRE(simgrid::s4u::Host::by_name("node-5.me") == host);
+    REQUIRE(e.netpoint_by_name_or_null("node-1.me") != nullptr);
+    REQUIRE(e.get_host_count() == 2);
+    REQUIRE(created == 2);
+  }
+
+  SECTION("Reject the names out of the zone")
+  {
+    REQUIRE(simgrid::s4u::Host::by_name_or_null("node-3.me") == nullptr);
+    REQUIRE(simgrid::s4u::Host::by_name_or_null("node-05.me") == nullptr);
+    REQUIRE(simgrid::s4u::Host::by_name_or_null("node-+5.me") == nullptr);
+    REQUIRE(simgrid::s4u::Host::by_name_or_null("node-.me") == nullptr);
+    REQUIRE(simgrid::s4u::Host::by_name_or_null("node-5") == nullptr);
+    REQUIRE(simgrid::s4u::Host::by_name_or_null("host-5.me") == nullptr);
+    REQUIRE_THROWS_AS(simgrid::s4u::Host::by_name("node-7.me"), std::invalid_argument);
+    REQUIRE(created == 0);
+  }
+
+  SECTION("Route between created hosts")
+  {
+    const simgrid::s4u::Host* host1 = simgrid::s4u::Host::by_name("node-0.me");
+    const simgrid::s4u::Host* host2 = simgrid::s4u::Host::by_name("node-6.me");
+    double lat                      = 0.0;
+    simgrid::kernel::routing::Route route;
+    zone->get_local_route(host1->get_netpoint(), host2->get_netpoint(), &route, &lat);
+    REQUIRE(route.link_list_.size() == 1);
+    REQUIRE(route.link_list_[0]->get_name() == "my_link");
+  }
+}
+
+TEST_CASE("kernel::routing::LazyStarZone: failed creations are retried", "")
+{
+  simgrid::s4u::Engine e("test");
+  auto* zone = new simgrid::kernel::routing::LazyStarZone("test", "node-", "", {1, 2});
+  bool fail  = true;
+  zone->set_materialize_cb([zone, &fail](int radical) {
+    if (fail)
+      throw std::runtime_error("Cannot create this host yet");
+    return zone->create_host("node-" + std::to_string(radical), {1e9})->seal();
+  });
+  zone->seal();
+
+  REQUIRE_THROWS_AS(simgrid::s4u::Host::by_name_or_null("node-2"), std::runtime_error);
+  fail = false;
+  REQUIRE(simgrid::s4u::Host::by_name_or_null("node-2") != nullptr);
+  REQUIRE(e.get_host_count() == 1);
+}
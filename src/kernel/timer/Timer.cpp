@@ -12,17 +12,23 @@ namespace simgrid {
 namespace kernel {
 namespace timer {
 
+void TimerPosition::operator()(const TimerQelt& elem, std::size_t pos) const
+{
+  std::get<2>(elem)->heap_position_ = pos;
+}
+
 Timer* Timer::set(double date, xbt::Task<void()>&& callback)
 {
-  auto* timer    = new Timer(date, std::move(callback));
-  timer->handle_ = kernel_timers().emplace(std::make_pair(date, timer));
+  static unsigned long long rank = 0;
+  auto* timer = new Timer(date, std::move(callback));
+  kernel_timers().push(std::make_tuple(date, rank++, timer));
   return timer;
 }
 
 /** @brief cancels a timer that was added earlier */
 void Timer::remove()
 {
-  kernel_timers().erase(handle_);
+  kernel_timers().erase(heap_position_);
   delete this;
 }
 
@@ -30,10 +36,10 @@ void Timer::remove()
 bool Timer::execute_all()
 {
   bool result = false;
-  while (not kernel_timers().empty() && s4u::Engine::get_clock() >= kernel_timers().top().first) {
+  while (not kernel_timers().empty() && s4u::Engine::get_clock() >= std::get<0>(kernel_timers().top())) {
     result = true;
     // FIXME: make the timers being real callbacks (i.e. provide dispatchers that read and expand the args)
-    Timer* timer = kernel_timers().top().second;
+    Timer* timer = std::get<2>(kernel_timers().top());
     kernel_timers().pop();
     timer->callback();
     delete timer;
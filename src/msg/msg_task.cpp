@@ -103,8 +103,8 @@ msg_error_t Task::execute()
 s4u::CommPtr Task::send_async(const std::string& alias, void_f_pvoid_t cleanup, bool detached)
 {
   if (TRACE_actor_is_enabled()) {
-    auto* process_container       = instr::Container::by_name(instr_pid(*MSG_process_self()));
-    std::string key               = std::string("p") + std::to_string(get_id());
+    auto* process_container = MSG_process_self()->extension<instr::ActorContainerExt>()->container;
+    std::string key         = std::string("p") + std::to_string(get_id());
     instr::Container::get_root()->get_link("ACTOR_LINK")->start_event(process_container, "SR", key);
   }
 
@@ -573,7 +573,7 @@ msg_error_t MSG_task_receive_with_timeout_bounded(msg_task_t* task, const char*
   }
 
   if (TRACE_actor_is_enabled() && ret != MSG_HOST_FAILURE && ret != MSG_TRANSFER_FAILURE && ret != MSG_TIMEOUT) {
-    auto* process_container = simgrid::instr::Container::by_name(instr_pid(*MSG_process_self()));
+    auto* process_container = MSG_process_self()->extension<simgrid::instr::ActorContainerExt>()->container;
 
     std::string key = std::string("p") + std::to_string((*task)->get_id());
     simgrid::instr::Container::get_root()->get_link("ACTOR_LINK")->end_event(process_container, "SR", key);
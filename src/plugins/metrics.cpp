@@ -0,0 +1,222 @@
+/* Copyright (c) 2021. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "simgrid/plugins/metrics.h"
+#include "simgrid/kernel/Timer.hpp"
+#include "simgrid/s4u/Engine.hpp"
+#include "simgrid/sg_config.hpp"
+#include "src/kernel/EngineImpl.hpp"
+#include "src/kernel/lmm/maxmin.hpp"
+#include "src/kernel/resource/profile/FutureEvtSet.hpp"
+#include "src/surf/surf_interface.hpp"
+#include "surf/surf.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+SIMGRID_REGISTER_PLUGIN(metrics, "Periodic snapshots of the simulator health.", &sg_metrics_plugin_init)
+
+/** @defgroup plugin_metrics Plugin Metrics
+
+  @beginrst
+This plugin periodically appends a snapshot of the simulator health to a file, to follow long-running simulations
+while they run and spot their slow-downs and memory leaks. Activate it with ``--cfg=plugin:metrics``, or by calling
+``sg_metrics_plugin_init()`` before loading the platform.
+
+Every :ref:`plugin/metrics/interval <cfg=plugin/metrics/interval>` seconds of wall-clock time, and once more at the
+end of the simulation, a line is appended to the file given by
+:ref:`plugin/metrics/filename <cfg=plugin/metrics/filename>`. It is made of space-separated ``key=value`` pairs:
+
+  - ``clock``: the simulated time; ``wall``: the wall-clock time since the creation of the platform.
+  - ``rss``: the resident memory of the process, in bytes (only on Linux).
+  - ``actors``: the amount of actors alive; ``timers``: the amount of pending timers; ``profile_events``: the amount
+    of pending events of the resource profiles.
+  - For each model: ``<model>.actions`` (started actions, that is executions, communications or I/Os depending on
+    the model), ``<model>.variables`` and ``<model>.constraints`` (sizes of its LMM system) and ``<model>.heap`` (size
+    of its action heap).
+
+The snapshots are taken by the simulation kernel when the simulated time advances, and written to the file by a
+background thread. They only read some counters, so that they do not change the simulation in any way. When no
+snapshot could be taken during a whole interval (because the kernel is busy with a single time step), the background
+thread writes a line with ``stalled=1`` and the wall-clock time and memory.
+  @endrst
+*/
+
+XBT_LOG_NEW_DEFAULT_SUBCATEGORY(plugin_metrics, surf, "Logging specific to the Metrics plugin");
+
+static simgrid::config::Flag<double> cfg_metrics_interval{
+    "plugin/metrics/interval", "Wall-clock time (in seconds) between two snapshots of the metrics plugin", 1.0,
+    [](double val) { xbt_assert(val > 0, "plugin/metrics/interval must be positive"); }};
+static simgrid::config::Flag<std::string> cfg_metrics_filename{
+    "plugin/metrics/filename", "File to which the metrics plugin appends its snapshots", "simgrid-metrics.log"};
+
+namespace simgrid {
+namespace plugin {
+
+class MetricsExporter {
+  std::ofstream os_;
+  const std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+  const std::chrono::duration<double> interval_;
+
+  std::mutex mutex_; // Protects lines_ and stopping_
+  std::condition_variable cond_;
+  std::vector<std::string> lines_; // Snapshots waiting to be written
+  bool stopping_ = false;
+  std::atomic<bool> sample_due_{true};
+  std::thread writer_;
+
+  double wall_time() const
+  {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+  }
+  static void write_rss(std::ostream& os);
+  void writer_loop();
+
+public:
+  MetricsExporter(const std::string& filename, double interval);
+  MetricsExporter(const MetricsExporter&) = delete;
+  MetricsExporter& operator=(const MetricsExporter&) = delete;
+  ~MetricsExporter();
+
+  bool is_sample_due() const { return sample_due_.load(std::memory_order_relaxed); }
+  void sample();
+};
+
+MetricsExporter::MetricsExporter(const std::string& filename, double interval)
+    : os_(filename, std::ofstream::out | std::ofstream::app), interval_(interval)
+{
+  xbt_assert(not os_.fail(), "Cannot open %s to write the metrics", filename.c_str());
+  os_ << std::fixed << std::setprecision(6);
+  writer_ = std::thread(&MetricsExporter::writer_loop, this);
+}
+
+MetricsExporter::~MetricsExporter()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  cond_.notify_one();
+  writer_.join();
+}
+
+void MetricsExporter::write_rss(std::ostream& os)
+{
+#ifdef __linux__
+  std::ifstream statm("/proc/self/statm");
+  unsigned long size;
+  unsigned long resident;
+  if (statm >> size >> resident)
+    os << " rss=" << resident * static_cast<unsigned long>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+/* Runs in the background thread: it writes the snapshots out, and tells the kernel when to take the next one */
+void MetricsExporter::writer_loop()
+{
+  std::vector<std::string> lines;
+  auto next = std::chrono::steady_clock::now() + interval_;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cond_.wait_until(lock, next, [this] { return stopping_ || not lines_.empty(); });
+    lines.swap(lines_);
+    bool stopping = stopping_;
+    lock.unlock();
+
+    for (auto const& line : lines)
+      os_ << line << '\n';
+    lines.clear();
+    if (not stopping && std::chrono::steady_clock::now() >= next) {
+      next += interval_;
+      if (sample_due_.exchange(true)) { // The kernel did not take the previous snapshot
+        os_ << "wall=" << wall_time();
+        write_rss(os_);
+        os_ << " stalled=1\n";
+      }
+    }
+    os_.flush();
+
+    if (stopping)
+      return;
+    lock.lock();
+  }
+}
+
+/* Runs in maestro, between two steps of the simulation */
+void MetricsExporter::sample()
+{
+  sample_due_ = false;
+  const auto* engine = kernel::EngineImpl::get_instance();
+
+  std::ostringstream line;
+  line << std::fixed << std::setprecision(6);
+  line << "clock=" << surf_get_clock() << " wall=" << wall_time();
+  write_rss(line);
+  line << " actors=" << engine->get_actor_count() << " timers=" << kernel::timer::kernel_timers().size()
+       << " profile_events=" << kernel::profile::future_evt_set.size();
+  for (auto* model : engine->get_all_models()) {
+    std::string name = model->get_name();
+    std::replace(name.begin(), name.end(), ' ', '_');
+    line << ' ' << name << ".actions=" << model->get_started_action_set()->size();
+    if (const kernel::lmm::System* system = model->get_maxmin_system())
+      line << ' ' << name << ".variables=" << system->variable_set.size() << ' ' << name
+           << ".constraints=" << system->active_constraint_set.size();
+    line << ' ' << name << ".heap=" << model->get_action_heap().size();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lines_.push_back(line.str());
+  }
+  cond_.notify_one();
+}
+
+static std::unique_ptr<MetricsExporter> exporter;
+
+} // namespace plugin
+} // namespace simgrid
+
+using simgrid::plugin::exporter;
+using simgrid::plugin::MetricsExporter;
+
+/**
+ * @ingroup plugin_metrics
+ * @brief Initializes the metrics plugin
+ * @details The snapshots are appended to the file given by plugin/metrics/filename, every plugin/metrics/interval
+ * seconds of wall-clock time.
+ */
+void sg_metrics_plugin_init()
+{
+  static bool initialized = false;
+  if (initialized)
+    return;
+  initialized = true;
+
+  // Wait for the whole configuration to be parsed before reading the options
+  simgrid::s4u::Engine::on_platform_created.connect(
+      []() { exporter = std::make_unique<MetricsExporter>(cfg_metrics_filename, cfg_metrics_interval); });
+  simgrid::s4u::Engine::on_time_advance.connect([](double /*delta*/) {
+    if (exporter && exporter->is_sample_due())
+      exporter->sample();
+  });
+  simgrid::s4u::Engine::on_simulation_end.connect([]() {
+    if (exporter) {
+      exporter->sample();
+      exporter.reset();
+    }
+  });
+}
@@ -6,6 +6,7 @@
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
 #include "mc/mc.h"
+#include "simgrid/kernel/Profiler.hpp"
 #include "simgrid/kernel/routing/NetPoint.hpp"
 #include "simgrid/kernel/routing/NetZoneImpl.hpp"
 #include "simgrid/s4u/Disk.hpp"
@@ -99,6 +100,11 @@ const std::vector<simgrid::kernel::resource::Model*>& Engine::get_all_models() c
   return pimpl->get_all_models();
 }
 
+const kernel::Profiler& Engine::get_profiler() const
+{
+  return kernel::Profiler::get_instance();
+}
+
 /**
  * Creates a new platform, including hosts, links, and the routing table.
  *
@@ -211,17 +217,38 @@ void Engine::host_unregister(const std::string& name)
  */
 Host* Engine::host_by_name(const std::string& name) const
 {
-  auto host = pimpl->hosts_.find(name);
-  if (host == pimpl->hosts_.end())
+  Host* host = host_by_name_or_null(name);
+  if (host == nullptr)
     throw std::invalid_argument(std::string("Host not found: '") + name + std::string("'"));
-  return host->second;
+  return host;
 }
 
-/** @brief Find a host from its name (or nullptr if that host does not exist) */
+/** @brief Find a host from its name (or nullptr if that host does not exist)
+ *
+ * The hosts of the lazy clusters (see platform/lazy-clusters) are created when they are first looked up.
+ */
 Host* Engine::host_by_name_or_null(const std::string& name) const
 {
   auto host = pimpl->hosts_.find(name);
-  return host == pimpl->hosts_.end() ? nullptr : host->second;
+  return host == pimpl->hosts_.end() ? pimpl->materialize_host(name) : host->second;
+}
+
+/** @brief Find a host from its id (see Host::get_id()), in constant time.
+ *
+ *  @throw std::invalid_argument if the searched host does not exist.
+ */
+Host* Engine::host_by_id(unsigned long id) const
+{
+  Host* host = host_by_id_or_null(id);
+  if (host == nullptr)
+    throw std::invalid_argument("Host not found: #" + std::to_string(id));
+  return host;
+}
+
+/** @brief Find a host from its id (or nullptr if that host does not exist) */
+Host* Engine::host_by_id_or_null(unsigned long id) const
+{
+  return id < pimpl->hosts_by_id_.size() ? pimpl->hosts_by_id_[id] : nullptr;
 }
 
 /** @brief Find a link from its name.
@@ -251,6 +278,24 @@ Link* Engine::link_by_name_or_null(const std::string& name) const
   return link == pimpl->links_.end() ? nullptr : link->second->get_iface();
 }
 
+/** @brief Find a link from its id (see Link::get_id()), in constant time.
+ *
+ *  @throw std::invalid_argument if the searched link does not exist.
+ */
+Link* Engine::link_by_id(unsigned long id) const
+{
+  Link* link = link_by_id_or_null(id);
+  if (link == nullptr)
+    throw std::invalid_argument("Link not found: #" + std::to_string(id));
+  return link;
+}
+
+/** @brief Find a link from its id (or nullptr if that link does not exist) */
+Link* Engine::link_by_id_or_null(unsigned long id) const
+{
+  return id < pimpl->links_by_id_.size() ? pimpl->links_by_id_[id] : nullptr;
+}
+
 /** @brief Find a mailox from its name or create one if it does not exist) */
 Mailbox* Engine::mailbox_by_name_or_create(const std::string& name) const
 {
@@ -328,6 +373,13 @@ std::vector<ActorPtr> Engine::get_filtered_actors(const std::function<bool(Actor
 
 void Engine::run() const
 {
+  run_until(-1.0);
+}
+
+void Engine::run_until(double max_date) const
+{
+  xbt_assert(max_date < 0 || max_date >= get_clock(), "Cannot run until %f: that's in the past already (now: %f)",
+             max_date, get_clock());
   /* sealing resources before run: links */
   for (auto* link : get_all_links())
     link->seal();
@@ -339,9 +391,10 @@ void Engine::run() const
   fflush(stderr);
 
   if (MC_is_active()) {
+    xbt_assert(max_date < 0, "Cannot run the model-checker until a given date");
     MC_run();
   } else {
-    pimpl->run();
+    pimpl->run(max_date);
   }
 }
 
@@ -383,7 +436,10 @@ NetZone* Engine::netzone_by_name_or_null(const std::string& name) const
 kernel::routing::NetPoint* Engine::netpoint_by_name_or_null(const std::string& name) const
 {
   auto netp = pimpl->netpoints_.find(name);
-  return netp == pimpl->netpoints_.end() ? nullptr : netp->second;
+  if (netp != pimpl->netpoints_.end())
+    return netp->second;
+  const Host* host = pimpl->materialize_host(name);
+  return host ? host->get_netpoint() : nullptr;
 }
 
 kernel::routing::NetPoint* Engine::netpoint_by_name(const std::string& name) const
@@ -464,6 +520,10 @@ void simgrid_run()
 {
   simgrid::s4u::Engine::get_instance()->run();
 }
+void simgrid_run_until(double max_date)
+{
+  simgrid::s4u::Engine::get_instance()->run_until(max_date);
+}
 void simgrid_register_function(const char* name, void (*code)(int, char**))
 {
   simgrid::s4u::Engine::get_instance()->register_function(name, code);
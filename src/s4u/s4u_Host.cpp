@@ -91,6 +91,11 @@ const char* Host::get_cname() const
   return this->pimpl_->get_cname();
 }
 
+unsigned long Host::get_id() const
+{
+  return this->pimpl_->get_id();
+}
+
 void Host::turn_on()
 {
   if (not is_on()) {
@@ -58,6 +58,10 @@ const char* Link::get_cname() const
 {
   return this->pimpl_->get_cname();
 }
+unsigned long Link::get_id() const
+{
+  return pimpl_->get_id();
+}
 bool Link::is_used() const
 {
   return this->pimpl_->is_used();
@@ -246,7 +246,7 @@ double SIMIX_get_clock() // XBT_ATTRIB_DEPRECATED_v332
 
 void SIMIX_run() // XBT_ATTRIB_DEPRECATED_v332
 {
-  simgrid::kernel::EngineImpl::get_instance()->run();
+  simgrid::kernel::EngineImpl::get_instance()->run(-1);
 }
 
 int SIMIX_is_maestro()
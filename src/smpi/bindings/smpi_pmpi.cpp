@@ -217,13 +217,16 @@ int PMPI_Initialized(int* flag) {
 int PMPI_Alloc_mem(MPI_Aint size, MPI_Info /*info*/, void* baseptr)
 {
   CHECK_NEGATIVE(1, MPI_ERR_COUNT, size)
-  void *ptr = xbt_malloc(size);
+  void* ptr = smpi_zero_copy_malloc(size);
+  if (ptr == nullptr)
+    ptr = xbt_malloc(size);
   *static_cast<void**>(baseptr) = ptr;
   return MPI_SUCCESS;
 }
 
 int PMPI_Free_mem(void *baseptr){
-  xbt_free(baseptr);
+  if (not smpi_zero_copy_free(baseptr))
+    xbt_free(baseptr);
   return MPI_SUCCESS;
 }
 
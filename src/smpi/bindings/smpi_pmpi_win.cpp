@@ -63,6 +63,7 @@ int PMPI_Win_allocate_shared( MPI_Aint size, int disp_unit, MPI_Info info, MPI_C
      ptr = xbt_malloc(size*comm->size());
   }
   const SmpiBenchGuard suspend_bench;
+  simgrid::smpi::ActorExt::PayloadNeeded payload_needed(smpi_process());
   simgrid::smpi::colls::bcast(&ptr, sizeof(void*), MPI_BYTE, 0, comm);
   simgrid::smpi::colls::barrier(comm);
   *static_cast<void**>(base) = (char*)ptr+rank*size;
@@ -14,7 +14,26 @@
 #include "smpi_op.hpp"
 #include "smpi_request.hpp"
 #include <cmath>
+#include <numeric>
 
 XBT_LOG_EXTERNAL_DEFAULT_CATEGORY(smpi_colls);
 
+/* Size of the data handled by a collective call, to index the tables of tuned algorithms (see smpi/coll-table).
+ * They only use the arguments which are significant, and identical, on every rank, so that all ranks pick the same
+ * algorithm. Nothing of that kind exists for alltoallv, that is only indexed by communicator size. */
+#define COLL_GATHER_TABLE_SIZE                                                                                         \
+  (send_buff == MPI_IN_PLACE ? recv_count * recv_type->size() : send_count * send_type->size())
+#define COLL_ALLGATHER_TABLE_SIZE COLL_GATHER_TABLE_SIZE
+#define COLL_ALLGATHERV_TABLE_SIZE (std::accumulate(recv_count, recv_count + comm->size(), 0L) * recv_type->size())
+#define COLL_ALLTOALL_TABLE_SIZE COLL_GATHER_TABLE_SIZE
+#define COLL_ALLTOALLV_TABLE_SIZE 0L
+#define COLL_BCAST_TABLE_SIZE (count * datatype->size())
+#define COLL_REDUCE_TABLE_SIZE (count * datatype->size())
+#define COLL_ALLREDUCE_TABLE_SIZE (rcount * dtype->size())
+#define COLL_REDUCE_SCATTER_TABLE_SIZE (std::accumulate(rcounts, rcounts + comm->size(), 0L) * dtype->size())
+#define COLL_SCATTER_TABLE_SIZE                                                                                        \
+  (recvbuf == MPI_IN_PLACE ? sendcount * sendtype->size() : recvcount * recvtype->size())
+#define COLL_BARRIER_TABLE_SIZE 0L
+#define COLL_APPLY_TABLE(action, sig, name, msg_size) action(sig, name, msg_size)
+
 #endif
@@ -0,0 +1,370 @@
+/* Analytical models of the collective operations, charging their time at once instead of simulating each message */
+
+/* Copyright (c) 2021. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "colls_private.hpp"
+#include "simgrid/kernel/routing/NetPoint.hpp"
+#include "simgrid/kernel/routing/NetZoneImpl.hpp"
+#include "simgrid/s4u/Barrier.hpp"
+#include "simgrid/s4u/Host.hpp"
+#include "simgrid/s4u/Link.hpp"
+#include "src/kernel/actor/ActorImpl.hpp"
+#include "src/surf/network_interface.hpp"
+#include "xbt/config.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+#include <unordered_map>
+
+namespace simgrid {
+namespace smpi {
+
+/** @brief State shared by all the ranks of a communicator, to run the analytical collectives without any message
+ *
+ * The ranks publish their buffers and wait for each other. Then they read the buffers they need from the other ranks
+ * while rank 0 charges the time given by the model, and they wait for each other again. The collectives are called in
+ * the same order by all the ranks of a communicator, so a single slot per rank is enough.
+ */
+class CollRendezvous {
+public:
+  struct Block {
+    const void* buf;
+    int count;
+    MPI_Datatype type;
+  };
+  /** @brief Data moved by a collective, for the ptask model */
+  struct Traffic {
+    double pair_bytes = 0.0;                         // sent by each rank to each other rank
+    std::vector<std::tuple<int, int, double>> edges; // additional transfers (from rank, to rank, bytes)
+  };
+
+private:
+  s4u::BarrierPtr barrier_;
+  std::vector<Block> blocks_;
+  std::vector<unsigned char> result_;
+
+  /* The platform as seen by the communicator, retrieved by rank 0 on its first collective */
+  bool platform_known_ = false;
+  std::vector<s4u::Host*> hosts_; // distinct hosts of the ranks
+  std::vector<int> ranks_per_host_;
+  std::vector<size_t> host_of_rank_;
+  double latency_   = 0.0; // of the longest route from the host of rank 0
+  double bandwidth_ = std::numeric_limits<double>::infinity(); // of the narrowest link on these routes
+  kernel::resource::NetworkModel* network_model_ = nullptr;
+
+  void discover_platform(MPI_Comm comm);
+
+public:
+  explicit CollRendezvous(int size) : barrier_(s4u::Barrier::create(size)), blocks_(size) {}
+  static CollRendezvous* get(MPI_Comm comm);
+
+  void publish(int rank, const void* buf, int count, MPI_Datatype type) { blocks_[rank] = {buf, count, type}; }
+  const Block& block(int rank) const { return blocks_[rank]; }
+  std::vector<unsigned char>& result() { return result_; }
+  void wait() { barrier_->wait(); }
+
+  double hockney(double steps, double bytes, double msg_size) const;
+  void charge(MPI_Comm comm, double (*model)(const CollRendezvous&, int, double), double msg_size,
+              const Traffic& traffic);
+};
+
+/** @brief Retrieves the state shared by the ranks of the communicator, or nullptr if the analytical collectives cannot
+ * be used on it.
+ *
+ * These states are matched across the ranks thanks to the communicator ids, that are only known once the communicator
+ * is fully created. The communicators created internally by the SMP-aware algorithms have no id either. */
+CollRendezvous* CollRendezvous::get(MPI_Comm comm)
+{
+  if (comm->get_coll_rendezvous() == nullptr) {
+    /* Without an id, the ranks cannot find each other. With mmap privatization, they would read the buffers of each
+     * other in their own copy of the data segment. */
+    if (comm->id() == MPI_UNDEFINED || smpi_cfg_privatization() == SmpiPrivStrategies::MMAP)
+      return nullptr;
+    bool is_world = comm == MPI_COMM_WORLD; // shared by all the ranks, but its id is not unique
+    kernel::actor::simcall([comm, is_world] {
+      static std::unordered_map<int, std::weak_ptr<CollRendezvous>> rendezvous;
+      if (comm->get_coll_rendezvous() != nullptr) // already set by another rank of MPI_COMM_WORLD
+        return;
+      std::shared_ptr<CollRendezvous> res = is_world ? nullptr : rendezvous[comm->id()].lock();
+      if (res == nullptr) {
+        res = std::make_shared<CollRendezvous>(comm->size());
+        if (not is_world)
+          rendezvous[comm->id()] = res;
+      }
+      comm->set_coll_rendezvous(res);
+    });
+  }
+  return comm->get_coll_rendezvous();
+}
+
+void CollRendezvous::discover_platform(MPI_Comm comm)
+{
+  std::unordered_map<s4u::Host*, size_t> host_ids;
+  for (int i = 0; i < comm->size(); i++) {
+    s4u::Host* host = s4u::Actor::by_pid(comm->group()->actor(i))->get_host();
+    auto it         = host_ids.find(host);
+    if (it == host_ids.end()) {
+      it = host_ids.emplace(host, hosts_.size()).first;
+      hosts_.push_back(host);
+      ranks_per_host_.push_back(0);
+    }
+    host_of_rank_.push_back(it->second);
+    ranks_per_host_[it->second]++;
+  }
+
+  for (size_t i = 1; i < hosts_.size(); i++) {
+    std::vector<s4u::Link*> links;
+    double latency = 0.0;
+    hosts_[0]->route_to(hosts_[i], links, &latency);
+    latency_ = std::max(latency_, latency);
+    for (auto const* link : links)
+      bandwidth_ = std::min(bandwidth_, link->get_bandwidth());
+  }
+  network_model_  = hosts_[0]->get_netpoint()->get_englobing_zone()->get_network_model().get();
+  platform_known_ = true;
+  XBT_DEBUG("Analytical collectives on %zu hosts: latency %g, bandwidth %g", hosts_.size(), latency_, bandwidth_);
+}
+
+/** @brief Time of a sequence of steps moving the given amount of bytes in messages of the given size.
+ *
+ * The latency and bandwidth of the platform are corrected with the factors of the network model for that message
+ * size, and the bandwidth is bounded by the TCP window, as done by the message-level simulation. */
+double CollRendezvous::hockney(double steps, double bytes, double msg_size) const
+{
+  double latency   = latency_ * network_model_->get_latency_factor(msg_size);
+  double bandwidth = bandwidth_ * network_model_->get_bandwidth_factor(msg_size);
+  if (latency > 0)
+    bandwidth = std::min(bandwidth, kernel::resource::NetworkModel::cfg_tcp_gamma / (2.0 * latency));
+  return steps * latency + (bytes > 0 ? bytes / bandwidth : 0.0);
+}
+
+/** @brief Makes rank 0 wait for the duration of a collective.
+ *
+ * With the ptask_L07 model, the traffic of the collective is executed as a single parallel task, which accounts for
+ * the contention on the links. Otherwise, or if no byte leaves its host, the closed-form model is used. */
+void CollRendezvous::charge(MPI_Comm comm, double (*model)(const CollRendezvous&, int, double), double msg_size,
+                            const Traffic& traffic)
+{
+  if (not platform_known_)
+    discover_platform(comm);
+
+  static bool use_ptask = config::get_value<std::string>("host/model") == "ptask_L07";
+  if (use_ptask && hosts_.size() > 1) {
+    size_t host_count = hosts_.size();
+    std::vector<double> bytes(host_count * host_count, 0.0);
+    bool any_traffic = false;
+    for (size_t src = 0; src < host_count; src++)
+      for (size_t dst = 0; dst < host_count; dst++)
+        if (src != dst)
+          bytes[src * host_count + dst] = traffic.pair_bytes * ranks_per_host_[src] * ranks_per_host_[dst];
+    for (auto const& edge : traffic.edges) {
+      size_t src = host_of_rank_[std::get<0>(edge)];
+      size_t dst = host_of_rank_[std::get<1>(edge)];
+      if (src != dst)
+        bytes[src * host_count + dst] += std::get<2>(edge);
+    }
+    for (double b : bytes)
+      any_traffic = any_traffic || b > 0;
+    if (any_traffic) {
+      s4u::this_actor::parallel_execute(hosts_, std::vector<double>(host_count, 0.0), bytes);
+      return;
+    }
+  }
+
+  double duration = model(*this, comm->size(), msg_size);
+  XBT_DEBUG("Analytical collective on %d ranks with messages of %g bytes: %g seconds", comm->size(), msg_size,
+            duration);
+  s4u::this_actor::sleep_for(duration);
+}
+
+namespace {
+/* Number of steps of the tree-based algorithms */
+double log_steps(int size)
+{
+  return size > 1 ? std::ceil(std::log2(size)) : 0.0;
+}
+
+/* Each model returns the time of the quickest of the classical algorithms for that collective, given the number of
+ * ranks and the size of the data. */
+double barrier_model(const CollRendezvous& rdv, int size, double)
+{
+  return rdv.hockney(log_steps(size), 0.0, 0.0); // dissemination
+}
+
+double bcast_model(const CollRendezvous& rdv, int size, double bytes)
+{
+  double steps = log_steps(size);
+  double chunk = bytes / size;
+  return std::min(rdv.hockney(steps, steps * bytes, bytes),                                // binomial tree
+                  rdv.hockney(steps + size - 1, 2.0 * (size - 1) * chunk, chunk));          // scatter + ring allgather
+}
+
+double allreduce_model(const CollRendezvous& rdv, int size, double bytes)
+{
+  double steps = log_steps(size);
+  double chunk = bytes / size;
+  return std::min({rdv.hockney(steps, steps * bytes, bytes),                               // recursive doubling
+                   rdv.hockney(2.0 * steps, 2.0 * (size - 1) * chunk, chunk),               // Rabenseifner
+                   rdv.hockney(2.0 * (size - 1), 2.0 * (size - 1) * chunk, chunk)});        // ring
+}
+
+double allgather_model(const CollRendezvous& rdv, int size, double bytes)
+{
+  return std::min(rdv.hockney(log_steps(size), (size - 1) * bytes, bytes), // recursive doubling, or Bruck
+                  rdv.hockney(size - 1, (size - 1) * bytes, bytes));       // ring
+}
+
+double alltoall_model(const CollRendezvous& rdv, int size, double bytes)
+{
+  double steps = log_steps(size);
+  return std::min(rdv.hockney(size - 1, (size - 1) * bytes, bytes),                   // pairwise exchange
+                  rdv.hockney(steps, steps * size / 2.0 * bytes, size / 2.0 * bytes)); // Bruck
+}
+} // namespace
+
+int barrier__analytical(MPI_Comm comm)
+{
+  CollRendezvous* rdv = CollRendezvous::get(comm);
+  if (rdv == nullptr)
+    return barrier__default(comm);
+
+  rdv->wait();
+  if (comm->rank() == 0)
+    rdv->charge(comm, barrier_model, 0.0, {});
+  rdv->wait();
+  return MPI_SUCCESS;
+}
+
+int bcast__analytical(void* buf, int count, MPI_Datatype datatype, int root, MPI_Comm comm)
+{
+  CollRendezvous* rdv = CollRendezvous::get(comm);
+  if (rdv == nullptr)
+    return bcast__default(buf, count, datatype, root, comm);
+
+  int rank = comm->rank();
+  int size = comm->size();
+  rdv->publish(rank, buf, count, datatype);
+  rdv->wait();
+  if (rank != root)
+    Datatype::copy(rdv->block(root).buf, count, datatype, buf, count, datatype);
+  if (rank == 0) {
+    /* The data follows a binomial tree */
+    double bytes = static_cast<double>(count) * datatype->size();
+    CollRendezvous::Traffic traffic;
+    for (int i = 1; i < size; i++) {
+      int parent = i & (i - 1); // clear the lowest bit
+      traffic.edges.emplace_back((parent + root) % size, (i + root) % size, bytes);
+    }
+    rdv->charge(comm, bcast_model, bytes, traffic);
+  }
+  rdv->wait();
+  return MPI_SUCCESS;
+}
+
+int allreduce__analytical(const void* sbuf, void* rbuf, int rcount, MPI_Datatype dtype, MPI_Op op, MPI_Comm comm)
+{
+  CollRendezvous* rdv = CollRendezvous::get(comm);
+  if (rdv == nullptr)
+    return allreduce__default(sbuf, rbuf, rcount, dtype, op, comm);
+
+  int rank = comm->rank();
+  int size = comm->size();
+  rdv->publish(rank, sbuf == MPI_IN_PLACE ? rbuf : sbuf, rcount, dtype);
+  rdv->wait();
+  MPI_Aint lb;
+  MPI_Aint extent;
+  dtype->extent(&lb, &extent);
+  if (rank == 0) {
+    /* Reduce the contributions in the order of the ranks, as expected by the non-commutative operations */
+    std::vector<unsigned char>& result = rdv->result();
+    result.resize(rcount * extent);
+    unsigned char* tmp = result.data() - lb;
+    Datatype::copy(rdv->block(size - 1).buf, rcount, dtype, tmp, rcount, dtype);
+    for (int i = size - 2; i >= 0; i--)
+      if (op != MPI_OP_NULL)
+        op->apply(rdv->block(i).buf, tmp, &rcount, dtype);
+
+    /* Each rank sends and receives a share of the data to and from all others, as in a reduce-scatter + allgather */
+    double bytes = static_cast<double>(rcount) * dtype->size();
+    CollRendezvous::Traffic traffic;
+    traffic.pair_bytes = 2.0 * bytes / size;
+    rdv->charge(comm, allreduce_model, bytes, traffic);
+  }
+  rdv->wait();
+  Datatype::copy(rdv->result().data() - lb, rcount, dtype, rbuf, rcount, dtype);
+  return MPI_SUCCESS;
+}
+
+int allgather__analytical(const void* send_buff, int send_count, MPI_Datatype send_type, void* recv_buff,
+                          int recv_count, MPI_Datatype recv_type, MPI_Comm comm)
+{
+  CollRendezvous* rdv = CollRendezvous::get(comm);
+  if (rdv == nullptr)
+    return allgather__default(send_buff, send_count, send_type, recv_buff, recv_count, recv_type, comm);
+
+  int rank = comm->rank();
+  int size = comm->size();
+  MPI_Aint rextent = recv_type->get_extent();
+  auto* recv_ptr   = static_cast<unsigned char*>(recv_buff);
+  if (send_buff == MPI_IN_PLACE)
+    rdv->publish(rank, recv_ptr + rank * recv_count * rextent, recv_count, recv_type);
+  else
+    rdv->publish(rank, send_buff, send_count, send_type);
+  rdv->wait();
+  /* Nobody writes in the block of a rank but that rank, so the in-place blocks can be read safely */
+  for (int i = 0; i < size; i++) {
+    const CollRendezvous::Block& block = rdv->block(i);
+    Datatype::copy(block.buf, block.count, block.type, recv_ptr + i * recv_count * rextent, recv_count, recv_type);
+  }
+  if (rank == 0) {
+    double bytes = static_cast<double>(recv_count) * recv_type->size();
+    CollRendezvous::Traffic traffic;
+    traffic.pair_bytes = bytes;
+    rdv->charge(comm, allgather_model, bytes, traffic);
+  }
+  rdv->wait();
+  return MPI_SUCCESS;
+}
+
+int alltoall__analytical(const void* send_buff, int send_count, MPI_Datatype send_type, void* recv_buff, int recv_count,
+                         MPI_Datatype recv_type, MPI_Comm comm)
+{
+  CollRendezvous* rdv = CollRendezvous::get(comm);
+  if (rdv == nullptr)
+    return alltoall__default(send_buff, send_count, send_type, recv_buff, recv_count, recv_type, comm);
+
+  int rank = comm->rank();
+  int size = comm->size();
+  MPI_Aint rextent = recv_type->get_extent();
+  auto* recv_ptr   = static_cast<unsigned char*>(recv_buff);
+  std::vector<unsigned char> in_place_copy;
+  if (send_buff == MPI_IN_PLACE) {
+    /* The receive buffer is overwritten while the other ranks read it */
+    in_place_copy.resize(size * recv_count * rextent);
+    Datatype::copy(recv_buff, size * recv_count, recv_type, in_place_copy.data(), size * recv_count, recv_type);
+    rdv->publish(rank, in_place_copy.data(), recv_count, recv_type);
+  } else {
+    rdv->publish(rank, send_buff, send_count, send_type);
+  }
+  rdv->wait();
+  for (int i = 0; i < size; i++) {
+    const CollRendezvous::Block& block = rdv->block(i);
+    const auto* src = static_cast<const unsigned char*>(block.buf) + rank * block.count * block.type->get_extent();
+    Datatype::copy(src, block.count, block.type, recv_ptr + i * recv_count * rextent, recv_count, recv_type);
+  }
+  if (rank == 0) {
+    double bytes = static_cast<double>(recv_count) * recv_type->size();
+    CollRendezvous::Traffic traffic;
+    traffic.pair_bytes = bytes;
+    rdv->charge(comm, alltoall_model, bytes, traffic);
+  }
+  rdv->wait();
+  return MPI_SUCCESS;
+}
+
+} // namespace smpi
+} // namespace simgrid
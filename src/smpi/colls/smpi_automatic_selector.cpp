@@ -11,16 +11,17 @@
 #include "src/smpi/include/smpi_actor.hpp"
 
 //attempt to do a quick autotuning version of the collective,
-#define AUTOMATIC_COLL_BENCH(cat, ret, args, args2)                                                                    \
+#define AUTOMATIC_COLL_BENCH(cat, ret, args, args2, msg_size)                                                          \
   ret _XBT_CONCAT2(cat, __automatic)(COLL_UNPAREN args)                                                                \
   {                                                                                                                    \
     double time1, time2, time_min = DBL_MAX;                                                                           \
     int min_coll = -1, global_coll = -1;                                                                               \
-    double buf_in, buf_out, max_min = DBL_MAX;                                                                         \
+    double buf_in = 0.0, buf_out, max_min = DBL_MAX;                                                                   \
     auto descriptions = simgrid::smpi::colls::get_smpi_coll_descriptions(_XBT_STRINGIFY(cat));                         \
     for (unsigned long i = 0; i < descriptions->size(); i++) {                                                         \
       auto desc = &descriptions->at(i);                                                                                \
-      if (desc->name == "automatic" || desc->name == "default")                                                        \
+      if (desc->name == "automatic" || desc->name == "default" || desc->name == "table" ||                             \
+          desc->name == "analytical")                                                                                  \
         continue;                                                                                                      \
       barrier__default(comm);                                                                                          \
       if (TRACE_is_enabled()) {                                                                                        \
@@ -41,12 +42,17 @@
       }                                                                                                                \
       time2   = simgrid::s4u::Engine::get_clock();                                                                     \
       buf_out = time2 - time1;                                                                                         \
-      reduce__default((void*)&buf_out, (void*)&buf_in, 1, MPI_DOUBLE, MPI_MAX, 0, comm);                               \
+      {                                                                                                                \
+        /* The timings are SMPI data, that must be exchanged even when the payloads are skipped */                     \
+        simgrid::smpi::ActorExt::PayloadNeeded payload_needed(smpi_process());                                         \
+        reduce__default((void*)&buf_out, (void*)&buf_in, 1, MPI_DOUBLE, MPI_MAX, 0, comm);                             \
+      }                                                                                                                \
       if (time2 - time1 < time_min) {                                                                                  \
         min_coll = i;                                                                                                  \
         time_min = time2 - time1;                                                                                      \
       }                                                                                                                \
       if (comm->rank() == 0) {                                                                                         \
+        simgrid::smpi::colls::record_coll_timing(_XBT_STRINGIFY(cat), comm->size(), (msg_size), desc->name, buf_in);   \
         if (buf_in < max_min) {                                                                                        \
           max_min     = buf_in;                                                                                        \
           global_coll = i;                                                                                             \
@@ -66,17 +72,17 @@
 namespace simgrid{
 namespace smpi{
 
-COLL_APPLY(AUTOMATIC_COLL_BENCH, COLL_ALLGATHERV_SIG, (send_buff, send_count, send_type, recv_buff, recv_count, recv_disps, recv_type, comm))
-COLL_APPLY(AUTOMATIC_COLL_BENCH, COLL_ALLREDUCE_SIG, (sbuf, rbuf, rcount, dtype, op, comm))
-COLL_APPLY(AUTOMATIC_COLL_BENCH, COLL_GATHER_SIG, (send_buff, send_count, send_type, recv_buff, recv_count, recv_type, root, comm))
-COLL_APPLY(AUTOMATIC_COLL_BENCH, COLL_ALLGATHER_SIG, (send_buff,send_count,send_type,recv_buff,recv_count,recv_type,comm))
-COLL_APPLY(AUTOMATIC_COLL_BENCH, COLL_ALLTOALL_SIG,(send_buff, send_count, send_type, recv_buff, recv_count, recv_type,comm))
-COLL_APPLY(AUTOMATIC_COLL_BENCH, COLL_ALLTOALLV_SIG, (send_buff, send_counts, send_disps, send_type, recv_buff, recv_counts, recv_disps, recv_type, comm))
-COLL_APPLY(AUTOMATIC_COLL_BENCH, COLL_BCAST_SIG , (buf, count, datatype, root, comm))
-COLL_APPLY(AUTOMATIC_COLL_BENCH, COLL_REDUCE_SIG,(buf,rbuf, count, datatype, op, root, comm))
-COLL_APPLY(AUTOMATIC_COLL_BENCH, COLL_REDUCE_SCATTER_SIG ,(sbuf,rbuf, rcounts,dtype,op,comm))
-COLL_APPLY(AUTOMATIC_COLL_BENCH, COLL_SCATTER_SIG ,(sendbuf, sendcount, sendtype,recvbuf, recvcount, recvtype,root, comm))
-COLL_APPLY(AUTOMATIC_COLL_BENCH, COLL_BARRIER_SIG,(comm))
+COLL_APPLY_TABLE(AUTOMATIC_COLL_BENCH, COLL_ALLGATHERV_SIG, (send_buff, send_count, send_type, recv_buff, recv_count, recv_disps, recv_type, comm), COLL_ALLGATHERV_TABLE_SIZE)
+COLL_APPLY_TABLE(AUTOMATIC_COLL_BENCH, COLL_ALLREDUCE_SIG, (sbuf, rbuf, rcount, dtype, op, comm), COLL_ALLREDUCE_TABLE_SIZE)
+COLL_APPLY_TABLE(AUTOMATIC_COLL_BENCH, COLL_GATHER_SIG, (send_buff, send_count, send_type, recv_buff, recv_count, recv_type, root, comm), COLL_GATHER_TABLE_SIZE)
+COLL_APPLY_TABLE(AUTOMATIC_COLL_BENCH, COLL_ALLGATHER_SIG, (send_buff,send_count,send_type,recv_buff,recv_count,recv_type,comm), COLL_ALLGATHER_TABLE_SIZE)
+COLL_APPLY_TABLE(AUTOMATIC_COLL_BENCH, COLL_ALLTOALL_SIG,(send_buff, send_count, send_type, recv_buff, recv_count, recv_type,comm), COLL_ALLTOALL_TABLE_SIZE)
+COLL_APPLY_TABLE(AUTOMATIC_COLL_BENCH, COLL_ALLTOALLV_SIG, (send_buff, send_counts, send_disps, send_type, recv_buff, recv_counts, recv_disps, recv_type, comm), COLL_ALLTOALLV_TABLE_SIZE)
+COLL_APPLY_TABLE(AUTOMATIC_COLL_BENCH, COLL_BCAST_SIG, (buf, count, datatype, root, comm), COLL_BCAST_TABLE_SIZE)
+COLL_APPLY_TABLE(AUTOMATIC_COLL_BENCH, COLL_REDUCE_SIG,(buf,rbuf, count, datatype, op, root, comm), COLL_REDUCE_TABLE_SIZE)
+COLL_APPLY_TABLE(AUTOMATIC_COLL_BENCH, COLL_REDUCE_SCATTER_SIG,(sbuf,rbuf, rcounts,dtype,op,comm), COLL_REDUCE_SCATTER_TABLE_SIZE)
+COLL_APPLY_TABLE(AUTOMATIC_COLL_BENCH, COLL_SCATTER_SIG,(sendbuf, sendcount, sendtype,recvbuf, recvcount, recvtype,root, comm), COLL_SCATTER_TABLE_SIZE)
+COLL_APPLY_TABLE(AUTOMATIC_COLL_BENCH, COLL_BARRIER_SIG,(comm), COLL_BARRIER_TABLE_SIZE)
 
 }
 }
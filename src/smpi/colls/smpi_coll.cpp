@@ -31,7 +31,8 @@ std::map<std::string, std::vector<s_mpi_coll_description_t>, std::less<>> smpi_c
        {"mvapich2", "gather mvapich2 collective", (void*)gather__mvapich2},
        {"mvapich2_two_level", "gather mvapich2_two_level collective", (void*)gather__mvapich2_two_level},
        {"impi", "gather impi collective", (void*)gather__impi},
-       {"automatic", "gather automatic collective", (void*)gather__automatic}}},
+       {"automatic", "gather automatic collective", (void*)gather__automatic},
+       {"table", "gather table collective", (void*)gather__table}}},
 
      {"allgather",
       {{"default", "allgather default collective", (void*)allgather__default},
@@ -55,7 +56,9 @@ std::map<std::string, std::vector<s_mpi_coll_description_t>, std::less<>> smpi_c
        {"mvapich2_smp", "allgather mvapich2_smp collective", (void*)allgather__mvapich2_smp},
        {"mpich", "allgather mpich collective", (void*)allgather__mpich},
        {"impi", "allgather impi collective", (void*)allgather__impi},
-       {"automatic", "allgather automatic collective", (void*)allgather__automatic}}},
+       {"analytical", "allgather analytical model", (void*)allgather__analytical},
+       {"automatic", "allgather automatic collective", (void*)allgather__automatic},
+       {"table", "allgather table collective", (void*)allgather__table}}},
 
      {"allgatherv",
       {{"default", "allgatherv default collective", (void*)allgatherv__default},
@@ -71,7 +74,8 @@ std::map<std::string, std::vector<s_mpi_coll_description_t>, std::less<>> smpi_c
        {"mpich_ring", "allgatherv mpich_ring collective", (void*)allgatherv__mpich_ring},
        {"mvapich2", "allgatherv mvapich2 collective", (void*)allgatherv__mvapich2},
        {"impi", "allgatherv impi collective", (void*)allgatherv__impi},
-       {"automatic", "allgatherv automatic collective", (void*)allgatherv__automatic}}},
+       {"automatic", "allgatherv automatic collective", (void*)allgatherv__automatic},
+       {"table", "allgatherv table collective", (void*)allgatherv__table}}},
 
      {"allreduce",
       {{"default", "allreduce default collective", (void*)allreduce__default},
@@ -95,7 +99,9 @@ std::map<std::string, std::vector<s_mpi_coll_description_t>, std::less<>> smpi_c
        {"mvapich2_two_level", "allreduce mvapich2_two_level collective", (void*)allreduce__mvapich2_two_level},
        {"impi", "allreduce impi collective", (void*)allreduce__impi},
        {"rab", "allreduce rab collective", (void*)allreduce__rab},
-       {"automatic", "allreduce automatic collective", (void*)allreduce__automatic}}},
+       {"analytical", "allreduce analytical model", (void*)allreduce__analytical},
+       {"automatic", "allreduce automatic collective", (void*)allreduce__automatic},
+       {"table", "allreduce table collective", (void*)allreduce__table}}},
 
      {"reduce_scatter",
       {{"default", "reduce_scatter default collective", (void*)reduce_scatter__default},
@@ -109,7 +115,8 @@ std::map<std::string, std::vector<s_mpi_coll_description_t>, std::less<>> smpi_c
        {"mpich_noncomm", "reduce_scatter mpich_noncomm collective", (void*)reduce_scatter__mpich_noncomm},
        {"mvapich2", "reduce_scatter mvapich2 collective", (void*)reduce_scatter__mvapich2},
        {"impi", "reduce_scatter impi collective", (void*)reduce_scatter__impi},
-       {"automatic", "reduce_scatter automatic collective", (void*)reduce_scatter__automatic}}},
+       {"automatic", "reduce_scatter automatic collective", (void*)reduce_scatter__automatic},
+       {"table", "reduce_scatter table collective", (void*)reduce_scatter__table}}},
 
      {"scatter",
       {{"default", "scatter default collective", (void*)scatter__default},
@@ -123,7 +130,8 @@ std::map<std::string, std::vector<s_mpi_coll_description_t>, std::less<>> smpi_c
        {"mvapich2_two_level_direct", "scatter mvapich2_two_level_direct collective",
         (void*)scatter__mvapich2_two_level_direct},
        {"impi", "scatter impi collective", (void*)scatter__impi},
-       {"automatic", "scatter automatic collective", (void*)scatter__automatic}}},
+       {"automatic", "scatter automatic collective", (void*)scatter__automatic},
+       {"table", "scatter table collective", (void*)scatter__table}}},
 
      {"barrier",
       {{"default", "barrier default collective", (void*)barrier__default},
@@ -139,7 +147,9 @@ std::map<std::string, std::vector<s_mpi_coll_description_t>, std::less<>> smpi_c
        {"mvapich2_pair", "barrier mvapich2_pair collective", (void*)barrier__mvapich2_pair},
        {"mvapich2", "barrier mvapich2 collective", (void*)barrier__mvapich2},
        {"impi", "barrier impi collective", (void*)barrier__impi},
-       {"automatic", "barrier automatic collective", (void*)barrier__automatic}}},
+       {"analytical", "barrier analytical model", (void*)barrier__analytical},
+       {"automatic", "barrier automatic collective", (void*)barrier__automatic},
+       {"table", "barrier table collective", (void*)barrier__table}}},
 
      {"alltoall",
       {{"default", "alltoall default collective", (void*)alltoall__default},
@@ -162,7 +172,9 @@ std::map<std::string, std::vector<s_mpi_coll_description_t>, std::less<>> smpi_c
        {"ompi", "alltoall ompi collective", (void*)alltoall__ompi},
        {"mpich", "alltoall mpich collective", (void*)alltoall__mpich},
        {"impi", "alltoall impi collective", (void*)alltoall__impi},
-       {"automatic", "alltoall automatic collective", (void*)alltoall__automatic}}},
+       {"analytical", "alltoall analytical model", (void*)alltoall__analytical},
+       {"automatic", "alltoall automatic collective", (void*)alltoall__automatic},
+       {"table", "alltoall table collective", (void*)alltoall__table}}},
 
      {"alltoallv",
       {{"default", "alltoallv default collective", (void*)alltoallv__default},
@@ -180,7 +192,8 @@ std::map<std::string, std::vector<s_mpi_coll_description_t>, std::less<>> smpi_c
        {"ompi_basic_linear", "alltoallv ompi_basic_linear collective", (void*)alltoallv__ompi_basic_linear},
        {"mvapich2", "alltoallv mvapich2 collective", (void*)alltoallv__mvapich2},
        {"impi", "alltoallv impi collective", (void*)alltoallv__impi},
-       {"automatic", "alltoallv automatic collective", (void*)alltoallv__automatic}}},
+       {"automatic", "alltoallv automatic collective", (void*)alltoallv__automatic},
+       {"table", "alltoallv table collective", (void*)alltoallv__table}}},
 
      {"bcast",
       {{"default", "bcast default collective", (void*)bcast__default},
@@ -209,7 +222,9 @@ std::map<std::string, std::vector<s_mpi_coll_description_t>, std::less<>> smpi_c
        {"mvapich2_knomial_intra_node", "bcast mvapich2_knomial_intra_node collective",
         (void*)bcast__mvapich2_knomial_intra_node},
        {"impi", "bcast impi collective", (void*)bcast__impi},
-       {"automatic", "bcast automatic collective", (void*)bcast__automatic}}},
+       {"analytical", "bcast analytical model", (void*)bcast__analytical},
+       {"automatic", "bcast automatic collective", (void*)bcast__automatic},
+       {"table", "bcast table collective", (void*)bcast__table}}},
 
      {"reduce",
       {{"default", "reduce default collective", (void*)reduce__default},
@@ -231,7 +246,8 @@ std::map<std::string, std::vector<s_mpi_coll_description_t>, std::less<>> smpi_c
        {"mvapich2_two_level", "reduce mvapich2_two_level collective", (void*)reduce__mvapich2_two_level},
        {"impi", "reduce impi collective", (void*)reduce__impi},
        {"rab", "reduce rab collective", (void*)reduce__rab},
-       {"automatic", "reduce automatic collective", (void*)reduce__automatic}}}});
+       {"automatic", "reduce automatic collective", (void*)reduce__automatic},
+       {"table", "reduce table collective", (void*)reduce__table}}}});
 
 // Needed by the automatic selector weird implementation
 std::vector<s_mpi_coll_description_t>* colls::get_smpi_coll_descriptions(const std::string& name)
@@ -0,0 +1,250 @@
+/* Selector using the tables of tuned algorithms saved by the automatic selector */
+
+/* Copyright (c) 2021. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "colls_private.hpp"
+#include "simgrid/s4u/Engine.hpp"
+#include "simgrid/s4u/Host.hpp"
+#include "simgrid/s4u/Link.hpp"
+#include "xbt/config.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+/* Messages are gathered in buckets of sizes between two consecutive powers of 2. The bucket 0 holds empty messages. */
+unsigned size_bucket(size_t size)
+{
+  unsigned bucket = 0;
+  while (size > 0) {
+    bucket++;
+    size >>= 1;
+  }
+  return bucket;
+}
+
+size_t bucket_lower_bound(unsigned bucket)
+{
+  return bucket == 0 ? 0 : size_t(1) << (bucket - 1);
+}
+
+std::string coll_table_file()
+{
+  return simgrid::config::get_value<std::string>("smpi/coll-table");
+}
+
+/* The best algorithms depend on the platform and on the amount of MPI processes, so the table file holds one section
+ * per platform and process count, starting with a line such as "[platform 0123456789abcdef processes 16]". The
+ * platform is identified by a hash of the names and speeds of its hosts, and of the names, bandwidths and latencies
+ * of its links. */
+std::string coll_table_signature()
+{
+  std::uint64_t hash = 14695981039346656037ULL; // 64-bit FNV-1a
+  auto mix           = [&hash](const std::string& data) {
+    for (unsigned char c : data) {
+      hash ^= c;
+      hash *= 1099511628211ULL;
+    }
+  };
+  const auto* engine = simgrid::s4u::Engine::get_instance();
+  for (auto const* host : engine->get_all_hosts())
+    mix(host->get_name() + " " + std::to_string(host->get_speed()) + "\n");
+  for (auto const* link : engine->get_all_links())
+    mix(link->get_name() + " " + std::to_string(link->get_bandwidth()) + " " + std::to_string(link->get_latency()) +
+        "\n");
+
+  std::ostringstream signature;
+  signature << "platform " << std::hex << std::setw(16) << std::setfill('0') << hash << std::dec << " processes "
+            << smpi_get_universe_size();
+  return signature.str();
+}
+
+/* Tells whether the line starts a section of the table, and gives the signature of that section */
+bool is_section_start(const std::string& line, std::string& signature)
+{
+  if (line.size() < 2 || line.front() != '[' || line.back() != ']')
+    return false;
+  signature = line.substr(1, line.size() - 2);
+  return true;
+}
+
+/** @brief Best known algorithm of a given collective, for each communicator size and bucket of message size */
+class TunedCollTable {
+  std::unordered_map<std::uint64_t, void*> algos_;
+
+  static std::uint64_t key(int comm_size, unsigned bucket) { return (std::uint64_t(comm_size) << 8) | bucket; }
+
+public:
+  void add(int comm_size, size_t size, void* coll) { algos_[key(comm_size, size_bucket(size))] = coll; }
+  void* find(int comm_size, size_t size) const
+  {
+    auto it = algos_.find(key(comm_size, size_bucket(size)));
+    return it == algos_.end() ? nullptr : it->second;
+  }
+};
+
+const TunedCollTable* get_tuned_coll_table(const std::string& collective)
+{
+  static std::map<std::string, TunedCollTable, std::less<>> tables;
+  static bool loaded = false;
+  if (not loaded) {
+    loaded               = true;
+    std::string filename = coll_table_file();
+    xbt_assert(not filename.empty(), "The table collective selector needs a table: please set smpi/coll-table.");
+    std::ifstream in(filename);
+    xbt_assert(in.is_open(), "Cannot open the table of collective algorithms %s", filename.c_str());
+    /* Only the section of the current platform and process count is used, along with the lines before the first
+     * section, that apply to any platform */
+    std::string signature = coll_table_signature();
+    std::string section;
+    bool found = false;
+    std::string line;
+    int lineno = 0;
+    while (std::getline(in, line)) {
+      lineno++;
+      if (line.empty() || line[0] == '#')
+        continue;
+      if (is_section_start(line, section)) {
+        found = found || section == signature;
+        continue;
+      }
+      if (not section.empty() && section != signature)
+        continue;
+      std::istringstream fields(line);
+      std::string coll;
+      int comm_size;
+      size_t size;
+      std::string algo;
+      xbt_assert(fields >> coll >> comm_size >> size >> algo,
+                 "%s:%d: invalid line '%s' (expected: collective communicator_size message_size algorithm)",
+                 filename.c_str(), lineno, line.c_str());
+      const auto* descriptions = simgrid::smpi::colls::get_smpi_coll_descriptions(coll);
+      auto desc = std::find_if(descriptions->begin(), descriptions->end(),
+                               [&algo](const simgrid::smpi::s_mpi_coll_description_t& d) { return d.name == algo; });
+      xbt_assert(desc != descriptions->end() && algo != "table" && algo != "automatic",
+                 "%s:%d: invalid algorithm '%s' for collective %s", filename.c_str(), lineno, algo.c_str(),
+                 coll.c_str());
+      tables[coll].add(comm_size, size, desc->coll);
+    }
+    if (not found)
+      XBT_WARN("The table of collective algorithms %s has no section for this run ([%s]). Run with the automatic "
+               "selector to fill it.",
+               filename.c_str(), signature.c_str());
+    XBT_DEBUG("Loaded the table of collective algorithms %s", filename.c_str());
+  }
+  return &tables[collective];
+}
+
+/* Sum of the timings of each algorithm (as measured by the automatic selector), per collective, communicator size
+ * and bucket of message size */
+std::map<std::tuple<std::string, int, unsigned>, std::map<std::string, double, std::less<>>> coll_timings;
+} // namespace
+
+/* Uses the algorithm given by the table for the current communicator and message sizes, or falls back to the OpenMPI
+ * selector for the cases that were not tuned */
+#define TABLE_COLL_SELECTOR(cat, ret, args, args2, msg_size)                                                           \
+  ret _XBT_CONCAT2(cat, __table)(COLL_UNPAREN args)                                                                    \
+  {                                                                                                                    \
+    static const TunedCollTable* table = get_tuned_coll_table(_XBT_STRINGIFY(cat));                                    \
+    auto coll = reinterpret_cast<ret(*) args>(table->find(comm->size(), (msg_size)));                                  \
+    if (coll == nullptr)                                                                                               \
+      coll = _XBT_CONCAT2(cat, __ompi);                                                                                \
+    return coll args2;                                                                                                 \
+  }
+
+namespace simgrid {
+namespace smpi {
+
+void colls::record_coll_timing(const std::string& collective, int comm_size, size_t size, const std::string& algo,
+                               double time)
+{
+  coll_timings[std::make_tuple(collective, comm_size, size_bucket(size))][algo] += time;
+}
+
+void colls::save_coll_table()
+{
+  std::string filename = coll_table_file();
+  if (filename.empty() || coll_timings.empty())
+    return;
+
+  /* Merge into the existing table: the sections of the other platforms and process counts are kept as is, and so are
+   * the cases of the current section that were not benchmarked in this run */
+  std::string signature = coll_table_signature();
+  std::vector<std::pair<std::string, std::vector<std::string>>> other_sections;
+  std::map<std::tuple<std::string, int, size_t>, std::string> entries;
+  std::ifstream in(filename);
+  std::string section;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#')
+      continue;
+    if (is_section_start(line, section)) {
+      if (section != signature)
+        other_sections.emplace_back(section, std::vector<std::string>());
+      continue;
+    }
+    if (section == signature) {
+      std::istringstream fields(line);
+      std::string coll;
+      int comm_size;
+      size_t size;
+      std::string algo;
+      if (fields >> coll >> comm_size >> size >> algo)
+        entries[std::make_tuple(coll, comm_size, size)] = algo;
+    } else {
+      if (other_sections.empty()) // Lines before the first section
+        other_sections.emplace_back("", std::vector<std::string>());
+      other_sections.back().second.push_back(line);
+    }
+  }
+  in.close();
+
+  for (auto const& elm : coll_timings) {
+    auto best = std::min_element(elm.second.begin(), elm.second.end(),
+                                 [](auto const& a, auto const& b) { return a.second < b.second; });
+    size_t size = bucket_lower_bound(std::get<2>(elm.first));
+    entries[std::make_tuple(std::get<0>(elm.first), std::get<1>(elm.first), size)] = best->first;
+  }
+
+  std::ofstream out(filename);
+  xbt_assert(out.is_open(), "Cannot write the table of collective algorithms into %s", filename.c_str());
+  out << "# Best algorithms found by the automatic collective selector. Use it with smpi/coll-selector:table\n"
+      << "# [platform hash processes count]\n"
+      << "# collective communicator_size message_size algorithm\n";
+  for (auto const& other : other_sections) {
+    if (not other.first.empty())
+      out << "[" << other.first << "]\n";
+    for (auto const& other_line : other.second)
+      out << other_line << "\n";
+  }
+  out << "[" << signature << "]\n";
+  for (auto const& entry : entries)
+    out << std::get<0>(entry.first) << " " << std::get<1>(entry.first) << " " << std::get<2>(entry.first) << " "
+        << entry.second << "\n";
+  XBT_INFO("Table of the best collective algorithms saved into %s", filename.c_str());
+}
+
+COLL_APPLY_TABLE(TABLE_COLL_SELECTOR, COLL_ALLGATHERV_SIG, (send_buff, send_count, send_type, recv_buff, recv_count, recv_disps, recv_type, comm), COLL_ALLGATHERV_TABLE_SIZE)
+COLL_APPLY_TABLE(TABLE_COLL_SELECTOR, COLL_ALLREDUCE_SIG, (sbuf, rbuf, rcount, dtype, op, comm), COLL_ALLREDUCE_TABLE_SIZE)
+COLL_APPLY_TABLE(TABLE_COLL_SELECTOR, COLL_GATHER_SIG, (send_buff, send_count, send_type, recv_buff, recv_count, recv_type, root, comm), COLL_GATHER_TABLE_SIZE)
+COLL_APPLY_TABLE(TABLE_COLL_SELECTOR, COLL_ALLGATHER_SIG, (send_buff, send_count, send_type, recv_buff, recv_count, recv_type, comm), COLL_ALLGATHER_TABLE_SIZE)
+COLL_APPLY_TABLE(TABLE_COLL_SELECTOR, COLL_ALLTOALL_SIG, (send_buff, send_count, send_type, recv_buff, recv_count, recv_type, comm), COLL_ALLTOALL_TABLE_SIZE)
+COLL_APPLY_TABLE(TABLE_COLL_SELECTOR, COLL_ALLTOALLV_SIG, (send_buff, send_counts, send_disps, send_type, recv_buff, recv_counts, recv_disps, recv_type, comm), COLL_ALLTOALLV_TABLE_SIZE)
+COLL_APPLY_TABLE(TABLE_COLL_SELECTOR, COLL_BCAST_SIG, (buf, count, datatype, root, comm), COLL_BCAST_TABLE_SIZE)
+COLL_APPLY_TABLE(TABLE_COLL_SELECTOR, COLL_REDUCE_SIG, (buf, rbuf, count, datatype, op, root, comm), COLL_REDUCE_TABLE_SIZE)
+COLL_APPLY_TABLE(TABLE_COLL_SELECTOR, COLL_REDUCE_SCATTER_SIG, (sbuf, rbuf, rcounts, dtype, op, comm), COLL_REDUCE_SCATTER_TABLE_SIZE)
+COLL_APPLY_TABLE(TABLE_COLL_SELECTOR, COLL_SCATTER_SIG, (sendbuf, sendcount, sendtype, recvbuf, recvcount, recvtype, root, comm), COLL_SCATTER_TABLE_SIZE)
+COLL_APPLY_TABLE(TABLE_COLL_SELECTOR, COLL_BARRIER_SIG, (comm), COLL_BARRIER_TABLE_SIZE)
+
+} // namespace smpi
+} // namespace simgrid
@@ -30,6 +30,7 @@ constexpr unsigned MPI_REQ_BSEND          = 0x2000;
 constexpr unsigned MPI_REQ_MATCHED        = 0x4000;
 constexpr unsigned MPI_REQ_CANCELLED      = 0x8000;
 constexpr unsigned MPI_REQ_NBC            = 0x10000;
+constexpr unsigned MPI_REQ_NO_PAYLOAD     = 0x20000;
 
 enum class SmpiProcessState { UNINITIALIZED, INITIALIZING, INITIALIZED /*(=MPI_Init called)*/, FINALIZED };
 
@@ -106,6 +107,7 @@ XBT_PRIVATE bool smpi_cfg_simulate_computation();
 XBT_PRIVATE SharedMallocType smpi_cfg_shared_malloc();
 XBT_PRIVATE double smpi_cfg_cpu_thresh();
 XBT_PRIVATE SmpiPrivStrategies smpi_cfg_privatization();
+XBT_PRIVATE bool smpi_cfg_skip_payload();
 XBT_PRIVATE int smpi_cfg_async_small_thresh();
 XBT_PRIVATE int smpi_cfg_detached_send_thresh();
 XBT_PRIVATE bool smpi_cfg_grow_injected_times();
@@ -115,6 +117,7 @@ XBT_PRIVATE bool smpi_cfg_trace_call_use_absolute_path();
 XBT_PRIVATE std::string smpi_cfg_comp_adjustment_file();
 XBT_PRIVATE std::string smpi_cfg_papi_events_file();
 XBT_PRIVATE double smpi_cfg_auto_shared_malloc_thresh();
+XBT_PRIVATE double smpi_cfg_zero_copy_thresh();
 XBT_PRIVATE bool smpi_cfg_display_alloc();
 
 // utilities
@@ -504,6 +507,11 @@ void smpi_execute_benched_(double* duration);
 XBT_PRIVATE int smpi_temp_shm_get();
 XBT_PRIVATE void* smpi_temp_shm_mmap(int fd, size_t size);
 
+XBT_PRIVATE void* smpi_zero_copy_malloc(size_t size);
+XBT_PRIVATE bool smpi_zero_copy_free(void* ptr);
+XBT_PRIVATE bool smpi_zero_copy(void* dst, const void* src, size_t size);
+XBT_PRIVATE void smpi_zero_copy_destroy();
+
 struct s_smpi_privatization_region_t {
   void* address;
   int file_descriptor;
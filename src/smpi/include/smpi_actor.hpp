@@ -26,6 +26,7 @@ class ActorExt {
   int sampling_ = 0; /* inside an SMPI_SAMPLE_ block? */
   std::string instance_id_;
   bool replaying_ = false; /* is the process replaying a trace */
+  int payload_needed_ = 0; /* number of ongoing SMPI-internal exchanges, whose payload is needed even with smpi/payload:none */
   smpi_trace_call_location_t trace_call_loc_;
   s4u::Actor* actor_                             = nullptr;
   smpi_privatization_region_t privatized_region_ = nullptr;
@@ -59,6 +60,18 @@ public:
   void mark_as_initialized();
   void set_replaying(bool value);
   bool replaying() const;
+  bool skip_payload() const;
+  /** @brief RAII guard forcing the actual transfer of the data exchanged by SMPI itself (communicator ids, groups,
+   * window addresses...), even when the application payloads are skipped with smpi/payload:none. */
+  class PayloadNeeded {
+    ActorExt* actor_;
+
+  public:
+    explicit PayloadNeeded(ActorExt* actor) : actor_(actor) { actor_->payload_needed_++; }
+    PayloadNeeded(const PayloadNeeded&) = delete;
+    PayloadNeeded& operator=(const PayloadNeeded&) = delete;
+    ~PayloadNeeded() { actor_->payload_needed_--; }
+  };
   void set_tracing_category(const std::string& category) { tracing_category_ = category; }
   const std::string& get_tracing_category() const { return tracing_category_; }
   smpi_trace_call_location_t* call_location();
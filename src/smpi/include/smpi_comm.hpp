@@ -18,6 +18,8 @@
 namespace simgrid{
 namespace smpi{
 
+class CollRendezvous;
+
 class Comm : public F2C, public Keyval{
   friend Topo;
   MPI_Group group_;
@@ -39,6 +41,7 @@ class Comm : public F2C, public Keyval{
   int id_;
   MPI_Errhandler errhandler_ =  _smpi_cfg_default_errhandler_is_error ? MPI_ERRORS_ARE_FATAL : MPI_ERRORS_RETURN;;
   MPI_Errhandler* errhandlers_ = nullptr; //for MPI_COMM_WORLD only
+  std::shared_ptr<CollRendezvous> coll_rendezvous_; // shared by all ranks, for the analytical collectives
 
 public:
   static std::unordered_map<int, smpi_key_elem> keyvals_;
@@ -90,6 +93,9 @@ public:
   void remove_rma_win(MPI_Win win);
   void finish_rma_calls() const;
   MPI_Comm split_type(int type, int key, const Info* info);
+
+  CollRendezvous* get_coll_rendezvous() const { return coll_rendezvous_.get(); }
+  void set_coll_rendezvous(std::shared_ptr<CollRendezvous> rendezvous) { coll_rendezvous_ = std::move(rendezvous); }
 };
 
 } // namespace smpi
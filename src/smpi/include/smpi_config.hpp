@@ -16,6 +16,7 @@ extern XBT_PRIVATE simgrid::config::Flag<bool> _smpi_cfg_simulate_computation;
 extern XBT_PRIVATE simgrid::config::Flag<std::string> _smpi_cfg_shared_malloc_string;
 extern XBT_PRIVATE simgrid::config::Flag<double> _smpi_cfg_cpu_thresh;
 extern XBT_PRIVATE simgrid::config::Flag<std::string> _smpi_cfg_privatization_string;
+extern XBT_PRIVATE simgrid::config::Flag<std::string> _smpi_cfg_payload_string;
 extern XBT_PRIVATE simgrid::config::Flag<int> _smpi_cfg_async_small_thresh;
 extern XBT_PRIVATE simgrid::config::Flag<int> _smpi_cfg_detached_send_thresh;
 extern XBT_PRIVATE simgrid::config::Flag<bool> _smpi_cfg_grow_injected_times;
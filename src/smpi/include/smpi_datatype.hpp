@@ -8,6 +8,7 @@
 
 #include "smpi_f2c.hpp"
 #include "smpi_keyvals.hpp"
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -99,6 +100,47 @@ class Datatype_contents {
   ~Datatype_contents();
 };
 
+/** @brief Flattened layout of a committed derived datatype, used to pack and unpack it without walking the type tree
+ *
+ * The blocks of basic elements are listed in the order in which they are packed, and the blocks that are contiguous
+ * in memory are merged so that they are copied at once. The first element of a datatype may be laid out differently
+ * from the next ones (e.g., the first block of an hindexed type is at its displacement, while the next elements start
+ * right after the end of the previous one), so it gets its own list of blocks.
+ */
+class DatatypePlan {
+public:
+  /* count elements of the given type, at the given offset of the noncontiguous buffer */
+  struct Run {
+    MPI_Aint offset;
+    int count;
+    MPI_Datatype type;
+  };
+  /* Types with more blocks per element are still walked recursively: compiling a plan costs about 80 bytes and 0.7us
+   * per block, and the plan halves the time to pack the type, so larger plans would take more than 5MiB and 50ms */
+  static constexpr size_t MAX_RUNS_PER_ELEMENT = 1 << 16;
+  /* compile() flattens three elements at once */
+  static constexpr size_t MAX_RUNS = 3 * MAX_RUNS_PER_ELEMENT;
+
+private:
+  struct Block {
+    MPI_Aint offset;
+    size_t length;
+  };
+  struct Layout {
+    std::vector<Block> blocks; // merged memory blocks, for plain copies
+    std::vector<Run> runs;     // merged runs of identical types, for the reduction operations
+    void add(const Run* begin, const Run* end);
+  };
+  Layout first_;
+  Layout next_;
+  MPI_Aint stride_ = 0; // distance between two consecutive elements after the first one
+
+public:
+  static std::unique_ptr<DatatypePlan> compile(Datatype* type);
+  void serialize(const void* noncontiguous, void* contiguous, int count) const;
+  void unserialize(const void* contiguous, void* noncontiguous, int count, MPI_Op op) const;
+};
+
 class Datatype : public F2C, public Keyval{
   std::string name_ = "";
   /* The id here is the (unique) datatype id used for this datastructure.
@@ -113,12 +155,14 @@ class Datatype : public F2C, public Keyval{
   int refcount_ = 1;
   std::unique_ptr<Datatype_contents> contents_ = nullptr;
   MPI_Datatype duplicated_datatype_ = MPI_DATATYPE_NULL;
+  std::unique_ptr<DatatypePlan> plan_ = nullptr;
 
 protected:
   template <typename... Args> void set_contents(Args&&... args)
   {
     contents_ = std::make_unique<Datatype_contents>(std::forward<Args>(args)...);
   }
+  const DatatypePlan* get_plan() const { return plan_.get(); }
 
 public:
   static std::unordered_map<int, smpi_key_elem> keyvals_;
@@ -157,6 +201,9 @@ public:
   virtual int clone(MPI_Datatype* type);
   virtual void serialize(const void* noncontiguous, void* contiguous, int count);
   virtual void unserialize(const void* contiguous, void* noncontiguous, int count, MPI_Op op);
+  /** @brief Appends to runs the blocks of basic elements that serialize() would copy for count elements located at
+   * offset, in the same order. Returns false if there are more than DatatypePlan::MAX_RUNS of them in total. */
+  virtual bool flatten(MPI_Aint offset, int count, std::vector<DatatypePlan::Run>& runs);
   static int keyval_create(MPI_Type_copy_attr_function* copy_fn, MPI_Type_delete_attr_function* delete_fn, int* keyval,
                            void* extra_state);
   static int keyval_free(int* keyval);
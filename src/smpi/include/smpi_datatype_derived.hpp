@@ -24,6 +24,7 @@ public:
   int clone(MPI_Datatype* type) override;
   void serialize(const void* noncontiguous, void* contiguous, int count) override;
   void unserialize(const void* contiguous_vector, void* noncontiguous_vector, int count, MPI_Op op) override;
+  bool flatten(MPI_Aint offset, int count, std::vector<DatatypePlan::Run>& runs) override;
 };
 
 class Type_Hvector: public Datatype{
@@ -41,6 +42,7 @@ public:
   int clone(MPI_Datatype* type) override;
   void serialize(const void* noncontiguous, void* contiguous, int count) override;
   void unserialize(const void* contiguous_vector, void* noncontiguous_vector, int count, MPI_Op op) override;
+  bool flatten(MPI_Aint offset, int count, std::vector<DatatypePlan::Run>& runs) override;
 };
 
 class Type_Vector : public Type_Hvector {
@@ -67,6 +69,7 @@ public:
   ~Type_Hindexed() override;
   void serialize(const void* noncontiguous, void* contiguous, int count) override;
   void unserialize(const void* contiguous_vector, void* noncontiguous_vector, int count, MPI_Op op) override;
+  bool flatten(MPI_Aint offset, int count, std::vector<DatatypePlan::Run>& runs) override;
 };
 
 class Type_Indexed : public Type_Hindexed {
@@ -91,6 +94,7 @@ public:
   ~Type_Struct() override;
   void serialize(const void* noncontiguous, void* contiguous, int count) override;
   void unserialize(const void* contiguous_vector, void* noncontiguous_vector, int count, MPI_Op op) override;
+  bool flatten(MPI_Aint offset, int count, std::vector<DatatypePlan::Run>& runs) override;
 };
 
 } // namespace smpi
@@ -7,6 +7,7 @@
 #ifndef SMPI_FILE_HPP_INCLUDED
 #define SMPI_FILE_HPP_INCLUDED
 #include "simgrid/plugins/file_system.h"
+#include "smpi_actor.hpp"
 #include "smpi_comm.hpp"
 #include "smpi_coll.hpp"
 #include "smpi_datatype.hpp"
@@ -87,8 +88,11 @@ int File::op_all(void* buf, int count, const Datatype* datatype, MPI_Status* sta
       count * datatype->get_extent(); // cheating, as we don't care about exact data location, we can skip extent
   std::vector<MPI_Offset> min_offsets(size);
   std::vector<MPI_Offset> max_offsets(size);
-  simgrid::smpi::colls::allgather(&min_offset, 1, MPI_OFFSET, min_offsets.data(), 1, MPI_OFFSET, comm_);
-  simgrid::smpi::colls::allgather(&max_offset, 1, MPI_OFFSET, max_offsets.data(), 1, MPI_OFFSET, comm_);
+  {
+    ActorExt::PayloadNeeded payload_needed(smpi_process());
+    simgrid::smpi::colls::allgather(&min_offset, 1, MPI_OFFSET, min_offsets.data(), 1, MPI_OFFSET, comm_);
+    simgrid::smpi::colls::allgather(&max_offset, 1, MPI_OFFSET, max_offsets.data(), 1, MPI_OFFSET, comm_);
+  }
   MPI_Offset min = min_offset;
   MPI_Offset max = max_offset;
   MPI_Offset tot = 0;
@@ -183,7 +187,10 @@ int File::op_all(void* buf, int count, const Datatype* datatype, MPI_Status* sta
     seek(min_offset, MPI_SEEK_SET);
     T(this, sendbuf, totreads / datatype->size(), datatype, status);
   }
-  simgrid::smpi::colls::alltoall(send_sizes.data(), 1, MPI_INT, recv_sizes.data(), 1, MPI_INT, comm_);
+  {
+    ActorExt::PayloadNeeded payload_needed(smpi_process());
+    simgrid::smpi::colls::alltoall(send_sizes.data(), 1, MPI_INT, recv_sizes.data(), 1, MPI_INT, comm_);
+  }
   int total_recv = 0;
   for (int i = 0; i < size; i++) {
     recv_disps[i] = total_recv;
@@ -118,6 +118,7 @@ public:
 
   static bool match_send(void* a, void* b, kernel::activity::CommImpl* ignored);
   static bool match_recv(void* a, void* b, kernel::activity::CommImpl* ignored);
+  static void copy_payload(kernel::activity::CommImpl* comm, void* buff, size_t buff_size);
 
   static int grequest_start( MPI_Grequest_query_function *query_fn, MPI_Grequest_free_function *free_fn, MPI_Grequest_cancel_function *cancel_fn, void *extra_state, MPI_Request *request);
   static int grequest_complete( MPI_Request request);
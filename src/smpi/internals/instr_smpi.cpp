@@ -10,16 +10,18 @@
 #include <cstdarg>
 #include <cwchar>
 #include <deque>
+#include <map>
 #include <simgrid/sg_config.hpp>
 #include <simgrid/s4u/Host.hpp>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "src/smpi/include/smpi_actor.hpp"
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(instr_smpi, instr, "Tracing SMPI");
 
-static std::unordered_map<std::string, std::deque<std::string>> keys;
+static std::map<std::tuple<aid_t, aid_t, int, int>, std::deque<std::string>> keys;
 
 static const std::map<std::string, std::string, std::less<>> smpi_colors = {{"recv", "1 0 0"},
                                                                             {"irecv", "1 0.52 0.52"},
@@ -96,9 +98,30 @@ static const char* instr_find_color(const char* c_state)
   return "0.5 0.5 0.5"; // Just in case we find nothing in the map ...
 }
 
+static simgrid::instr::ActorContainerExt* smpi_container_ext(aid_t pid)
+{
+  simgrid::s4u::Actor* actor = simgrid::s4u::Actor::self();
+  if (actor->get_pid() != pid)
+    actor = simgrid::s4u::Actor::by_pid(pid).get();
+  xbt_assert(actor != nullptr, "Could not find the actor of mpi rank 'rank-%ld'", pid);
+  return actor->extension<simgrid::instr::ActorContainerExt>();
+}
+
 XBT_PRIVATE simgrid::instr::Container* smpi_container(aid_t pid)
 {
-  return simgrid::instr::Container::by_name(std::string("rank-") + std::to_string(pid));
+  return smpi_container_ext(pid)->rank;
+}
+
+static simgrid::instr::StateType* smpi_state(aid_t pid)
+{
+  const auto* ext = smpi_container_ext(pid);
+  return ext->rank->get_state(ext->mpi_state);
+}
+
+static simgrid::instr::LinkType* smpi_link()
+{
+  // Not cached: the type is destroyed along with the root container, that a later simulation recreates
+  return simgrid::instr::Container::get_root()->get_link("MPI_LINK");
 }
 
 static std::string TRACE_smpi_put_key(aid_t src, aid_t dst, int tag, int send)
@@ -110,9 +133,7 @@ static std::string TRACE_smpi_put_key(aid_t src, aid_t dst, int tag, int send)
       std::to_string(src) + "_" + std::to_string(dst) + "_" + std::to_string(tag) + "_" + std::to_string(counter);
 
   //push it
-  std::string aux =
-      std::to_string(src) + "#" + std::to_string(dst) + "#" + std::to_string(tag) + "#" + std::to_string(send);
-  keys[aux].push_back(key);
+  keys[std::make_tuple(src, dst, tag, send)].push_back(key);
 
   return key;
 }
@@ -120,9 +141,7 @@ static std::string TRACE_smpi_put_key(aid_t src, aid_t dst, int tag, int send)
 static std::string TRACE_smpi_get_key(aid_t src, aid_t dst, int tag, int send)
 {
   std::string key;
-  std::string aux = std::to_string(src) + "#" + std::to_string(dst) + "#" + std::to_string(tag) + "#" +
-                    std::to_string(send == 1 ? 0 : 1);
-  auto it = keys.find(aux);
+  auto it = keys.find(std::make_tuple(src, dst, tag, send == 1 ? 0 : 1));
   if (it == keys.end()) {
     // first posted
     key = TRACE_smpi_put_key(src, dst, tag, send);
@@ -139,10 +158,15 @@ void TRACE_smpi_setup_container(aid_t pid, const_sg_host_t host)
 {
   auto* parent = simgrid::instr::Container::get_root();
   if (TRACE_smpi_is_grouped()) {
-    parent = simgrid::instr::Container::by_name_or_null(host->get_name());
-    xbt_assert(parent != nullptr, "Could not find a parent for mpi rank 'rank-%ld' at function %s", pid, __func__);
+    const auto* host_ext = host->extension<simgrid::instr::HostContainerExt>();
+    xbt_assert(host_ext != nullptr, "Could not find a parent for mpi rank 'rank-%ld' at function %s", pid, __func__);
+    parent = host_ext->container;
   }
-  parent->create_child(std::string("rank-") + std::to_string(pid), "MPI"); // This container is of type MPI
+  // This container is of type MPI
+  simgrid::instr::Container* rank = parent->create_child(std::string("rank-") + std::to_string(pid), "MPI");
+  auto* ext       = simgrid::instr::ActorContainerExt::get(*simgrid::s4u::Actor::self());
+  ext->rank       = rank;
+  ext->mpi_state  = static_cast<simgrid::instr::StateType*>(rank->type_->by_name("MPI_STATE"));
 }
 
 void TRACE_smpi_init(aid_t pid, const std::string& calling_func)
@@ -153,9 +177,13 @@ void TRACE_smpi_init(aid_t pid, const std::string& calling_func)
   auto self = simgrid::s4u::Actor::self();
 
   TRACE_smpi_setup_container(pid, sg_host_self());
-  simgrid::s4u::this_actor::on_exit([self](bool) { smpi_container(self->get_pid())->remove_from_parent(); });
+  simgrid::s4u::this_actor::on_exit([self](bool) {
+    auto* ext = self->extension<simgrid::instr::ActorContainerExt>();
+    ext->rank->remove_from_parent();
+    ext->rank = nullptr;
+  });
 
-  simgrid::instr::StateType* state = smpi_container(pid)->get_state("MPI_STATE");
+  simgrid::instr::StateType* state = smpi_state(pid);
 
   state->add_entity_value(calling_func, instr_find_color(calling_func.c_str()));
   state->push_event(calling_func, new simgrid::instr::NoOpTIData("init"));
@@ -182,15 +210,13 @@ void TRACE_smpi_init(aid_t pid, const std::string& calling_func)
 void TRACE_smpi_sleeping_in(aid_t pid, double duration)
 {
   if (TRACE_smpi_is_enabled() && TRACE_smpi_is_sleeping())
-    smpi_container(pid)
-        ->get_state("MPI_STATE")
-        ->push_event("sleeping", new simgrid::instr::CpuTIData("sleep", duration));
+    smpi_state(pid)->push_event("sleeping", new simgrid::instr::CpuTIData("sleep", duration));
 }
 
 void TRACE_smpi_sleeping_out(aid_t pid)
 {
   if (TRACE_smpi_is_enabled() && TRACE_smpi_is_sleeping())
-    smpi_container(pid)->get_state("MPI_STATE")->pop_event();
+    smpi_state(pid)->pop_event();
 }
 
 void TRACE_smpi_comm_in(aid_t pid, const char* operation, simgrid::instr::TIData* extra)
@@ -200,7 +226,7 @@ void TRACE_smpi_comm_in(aid_t pid, const char* operation, simgrid::instr::TIData
     return;
   }
 
-  simgrid::instr::StateType* state = smpi_container(pid)->get_state("MPI_STATE");
+  simgrid::instr::StateType* state = smpi_state(pid);
   state->add_entity_value(operation, instr_find_color(operation));
   state->push_event(operation, extra);
 }
@@ -208,7 +234,7 @@ void TRACE_smpi_comm_in(aid_t pid, const char* operation, simgrid::instr::TIData
 void TRACE_smpi_comm_out(aid_t pid)
 {
   if (TRACE_smpi_is_enabled())
-    smpi_container(pid)->get_state("MPI_STATE")->pop_event();
+    smpi_state(pid)->pop_event();
 }
 
 void TRACE_smpi_send(aid_t rank, aid_t src, aid_t dst, int tag, size_t size)
@@ -219,7 +245,7 @@ void TRACE_smpi_send(aid_t rank, aid_t src, aid_t dst, int tag, size_t size)
   std::string key = TRACE_smpi_get_key(src, dst, tag, 1);
 
   XBT_DEBUG("Send tracing from %ld to %ld, tag %d, with key %s", src, dst, tag, key.c_str());
-  simgrid::instr::Container::get_root()->get_link("MPI_LINK")->start_event(smpi_container(rank), "PTP", key, size);
+  smpi_link()->start_event(smpi_container(rank), "PTP", key, size);
 }
 
 void TRACE_smpi_recv(aid_t src, aid_t dst, int tag)
@@ -230,5 +256,5 @@ void TRACE_smpi_recv(aid_t src, aid_t dst, int tag)
   std::string key = TRACE_smpi_get_key(src, dst, tag, 0);
 
   XBT_DEBUG("Recv tracing from %ld to %ld, tag %d, with key %s", src, dst, tag, key.c_str());
-  simgrid::instr::Container::get_root()->get_link("MPI_LINK")->end_event(smpi_container(dst), "PTP", key);
+  smpi_link()->end_event(smpi_container(dst), "PTP", key);
 }
@@ -111,6 +111,12 @@ bool ActorExt::replaying() const
   return replaying_;
 }
 
+/** @brief Whether the data of the messages sent or received by this process should neither be copied nor reduced */
+bool ActorExt::skip_payload() const
+{
+  return replaying_ || (smpi_cfg_skip_payload() && payload_needed_ == 0);
+}
+
 s4u::ActorPtr ActorExt::get_actor()
 {
   return actor_;
@@ -18,6 +18,10 @@
 #include "xbt/file.hpp"
 
 #include "src/smpi/include/smpi_actor.hpp"
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
 #include <unordered_map>
 
 #ifndef WIN32
@@ -37,6 +41,12 @@ static simgrid::config::Flag<double>
                      "Minimum time to inject inside a call to MPI_Wtime(), gettimeofday() and clock_gettime()",
                      1e-8 /* Documented to be 10 ns */);
 
+static simgrid::config::Flag<std::string>
+    smpi_sample_file("smpi/sample-file",
+                     "File where the statistics of the SMPI_SAMPLE_* blocks are loaded from at startup and saved to at "
+                     "exit, so that later runs do not benchmark them again",
+                     "");
+
 // Private execute_flops used by smpi_execute and smpi_execute_benched
 void private_execute_flops(double flops) {
   xbt_assert(flops >= 0, "You're trying to execute a negative amount of flops (%f)!", flops);
@@ -290,6 +300,7 @@ public:
   bool benching;    /* true: we are benchmarking; false: we have enough data, no bench anymore */
 
   bool need_more_benchs() const;
+  void update_stats();
 };
 
 bool LocalData::need_more_benchs() const
@@ -301,9 +312,77 @@ bool LocalData::need_more_benchs() const
   return res;
 }
 
+void LocalData::update_stats()
+{
+  double n  = count;
+  mean      = sum / n;
+  relstderr = sqrt((sum_pow2 / n - mean * mean) / n) / mean;
+}
+
 std::unordered_map<SampleLocation, LocalData, std::hash<std::string>> samples;
+
+/* Statistics of the sampled blocks given by smpi/sample-file, for each host speed and sample location. The durations
+ * are only meaningful for the host speed with which they were measured. */
+struct SavedSample {
+  int count;
+  double sum;
+  double sum_pow2;
+};
+std::map<std::pair<double, std::string>, SavedSample> saved_samples;
+
+void load_saved_samples()
+{
+  static bool loaded = false;
+  if (loaded || smpi_sample_file.get().empty())
+    return;
+  loaded = true;
+
+  std::ifstream in(smpi_sample_file.get());
+  if (not in.is_open()) {
+    XBT_DEBUG("No sample file %s yet, all sampled blocks will be benchmarked", smpi_sample_file.get().c_str());
+    return;
+  }
+  std::string line;
+  int lineno = 0;
+  while (std::getline(in, line)) {
+    lineno++;
+    if (line.empty() || line[0] == '#')
+      continue;
+    std::istringstream fields(line);
+    double host_speed;
+    SavedSample sample;
+    std::string location;
+    xbt_assert((fields >> host_speed >> sample.count >> sample.sum >> sample.sum_pow2) &&
+                   std::getline(fields >> std::ws, location) && sample.count > 0,
+               "%s:%d: invalid line '%s' (expected: host_speed count sum sum_of_squares location)",
+               smpi_sample_file.get().c_str(), lineno, line.c_str());
+    saved_samples[std::make_pair(host_speed, location)] = sample;
+  }
+  XBT_DEBUG("Loaded %zu sampled blocks from %s", saved_samples.size(), smpi_sample_file.get().c_str());
 }
 
+void save_samples()
+{
+  if (smpi_sample_file.get().empty() || samples.empty())
+    return;
+
+  for (auto const& elm : samples)
+    if (elm.second.count > 0)
+      saved_samples[std::make_pair(smpi_cfg_host_speed(), elm.first)] = {elm.second.count, elm.second.sum,
+                                                                         elm.second.sum_pow2};
+  std::ofstream out(smpi_sample_file.get());
+  xbt_assert(out.is_open(), "Cannot write the statistics of the sampled blocks into %s",
+             smpi_sample_file.get().c_str());
+  out.precision(std::numeric_limits<double>::max_digits10);
+  out << "# Statistics of the SMPI_SAMPLE_* blocks. Use it with smpi/sample-file\n"
+      << "# host_speed count sum sum_of_squares location\n";
+  for (auto const& elm : saved_samples)
+    out << elm.first.first << " " << elm.second.count << " " << elm.second.sum << " " << elm.second.sum_pow2 << " "
+        << elm.first.second << "\n";
+  XBT_INFO("Statistics of the sampled blocks saved into %s", smpi_sample_file.get().c_str());
+}
+} // namespace
+
 void smpi_sample_1(int global, const char *file, const char *tag, int iters, double threshold)
 {
   SampleLocation loc(global, file, tag);
@@ -326,6 +405,18 @@ void smpi_sample_1(int global, const char *file, const char *tag, int iters, dou
     XBT_DEBUG("XXXXX First time ever on benched nest %s.", loc.c_str());
     xbt_assert(threshold > 0 || iters > 0,
         "You should provide either a positive amount of iterations to bench, or a positive maximal stderr (or both)");
+    load_saved_samples();
+    auto saved = saved_samples.find(std::make_pair(smpi_cfg_host_speed(), loc));
+    if (saved != saved_samples.end()) {
+      LocalData& data = insert.first->second;
+      data.count      = saved->second.count;
+      data.sum        = saved->second.sum;
+      data.sum_pow2   = saved->second.sum_pow2;
+      data.update_stats();
+      data.benching = data.need_more_benchs();
+      XBT_DEBUG("Got %d benchs of %s from a previous run. %s", data.count, loc.c_str(),
+                (data.benching ? "more benching needed" : "we have enough data, skip computes"));
+    }
   } else {
     LocalData& data = insert.first->second;
     if (data.iters != iters || data.threshold != threshold) {
@@ -400,9 +491,7 @@ void smpi_sample_3(int global, const char *file, const char* tag)
   double period  = xbt_os_timer_elapsed(smpi_process()->timer());
   data.sum      += period;
   data.sum_pow2 += period * period;
-  double n       = data.count;
-  data.mean      = data.sum / n;
-  data.relstderr = sqrt((data.sum_pow2 / n - data.mean * data.mean) / n) / data.mean;
+  data.update_stats();
 
   XBT_DEBUG("Average mean after %d steps is %f, relative standard error is %f (sample was %f)",
             data.count, data.mean, data.relstderr, period);
@@ -462,7 +551,9 @@ void smpi_trace_set_call_location__(const char* file, const int* line)
 
 void smpi_bench_destroy()
 {
+  save_samples();
   samples.clear();
+  saved_samples.clear();
 }
 
 int smpi_getopt_long_only (int argc,  char *const *argv,  const char *options,
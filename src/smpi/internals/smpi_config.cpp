@@ -32,6 +32,7 @@ constexpr bool HAVE_WORKING_MMAP = true;
 
 SharedMallocType _smpi_cfg_shared_malloc = SharedMallocType::GLOBAL;
 SmpiPrivStrategies _smpi_cfg_privatization = SmpiPrivStrategies::NONE;
+bool _smpi_cfg_skip_payload                = false;
 double _smpi_cfg_host_speed;
 
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(smpi_config, smpi, "Logging specific to SMPI (config)");
@@ -62,6 +63,17 @@ simgrid::config::Flag<std::string> _smpi_cfg_shared_malloc_string{
     } 
   } };
 
+simgrid::config::Flag<std::string> _smpi_cfg_payload_string{
+    "smpi/payload",
+    "Whether the data exchanged by the application are actually copied and reduced ('full'), or only simulated "
+    "('none')",
+    "full",
+    std::map<std::string, std::string, std::less<>>({
+        {"full", "Copy the message payloads, and apply the reduction operations (default)"},
+        {"none", "Only simulate the timings: buffers are neither copied nor reduced"},
+    }),
+    [](const std::string& val) { _smpi_cfg_skip_payload = (val == "none"); }};
+
 simgrid::config::Flag<double> _smpi_cfg_cpu_threshold{
   "smpi/cpu-threshold", "Minimal computation time (in seconds) not discarded, or -1 for infinity.", 1e-6,
   [](const double& val){
@@ -122,6 +134,12 @@ simgrid::config::Flag<double> _smpi_cfg_auto_shared_malloc_thresh("smpi/auto-sha
                                                                   "Threshold size for the automatic sharing of memory",
                                                                   0);
 
+simgrid::config::Flag<double> _smpi_cfg_zero_copy_thresh("smpi/zero-copy-thresh",
+                                                          "Minimal size of the messages whose payload is transferred by "
+                                                          "remapping the pages of buffers allocated with MPI_Alloc_mem "
+                                                          "(0 to always copy the payload)",
+                                                          0);
+
 simgrid::config::Flag<bool> _smpi_cfg_display_alloc("smpi/display-allocs",
                                                     "Whether we should display a memory allocations analysis after simulation.",
                                                      false);
@@ -150,6 +168,10 @@ SmpiPrivStrategies smpi_cfg_privatization(){
   return _smpi_cfg_privatization;
 }
 
+bool smpi_cfg_skip_payload(){
+  return _smpi_cfg_skip_payload;
+}
+
 int smpi_cfg_async_small_thresh(){
   return _smpi_cfg_async_small_thresh;
 }
@@ -190,6 +212,10 @@ double smpi_cfg_auto_shared_malloc_thresh(){
   return _smpi_cfg_auto_shared_malloc_thresh;
 }
 
+double smpi_cfg_zero_copy_thresh(){
+  return _smpi_cfg_zero_copy_thresh;
+}
+
 // public version declared in smpi.h (without parameter, and with C linkage)
 void smpi_init_options()
 {
@@ -212,6 +238,10 @@ void smpi_init_options_internal(bool called_by_smpi_main)
   simgrid::config::declare_flag<std::string>("smpi/tmpdir", "tmp dir for dlopen files", "/tmp");
 
   simgrid::config::declare_flag<std::string>("smpi/coll-selector", "Which collective selector to use", "default");
+  simgrid::config::declare_flag<std::string>("smpi/coll-table",
+                                             "File where the automatic selector saves the best collective algorithms, "
+                                             "and from which the table selector reads them",
+                                             "");
   simgrid::config::declare_flag<std::string>("smpi/gather", "Which collective to use for gather", "");
   simgrid::config::declare_flag<std::string>("smpi/allgather", "Which collective to use for allgather", "");
   simgrid::config::declare_flag<std::string>("smpi/barrier", "Which collective to use for barrier", "");
@@ -293,6 +323,9 @@ void smpi_check_options()
              smpi_cfg_async_small_thresh(),
              smpi_cfg_detached_send_thresh());
 
+  xbt_assert(smpi_cfg_privatization() != SmpiPrivStrategies::MMAP || not SIMIX_context_is_parallel(),
+             "smpi/privatization:mmap cannot be used with contexts/nthreads > 1.");
+
   if (simgrid::config::is_default("smpi/host-speed") && not MC_is_active()) {
     XBT_INFO("You did not set the power of the host running the simulation.  "
              "The timings will certainly not be accurate.  "
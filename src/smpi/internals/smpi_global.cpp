@@ -168,6 +168,10 @@ void smpi_comm_copy_buffer_callback(simgrid::kernel::activity::CommImpl* comm, v
   std::vector<std::pair<size_t, size_t>> src_private_blocks;
   std::vector<std::pair<size_t, size_t>> dst_private_blocks;
   XBT_DEBUG("Copy the data over");
+  if (smpi_zero_copy(comm->dst_buff_, buff, buff_size)) {
+    smpi_cleanup_comm_after_copy(comm, buff);
+    return;
+  }
   if(smpi_is_shared(buff, src_private_blocks, &src_offset)) {
     src_private_blocks = shift_and_frame_private_blocks(src_private_blocks, src_offset, buff_size);
     if (src_private_blocks.empty()) { // simple shared malloc ... return.
@@ -580,7 +584,7 @@ int smpi_main(const char* executable, int argc, char* argv[])
   if (MC_is_active()) {
     MC_run();
   } else {
-    simgrid::kernel::EngineImpl::get_instance()->run();
+    simgrid::kernel::EngineImpl::get_instance()->run(-1);
 
     xbt_os_walltimer_stop(global_timer);
     simgrid::smpi::utils::print_time_analysis(xbt_os_timer_elapsed(global_timer));
@@ -614,7 +618,9 @@ void SMPI_finalize()
 {
   smpi_bench_destroy();
   smpi_shared_destroy();
+  smpi_zero_copy_destroy();
   smpi_deployment_cleanup_instances();
+  simgrid::smpi::colls::save_coll_table();
 
   if (simgrid::smpi::colls::smpi_coll_cleanup_callback != nullptr)
     simgrid::smpi::colls::smpi_coll_cleanup_callback();
@@ -0,0 +1,223 @@
+/* Copyright (c) 2021. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Zero-copy transfers of large messages.
+ *
+ * Since all simulated processes live in the same address space, the payload of a large message can be transferred
+ * by mapping the pages of the receive buffer onto the memory that holds the send buffer, instead of copying it.
+ *
+ * This is only done for the buffers allocated with MPI_Alloc_mem when smpi/zero-copy-thresh is set. Each of these
+ * allocations is backed by its own shm file, that is first mapped in shared mode: the writes of the application land
+ * in that file. The first time that an allocation takes part in a transfer, it is remapped in private mode onto that
+ * file. Its content does not change, but the file is frozen: any later write to a page gives it a private copy.
+ * The pages of the receive buffer are then mapped privately onto the same file, so that both buffers share the same
+ * physical pages until one of them writes into it.
+ *
+ * We remember the file (and offset) that each page of an allocation was mapped from. A page that was not written since
+ * then still holds the content of that file, and can be transferred again by remapping it. This is checked through
+ * /proc/self/pagemap, so this only works on Linux. Other pages, and the parts of the buffers that do not cover whole
+ * pages, are copied.
+ */
+
+#include "private.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+XBT_LOG_NEW_DEFAULT_SUBCATEGORY(smpi_zero_copy, smpi, "Logging specific to SMPI (zero-copy transfers)");
+
+namespace {
+/** A shm file holding the pages of some allocations, closed once no page is mapped from it anymore */
+class ShmFile {
+  int fd_;
+
+public:
+  explicit ShmFile(int fd) : fd_(fd) {}
+  ShmFile(const ShmFile&) = delete;
+  ShmFile& operator=(const ShmFile&) = delete;
+  ~ShmFile() { close(fd_); }
+  int get_fd() const { return fd_; }
+};
+
+/** Where a page of an allocation was mapped from */
+struct PageSource {
+  std::shared_ptr<ShmFile> file;
+  off_t offset;
+};
+
+struct ZeroCopyAllocation {
+  size_t size;
+  bool shared = true; // whether the allocation is still mapped in shared mode onto its own file
+  std::vector<PageSource> pages;
+};
+
+std::map<char*, ZeroCopyAllocation> zero_copy_allocs;
+std::mutex zero_copy_mutex; // Protects zero_copy_allocs and the mappings, as the ranks may run in parallel threads
+using zero_copy_alloc_type = decltype(zero_copy_allocs)::value_type;
+
+/* Returns the allocation that holds the whole [ptr, ptr + size) range, if any */
+zero_copy_alloc_type* find_allocation(const void* ptr, size_t size)
+{
+  auto* addr = const_cast<char*>(static_cast<const char*>(ptr));
+  auto it    = zero_copy_allocs.upper_bound(addr);
+  if (it == zero_copy_allocs.begin())
+    return nullptr;
+  --it;
+  if (addr + size > it->first + it->second.size)
+    return nullptr;
+  return &*it;
+}
+
+void map_private(char* addr, size_t size, const PageSource& source)
+{
+  const void* mem =
+      mmap(addr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, source.file->get_fd(), source.offset);
+  xbt_assert(mem == addr, "Failed to remap %zu bytes at %p: %s", size, addr, strerror(errno));
+}
+
+/* Remaps an allocation in private mode onto its own file: its content does not change, but the file is frozen */
+void freeze(zero_copy_alloc_type& alloc)
+{
+  if (alloc.second.shared) {
+    map_private(alloc.first, alloc.second.size, alloc.second.pages.front());
+    alloc.second.shared = false;
+  }
+}
+
+/* Tells which of the given pages were not written since they were mapped, i.e., still hold the content of the file
+ * they were mapped from. Returns false if this cannot be known. */
+bool get_clean_pages(const char* addr, size_t count, std::vector<bool>& clean)
+{
+#ifdef __linux__
+  constexpr uint64_t PAGE_PRESENT = 1ULL << 63;
+  constexpr uint64_t PAGE_SWAPPED = 1ULL << 62;
+  constexpr uint64_t PAGE_FILE    = 1ULL << 61;
+  static int pagemap              = open("/proc/self/pagemap", O_RDONLY);
+  if (pagemap < 0)
+    return false;
+  std::vector<uint64_t> entries(count);
+  auto offset = static_cast<off_t>(reinterpret_cast<uintptr_t>(addr) / xbt_pagesize * sizeof(uint64_t));
+  if (pread(pagemap, entries.data(), count * sizeof(uint64_t), offset) != static_cast<ssize_t>(count * sizeof(uint64_t)))
+    return false;
+  clean.resize(count);
+  for (size_t i = 0; i < count; i++) // private copies of the pages are anonymous pages, either present or swapped
+    clean[i] = (entries[i] & PAGE_FILE) || not(entries[i] & (PAGE_PRESENT | PAGE_SWAPPED));
+  return true;
+#else
+  return false;
+#endif
+}
+} // namespace
+
+void* smpi_zero_copy_malloc(size_t size)
+{
+  double thresh = smpi_cfg_zero_copy_thresh();
+  if (thresh <= 0 || static_cast<double>(size) < thresh)
+    return nullptr;
+
+  auto page    = static_cast<size_t>(xbt_pagesize);
+  size_t npages = (size + page - 1) / page;
+  auto file     = std::make_shared<ShmFile>(smpi_temp_shm_get());
+  auto* mem     = static_cast<char*>(smpi_temp_shm_mmap(file->get_fd(), npages * page));
+
+  const std::lock_guard<std::mutex> lock(zero_copy_mutex);
+  ZeroCopyAllocation& alloc = zero_copy_allocs[mem];
+  alloc.size                = npages * page;
+  alloc.pages.reserve(npages);
+  for (size_t i = 0; i < npages; i++)
+    alloc.pages.push_back({file, static_cast<off_t>(i * page)});
+  XBT_DEBUG("Allocated %zu bytes at %p for zero-copy transfers", size, mem);
+  return mem;
+}
+
+bool smpi_zero_copy_free(void* ptr)
+{
+  const std::lock_guard<std::mutex> lock(zero_copy_mutex);
+  auto it = zero_copy_allocs.find(static_cast<char*>(ptr));
+  if (it == zero_copy_allocs.end())
+    return false;
+  munmap(it->first, it->second.size);
+  zero_copy_allocs.erase(it);
+  return true;
+}
+
+/** @brief Transfers size bytes from src to dst by remapping pages when possible
+ *
+ * Returns false (and does not touch the buffers) when the zero-copy path does not apply, in which case the payload
+ * should be copied as usual.
+ */
+bool smpi_zero_copy(void* dst, const void* src, size_t size)
+{
+  if (static_cast<double>(size) < smpi_cfg_zero_copy_thresh())
+    return false;
+  const std::lock_guard<std::mutex> lock(zero_copy_mutex);
+  if (zero_copy_allocs.empty())
+    return false;
+
+  auto page       = static_cast<size_t>(xbt_pagesize);
+  auto* src_addr  = static_cast<const char*>(src);
+  auto* dst_addr  = static_cast<char*>(dst);
+  auto* src_alloc = find_allocation(src, size);
+  auto* dst_alloc = find_allocation(dst, size);
+  if (src_alloc == nullptr || dst_alloc == nullptr || (src_addr < dst_addr + size && dst_addr < src_addr + size) ||
+      reinterpret_cast<uintptr_t>(src) % page != reinterpret_cast<uintptr_t>(dst) % page)
+    return false;
+
+  size_t head  = (page - reinterpret_cast<uintptr_t>(src) % page) % page;
+  size_t count = head < size ? (size - head) / page : 0;
+  if (count == 0)
+    return false;
+
+  std::vector<bool> clean;
+  if (src_alloc->second.shared)
+    clean.assign(count, true);
+  else if (not get_clean_pages(src_addr + head, count, clean))
+    return false;
+  freeze(*src_alloc);
+  freeze(*dst_alloc);
+
+  const PageSource* src_pages = &src_alloc->second.pages[(src_addr + head - src_alloc->first) / page];
+  PageSource* dst_pages       = &dst_alloc->second.pages[(dst_addr + head - dst_alloc->first) / page];
+  size_t remapped             = 0;
+  memcpy(dst_addr, src_addr, head);
+  for (size_t i = 0; i < count;) {
+    size_t j = i + 1;
+    if (clean[i]) {
+      while (j < count && clean[j] && src_pages[j].file == src_pages[i].file &&
+             src_pages[j].offset == src_pages[i].offset + static_cast<off_t>((j - i) * page))
+        j++;
+      map_private(dst_addr + head + i * page, (j - i) * page, src_pages[i]);
+      std::copy(src_pages + i, src_pages + j, dst_pages + i);
+      remapped += j - i;
+    } else {
+      while (j < count && not clean[j])
+        j++;
+      memcpy(dst_addr + head + i * page, src_addr + head + i * page, (j - i) * page);
+    }
+    i = j;
+  }
+  size_t tail = head + count * page;
+  memcpy(dst_addr + tail, src_addr + tail, size - tail);
+  XBT_DEBUG("Transferred %zu bytes from %p to %p by remapping %zu pages out of %zu", size, src, dst, remapped, count);
+  return true;
+}
+
+void smpi_zero_copy_destroy()
+{
+  const std::lock_guard<std::mutex> lock(zero_copy_mutex);
+  for (auto const& alloc : zero_copy_allocs)
+    munmap(alloc.first, alloc.second.size);
+  zero_copy_allocs.clear();
+}
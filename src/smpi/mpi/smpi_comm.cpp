@@ -47,6 +47,7 @@ Comm::Comm(MPI_Group group, MPI_Topology topo, bool smp, int in_id)
     this->add_f();
     group->c2f();
     int id;
+    ActorExt::PayloadNeeded payload_needed(smpi_process());
     if(this->rank()==0){
       static int global_id_ = 0;
       id=global_id_;
@@ -264,6 +265,7 @@ MPI_Comm Comm::split(int color, int key)
   if (this == MPI_COMM_UNINITIALIZED)
     return smpi_process()->comm_world()->split(color, key);
   int system_tag = -123;
+  ActorExt::PayloadNeeded payload_needed(smpi_process());
 
   MPI_Group group_root = nullptr;
   MPI_Group group_out  = nullptr;
@@ -411,6 +413,7 @@ void Comm::init_smp(){
     replaying = true;
     smpi_process()->set_replaying(false);
   }
+  ActorExt::PayloadNeeded payload_needed(smpi_process());
 
   // we need to switch as the called function may silently touch global variables
   smpi_switch_data_segment(s4u::Actor::self());
@@ -237,6 +237,8 @@ void Datatype::unref(MPI_Datatype datatype)
 void Datatype::commit()
 {
   flags_ |= DT_FLAG_COMMITED;
+  if ((flags_ & DT_FLAG_DERIVED) && plan_ == nullptr)
+    plan_ = DatatypePlan::compile(this);
 }
 
 bool Datatype::is_valid() const
@@ -359,9 +361,11 @@ int Datatype::copy(const void* sendbuf, int sendcount, MPI_Datatype sendtype, vo
     sendcount *= sendtype->size();
     recvcount *= recvtype->size();
     int count = sendcount < recvcount ? sendcount : recvcount;
-    XBT_DEBUG("Copying %d bytes from %p to %p", count, sendbuf, recvbuf);
-    if (not(sendtype->flags() & DT_FLAG_DERIVED) && not(recvtype->flags() & DT_FLAG_DERIVED)) {
-      if (not smpi_process()->replaying() && count > 0)
+    if (smpi_process()->skip_payload()) {
+      XBT_DEBUG("Not copying %d bytes from %p to %p: payloads are skipped", count, sendbuf, recvbuf);
+    } else if (not(sendtype->flags() & DT_FLAG_DERIVED) && not(recvtype->flags() & DT_FLAG_DERIVED)) {
+      XBT_DEBUG("Copying %d bytes from %p to %p", count, sendbuf, recvbuf);
+      if (count > 0)
         memcpy(recvbuf, sendbuf, count);
     } else if (not(sendtype->flags() & DT_FLAG_DERIVED)) {
       recvtype->unserialize(sendbuf, recvbuf, count / recvtype->size(), MPI_REPLACE);
@@ -394,6 +398,105 @@ void Datatype::unserialize(const void* contiguous_buf, void *noncontiguous_buf,
     op->apply( contiguous_buf_char, noncontiguous_buf_char, &n, this);
 }
 
+bool Datatype::flatten(MPI_Aint offset, int count, std::vector<DatatypePlan::Run>& runs)
+{
+  runs.push_back({offset + lb_, count, this});
+  return runs.size() <= DatatypePlan::MAX_RUNS;
+}
+
+void DatatypePlan::Layout::add(const Run* begin, const Run* end)
+{
+  for (const Run* run = begin; run != end; ++run) {
+    size_t length = run->count * run->type->size();
+    if (length == 0)
+      continue;
+    if (not blocks.empty() && blocks.back().offset + static_cast<MPI_Aint>(blocks.back().length) == run->offset)
+      blocks.back().length += length;
+    else
+      blocks.push_back({run->offset, length});
+    if (not runs.empty() && runs.back().type == run->type &&
+        runs.back().offset + static_cast<MPI_Aint>(runs.back().count * run->type->size()) == run->offset)
+      runs.back().count += run->count;
+    else
+      runs.push_back(*run);
+  }
+}
+
+std::unique_ptr<DatatypePlan> DatatypePlan::compile(Datatype* type)
+{
+  /* Flatten three elements: the first one may be special, and the third one must be the second one shifted */
+  std::vector<Run> runs;
+  if (not type->flatten(0, 3, runs)) {
+    XBT_DEBUG("Datatype %s has more than %zu blocks per element, it is not compiled into a plan", type->name().c_str(),
+              MAX_RUNS_PER_ELEMENT);
+    return nullptr;
+  }
+  size_t n      = runs.size() / 3;
+  auto plan     = std::make_unique<DatatypePlan>();
+  plan->stride_ = n > 0 ? runs[2 * n].offset - runs[n].offset : 0;
+  bool regular  = runs.size() % 3 == 0;
+  for (size_t i = 0; regular && i < n; i++) {
+    const Run& second = runs[n + i];
+    const Run& third  = runs[2 * n + i];
+    regular = third.offset - second.offset == plan->stride_ && third.count == second.count && third.type == second.type;
+  }
+  if (not regular) {
+    XBT_DEBUG("The elements of datatype %s are not laid out regularly, it is not compiled into a plan",
+              type->name().c_str());
+    return nullptr;
+  }
+  plan->first_.add(runs.data(), runs.data() + n);
+  plan->next_.add(runs.data() + n, runs.data() + 2 * n);
+  XBT_DEBUG("Compiled the plan of datatype %s: %zu blocks (%zu for the first element)", type->name().c_str(),
+            plan->next_.blocks.size(), plan->first_.blocks.size());
+  return plan;
+}
+
+void DatatypePlan::serialize(const void* noncontiguous, void* contiguous, int count) const
+{
+  auto* contiguous_char          = static_cast<char*>(contiguous);
+  const auto* noncontiguous_char = static_cast<const char*>(noncontiguous);
+  for (int i = 0; i < count; i++) {
+    const Layout& layout = i == 0 ? first_ : next_;
+    const char* element  = i == 0 ? noncontiguous_char : noncontiguous_char + (i - 1) * stride_;
+    for (auto const& block : layout.blocks) {
+      memcpy(contiguous_char, element + block.offset, block.length);
+      contiguous_char += block.length;
+    }
+  }
+}
+
+void DatatypePlan::unserialize(const void* contiguous, void* noncontiguous, int count, MPI_Op op) const
+{
+  if (op == MPI_OP_NULL)
+    return;
+  const auto* contiguous_char = static_cast<const char*>(contiguous);
+  auto* noncontiguous_char    = static_cast<char*>(noncontiguous);
+  if (op == MPI_REPLACE) {
+    /* Plain copies, without going through Op::apply for each block */
+    smpi_switch_data_segment(simgrid::s4u::Actor::self());
+    if (smpi_process()->skip_payload())
+      return;
+    for (int i = 0; i < count; i++) {
+      const Layout& layout = i == 0 ? first_ : next_;
+      char* element        = i == 0 ? noncontiguous_char : noncontiguous_char + (i - 1) * stride_;
+      for (auto const& block : layout.blocks) {
+        memcpy(element + block.offset, contiguous_char, block.length);
+        contiguous_char += block.length;
+      }
+    }
+    return;
+  }
+  for (int i = 0; i < count; i++) {
+    const Layout& layout = i == 0 ? first_ : next_;
+    char* element        = i == 0 ? noncontiguous_char : noncontiguous_char + (i - 1) * stride_;
+    for (auto const& run : layout.runs) {
+      op->apply(contiguous_char, element + run.offset, &run.count, run.type);
+      contiguous_char += run.count * run.type->size();
+    }
+  }
+}
+
 int Datatype::create_contiguous(int count, MPI_Datatype old_type, MPI_Aint lb, MPI_Datatype* new_type){
   if(old_type->flags_ & DT_FLAG_DERIVED){
     //handle this case as a hvector with stride equals to the extent of the datatype
@@ -66,6 +66,12 @@ void Type_Contiguous::unserialize(const void* contiguous_buf, void* noncontiguou
     op->apply( contiguous_buf_char, noncontiguous_buf_char, &n, old_type_);
 }
 
+bool Type_Contiguous::flatten(MPI_Aint offset, int count, std::vector<DatatypePlan::Run>& runs)
+{
+  runs.push_back({offset + lb(), count * block_count_, old_type_});
+  return runs.size() <= DatatypePlan::MAX_RUNS;
+}
+
 Type_Hvector::Type_Hvector(int size,MPI_Aint lb, MPI_Aint ub, int flags, int count, int block_length, MPI_Aint stride, MPI_Datatype old_type): Datatype(size, lb, ub, flags), block_count_(count), block_length_(block_length), block_stride_(stride), old_type_(old_type){
   const std::array<int, 2> ints = {{count, block_length}};
   set_contents(MPI_COMBINER_HVECTOR, 2, ints.data(), 1, &stride, 1, &old_type);
@@ -84,6 +90,10 @@ int Type_Hvector::clone(MPI_Datatype* type)
 
 void Type_Hvector::serialize(const void* noncontiguous_buf, void *contiguous_buf,
                     int count){
+  if (get_plan() != nullptr) {
+    get_plan()->serialize(noncontiguous_buf, contiguous_buf, count);
+    return;
+  }
   auto* contiguous_buf_char          = static_cast<char*>(contiguous_buf);
   const auto* noncontiguous_buf_char = static_cast<const char*>(noncontiguous_buf);
 
@@ -95,7 +105,7 @@ void Type_Hvector::serialize(const void* noncontiguous_buf, void *contiguous_buf
 
     contiguous_buf_char += block_length_*old_type_->size();
     if((i+1)%block_count_ ==0)
-      noncontiguous_buf_char += block_length_*old_type_->size();
+      noncontiguous_buf_char += block_length_*old_type_->get_extent();
     else
       noncontiguous_buf_char += block_stride_;
   }
@@ -103,6 +113,10 @@ void Type_Hvector::serialize(const void* noncontiguous_buf, void *contiguous_buf
 
 void Type_Hvector::unserialize(const void* contiguous_buf, void *noncontiguous_buf,
                               int count, MPI_Op op){
+  if (get_plan() != nullptr) {
+    get_plan()->unserialize(contiguous_buf, noncontiguous_buf, count, op);
+    return;
+  }
   const auto* contiguous_buf_char = static_cast<const char*>(contiguous_buf);
   auto* noncontiguous_buf_char    = static_cast<char*>(noncontiguous_buf);
 
@@ -114,12 +128,30 @@ void Type_Hvector::unserialize(const void* contiguous_buf, void *noncontiguous_b
       old_type_->unserialize( contiguous_buf_char, noncontiguous_buf_char, block_length_, op);
     contiguous_buf_char += block_length_*old_type_->size();
     if((i+1)%block_count_ ==0)
-      noncontiguous_buf_char += block_length_*old_type_->size();
+      noncontiguous_buf_char += block_length_*old_type_->get_extent();
     else
       noncontiguous_buf_char += block_stride_;
   }
 }
 
+bool Type_Hvector::flatten(MPI_Aint offset, int count, std::vector<DatatypePlan::Run>& runs)
+{
+  for (int i = 0; i < block_count_ * count; i++) {
+    if (not(old_type_->flags() & DT_FLAG_DERIVED))
+      runs.push_back({offset, block_length_, old_type_});
+    else if (not old_type_->flatten(offset, block_length_, runs))
+      return false;
+    if (runs.size() > DatatypePlan::MAX_RUNS)
+      return false;
+
+    if ((i + 1) % block_count_ == 0)
+      offset += block_length_ * old_type_->get_extent();
+    else
+      offset += block_stride_;
+  }
+  return true;
+}
+
 Type_Vector::Type_Vector(int size, MPI_Aint lb, MPI_Aint ub, int flags, int count, int block_length, int stride,
                          MPI_Datatype old_type)
     : Type_Hvector(size, lb, ub, flags, count, block_length, stride * old_type->get_extent(), old_type)
@@ -188,6 +220,10 @@ Type_Hindexed::~Type_Hindexed()
 
 void Type_Hindexed::serialize(const void* noncontiguous_buf, void *contiguous_buf,
                 int count){
+  if (get_plan() != nullptr) {
+    get_plan()->serialize(noncontiguous_buf, contiguous_buf, count);
+    return;
+  }
   auto* contiguous_buf_char          = static_cast<char*>(contiguous_buf);
   const auto* noncontiguous_buf_iter = static_cast<const char*>(noncontiguous_buf);
   const auto* noncontiguous_buf_char = noncontiguous_buf_iter + block_indices_[0];
@@ -210,6 +246,10 @@ void Type_Hindexed::serialize(const void* noncontiguous_buf, void *contiguous_bu
 
 void Type_Hindexed::unserialize(const void* contiguous_buf, void *noncontiguous_buf,
                           int count, MPI_Op op){
+  if (get_plan() != nullptr) {
+    get_plan()->unserialize(contiguous_buf, noncontiguous_buf, count, op);
+    return;
+  }
   const auto* contiguous_buf_char = static_cast<const char*>(contiguous_buf);
   auto* noncontiguous_buf_char    = static_cast<char*>(noncontiguous_buf) + block_indices_[0];
   for (int j = 0; j < count; j++) {
@@ -231,6 +271,31 @@ void Type_Hindexed::unserialize(const void* contiguous_buf, void *noncontiguous_
   }
 }
 
+bool Type_Hindexed::flatten(MPI_Aint offset, int count, std::vector<DatatypePlan::Run>& runs)
+{
+  if (block_count_ == 0)
+    return true;
+  MPI_Aint element = offset;
+  offset += block_indices_[0];
+  for (int j = 0; j < count; j++) {
+    for (int i = 0; i < block_count_; i++) {
+      if (not(old_type_->flags() & DT_FLAG_DERIVED))
+        runs.push_back({offset, block_lengths_[i], old_type_});
+      else if (not old_type_->flatten(offset, block_lengths_[i], runs))
+        return false;
+      if (runs.size() > DatatypePlan::MAX_RUNS)
+        return false;
+
+      if (i < block_count_ - 1)
+        offset = element + block_indices_[i + 1];
+      else
+        offset += block_lengths_[i] * old_type_->get_extent();
+    }
+    element = offset;
+  }
+  return true;
+}
+
 Type_Indexed::Type_Indexed(int size, MPI_Aint lb, MPI_Aint ub, int flags, int count, const int* block_lengths,
                            const int* block_indices, MPI_Datatype old_type)
     : Type_Hindexed(size, lb, ub, flags, count, block_lengths, block_indices, old_type, old_type->get_extent())
@@ -292,6 +357,10 @@ int Type_Struct::clone(MPI_Datatype* type)
 
 void Type_Struct::serialize(const void* noncontiguous_buf, void *contiguous_buf,
                         int count){
+  if (get_plan() != nullptr) {
+    get_plan()->serialize(noncontiguous_buf, contiguous_buf, count);
+    return;
+  }
   auto* contiguous_buf_char          = static_cast<char*>(contiguous_buf);
   const auto* noncontiguous_buf_iter = static_cast<const char*>(noncontiguous_buf);
   const auto* noncontiguous_buf_char = noncontiguous_buf_iter + block_indices_[0];
@@ -315,6 +384,10 @@ void Type_Struct::serialize(const void* noncontiguous_buf, void *contiguous_buf,
 
 void Type_Struct::unserialize(const void* contiguous_buf, void *noncontiguous_buf,
                               int count, MPI_Op op){
+  if (get_plan() != nullptr) {
+    get_plan()->unserialize(contiguous_buf, noncontiguous_buf, count, op);
+    return;
+  }
   const auto* contiguous_buf_char = static_cast<const char*>(contiguous_buf);
   auto* noncontiguous_buf_char    = static_cast<char*>(noncontiguous_buf) + block_indices_[0];
   for (int j = 0; j < count; j++) {
@@ -335,5 +408,30 @@ void Type_Struct::unserialize(const void* contiguous_buf, void *noncontiguous_bu
   }
 }
 
+bool Type_Struct::flatten(MPI_Aint offset, int count, std::vector<DatatypePlan::Run>& runs)
+{
+  if (block_count_ == 0)
+    return true;
+  MPI_Aint element = offset;
+  offset += block_indices_[0];
+  for (int j = 0; j < count; j++) {
+    for (int i = 0; i < block_count_; i++) {
+      if (not(old_types_[i]->flags() & DT_FLAG_DERIVED))
+        runs.push_back({offset, block_lengths_[i], old_types_[i]});
+      else if (not old_types_[i]->flatten(offset, block_lengths_[i], runs))
+        return false;
+      if (runs.size() > DatatypePlan::MAX_RUNS)
+        return false;
+
+      if (i < block_count_ - 1)
+        offset = element + block_indices_[i + 1];
+      else
+        offset += block_lengths_[i] * old_types_[i]->get_extent();
+    }
+    element = offset;
+  }
+  return true;
+}
+
 }
 }
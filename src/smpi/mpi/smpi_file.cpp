@@ -67,6 +67,7 @@ namespace smpi{
       errhandler_ = MPI_ERRHANDLER_NULL;
       win_=new Win(list_, 0, 1, MPI_INFO_NULL, comm_);
     }
+    ActorExt::PayloadNeeded payload_needed(smpi_process());
     simgrid::smpi::colls::bcast(&shared_file_pointer_, 1, MPI_AINT, 0, comm);
     simgrid::smpi::colls::bcast(&shared_mutex_, 1, MPI_AINT, 0, comm);
     if(comm_->rank() != 0)
@@ -196,7 +197,10 @@ namespace smpi{
     }
 
     MPI_Offset result;
-    simgrid::smpi::colls::scan(&val, &result, 1, MPI_OFFSET, MPI_SUM, fh->comm_);
+    {
+      ActorExt::PayloadNeeded payload_needed(smpi_process());
+      simgrid::smpi::colls::scan(&val, &result, 1, MPI_OFFSET, MPI_SUM, fh->comm_);
+    }
     fh->seek(result, MPI_SEEK_SET);
     int ret = fh->op_all<simgrid::smpi::File::read>(buf, count, datatype, status);
     if(fh->comm_->rank()==fh->comm_->size()-1){
@@ -249,7 +253,10 @@ namespace smpi{
       val=count*datatype->size();
     }
     MPI_Offset result;
-    simgrid::smpi::colls::scan(&val, &result, 1, MPI_OFFSET, MPI_SUM, fh->comm_);
+    {
+      ActorExt::PayloadNeeded payload_needed(smpi_process());
+      simgrid::smpi::colls::scan(&val, &result, 1, MPI_OFFSET, MPI_SUM, fh->comm_);
+    }
     fh->seek(result, MPI_SEEK_SET);
     int ret = fh->op_all<simgrid::smpi::File::write>(const_cast<void*>(buf), count, datatype, status);
     if(fh->comm_->rank()==fh->comm_->size()-1){
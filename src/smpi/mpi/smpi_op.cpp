@@ -8,6 +8,10 @@
 #include "smpi_datatype.hpp"
 #include "src/smpi/include/smpi_actor.hpp"
 
+#include <initializer_list>
+#include <unordered_map>
+#include <utility>
+
 XBT_LOG_NEW_DEFAULT_SUBCATEGORY(smpi_op, smpi, "Logging specific to SMPI (op)");
 
 #define MAX_OP(a, b)  (b) = (a) < (b) ? (b) : (a)
@@ -35,197 +39,192 @@ XBT_LOG_NEW_DEFAULT_SUBCATEGORY(smpi_op, smpi, "Logging specific to SMPI (op)");
 #define MINLOC_OP(a, b)                                                                                                \
   (b) = ((a).value) < ((b).value) ? (a) : (((a).value) == ((b).value) ? (((a).index) < ((b).index) ? (a) : (b)) : (b))
 
-#define APPLY_FUNC(a, b, length, type, func) \
-{                                          \
-  int i;                                   \
-  type* x = (type*)(a);                    \
-  type* y = (type*)(b);                    \
-  for(i = 0; i < *(length); i++) {         \
-    func(x[i], y[i]);                      \
-  }                                        \
+namespace {
+/* Applies an operation to length elements of a given type. The buffers cannot overlap (the inout buffer is a different
+ * one for MPI_IN_PLACE), and the length is read only once, so that compilers can vectorize the loop. */
+using op_kernel = void (*)(const void* a, void* b, int length);
+
+template <typename T, class Op> void apply_kernel(const void* a, void* b, int length)
+{
+  const T* __restrict x = static_cast<const T*>(a);
+  T* __restrict y       = static_cast<T*>(b);
+  for (int i = 0; i < length; i++)
+    Op::apply(x[i], y[i]);
 }
 
-#define APPLY_BEGIN_OP_LOOP()                                                                                          \
-  MPI_Datatype datatype_base = *datatype;                                                                              \
-  while (datatype_base->duplicated_datatype() != MPI_DATATYPE_NULL)                                                    \
-    datatype_base = datatype_base->duplicated_datatype();
-
-#define APPLY_OP_LOOP(dtype, type, op)                                                                                 \
-  if (datatype_base == (dtype)) {                                                                                      \
-    APPLY_FUNC(a, b, length, type, op)                                                                                 \
-  } else
-
-#define APPLY_BASIC_OP_LOOP(op)\
-APPLY_OP_LOOP(MPI_CHAR, char,op)\
-APPLY_OP_LOOP(MPI_SHORT, short,op)\
-APPLY_OP_LOOP(MPI_INT, int,op)\
-APPLY_OP_LOOP(MPI_LONG, long,op)\
-APPLY_OP_LOOP(MPI_LONG_LONG, long long,op)\
-APPLY_OP_LOOP(MPI_SIGNED_CHAR, signed char,op)\
-APPLY_OP_LOOP(MPI_UNSIGNED_CHAR, unsigned char,op)\
-APPLY_OP_LOOP(MPI_UNSIGNED_SHORT, unsigned short,op)\
-APPLY_OP_LOOP(MPI_UNSIGNED, unsigned int,op)\
-APPLY_OP_LOOP(MPI_UNSIGNED_LONG, unsigned long,op)\
-APPLY_OP_LOOP(MPI_UNSIGNED_LONG_LONG, unsigned long long,op)\
-APPLY_OP_LOOP(MPI_WCHAR, wchar_t,op)\
-APPLY_OP_LOOP(MPI_INT8_T, int8_t,op)\
-APPLY_OP_LOOP(MPI_INT16_T, int16_t,op)\
-APPLY_OP_LOOP(MPI_INT32_T, int32_t,op)\
-APPLY_OP_LOOP(MPI_INT64_T, int64_t,op)\
-APPLY_OP_LOOP(MPI_UINT8_T, uint8_t,op)\
-APPLY_OP_LOOP(MPI_UINT16_T, uint16_t,op)\
-APPLY_OP_LOOP(MPI_UINT32_T, uint32_t,op)\
-APPLY_OP_LOOP(MPI_UINT64_T, uint64_t,op)\
-APPLY_OP_LOOP(MPI_AINT, MPI_Aint,op)\
-APPLY_OP_LOOP(MPI_OFFSET, MPI_Offset,op)\
-APPLY_OP_LOOP(MPI_INTEGER1, int,op)\
-APPLY_OP_LOOP(MPI_INTEGER2, int16_t,op)\
-APPLY_OP_LOOP(MPI_INTEGER4, int32_t,op)\
-APPLY_OP_LOOP(MPI_INTEGER8, int64_t,op)\
-APPLY_OP_LOOP(MPI_COUNT, long long,op)
-
-
-#define APPLY_BOOL_OP_LOOP(op)\
-APPLY_OP_LOOP(MPI_C_BOOL, bool,op)
-
-#define APPLY_BYTE_OP_LOOP(op)\
-APPLY_OP_LOOP(MPI_BYTE, int8_t,op)
-
-#define APPLY_FLOAT_OP_LOOP(op)\
-APPLY_OP_LOOP(MPI_FLOAT, float,op)\
-APPLY_OP_LOOP(MPI_DOUBLE, double,op)\
-APPLY_OP_LOOP(MPI_LONG_DOUBLE, long double,op)\
-APPLY_OP_LOOP(MPI_REAL, float,op)\
-APPLY_OP_LOOP(MPI_REAL4, float,op)\
-APPLY_OP_LOOP(MPI_REAL8, double,op)\
-APPLY_OP_LOOP(MPI_REAL16, long double,op)
-
-#define APPLY_COMPLEX_OP_LOOP(op)\
-APPLY_OP_LOOP(MPI_C_FLOAT_COMPLEX, float _Complex,op)\
-APPLY_OP_LOOP(MPI_C_DOUBLE_COMPLEX, double _Complex,op)\
-APPLY_OP_LOOP(MPI_C_LONG_DOUBLE_COMPLEX, long double _Complex,op)
-
-#define APPLY_PAIR_OP_LOOP(op)\
-APPLY_OP_LOOP(MPI_FLOAT_INT, float_int,op)\
-APPLY_OP_LOOP(MPI_LONG_INT, long_int,op)\
-APPLY_OP_LOOP(MPI_DOUBLE_INT, double_int,op)\
-APPLY_OP_LOOP(MPI_SHORT_INT, short_int,op)\
-APPLY_OP_LOOP(MPI_2INT, int_int,op)\
-APPLY_OP_LOOP(MPI_2FLOAT, float_float,op)\
-APPLY_OP_LOOP(MPI_2DOUBLE, double_double,op)\
-APPLY_OP_LOOP(MPI_LONG_DOUBLE_INT, long_double_int,op)\
-APPLY_OP_LOOP(MPI_2LONG, long_long,op)\
-APPLY_OP_LOOP(MPI_COMPLEX8, float_float,op)\
-APPLY_OP_LOOP(MPI_COMPLEX16, double_double,op)\
-APPLY_OP_LOOP(MPI_COMPLEX32, double_double,op)
-
-#define APPLY_END_OP_LOOP(op)                                                                                          \
-  {                                                                                                                    \
-    xbt_die("Failed to apply " _XBT_STRINGIFY(op) " to type %s", (*datatype)->name().c_str());                         \
+/** @brief Kernels of a predefined operation, for each of the predefined datatypes it supports */
+class OpKernels {
+  const char* name_;
+  std::unordered_map<MPI_Datatype, op_kernel> kernels_;
+
+public:
+  OpKernels(const char* name, std::initializer_list<std::pair<const MPI_Datatype, op_kernel>> kernels)
+      : name_(name), kernels_(kernels)
+  {
+  }
+  void apply(const void* a, void* b, const int* length, const MPI_Datatype* datatype) const
+  {
+    MPI_Datatype datatype_base = *datatype;
+    while (datatype_base->duplicated_datatype() != MPI_DATATYPE_NULL)
+      datatype_base = datatype_base->duplicated_datatype();
+    auto kernel = kernels_.find(datatype_base);
+    if (kernel == kernels_.end())
+      xbt_die("Failed to apply %s to type %s", name_, (*datatype)->name().c_str());
+    kernel->second(a, b, *length);
   }
+};
+} // namespace
+
+#define OP_FUNCTOR(name, op)                                                                                           \
+  struct name {                                                                                                        \
+    template <typename T> static void apply(const T& a, T& b) { op(a, b); }                                            \
+  };
+
+OP_FUNCTOR(Max, MAX_OP)
+OP_FUNCTOR(Min, MIN_OP)
+OP_FUNCTOR(Sum, SUM_OP)
+OP_FUNCTOR(SumComplex, SUM_OP_COMPLEX)
+OP_FUNCTOR(Prod, PROD_OP)
+OP_FUNCTOR(ProdComplex, PROD_OP_COMPLEX)
+OP_FUNCTOR(Land, LAND_OP)
+OP_FUNCTOR(Lor, LOR_OP)
+OP_FUNCTOR(Lxor, LXOR_OP)
+OP_FUNCTOR(Band, BAND_OP)
+OP_FUNCTOR(Bor, BOR_OP)
+OP_FUNCTOR(Bxor, BXOR_OP)
+OP_FUNCTOR(Maxloc, MAXLOC_OP)
+OP_FUNCTOR(Minloc, MINLOC_OP)
+
+#define OP_KERNEL(dtype, type, op) {(dtype), &apply_kernel<type, op>},
+
+#define BASIC_OP_KERNELS(op)\
+OP_KERNEL(MPI_CHAR, char,op)\
+OP_KERNEL(MPI_SHORT, short,op)\
+OP_KERNEL(MPI_INT, int,op)\
+OP_KERNEL(MPI_LONG, long,op)\
+OP_KERNEL(MPI_LONG_LONG, long long,op)\
+OP_KERNEL(MPI_SIGNED_CHAR, signed char,op)\
+OP_KERNEL(MPI_UNSIGNED_CHAR, unsigned char,op)\
+OP_KERNEL(MPI_UNSIGNED_SHORT, unsigned short,op)\
+OP_KERNEL(MPI_UNSIGNED, unsigned int,op)\
+OP_KERNEL(MPI_UNSIGNED_LONG, unsigned long,op)\
+OP_KERNEL(MPI_UNSIGNED_LONG_LONG, unsigned long long,op)\
+OP_KERNEL(MPI_WCHAR, wchar_t,op)\
+OP_KERNEL(MPI_INT8_T, int8_t,op)\
+OP_KERNEL(MPI_INT16_T, int16_t,op)\
+OP_KERNEL(MPI_INT32_T, int32_t,op)\
+OP_KERNEL(MPI_INT64_T, int64_t,op)\
+OP_KERNEL(MPI_UINT8_T, uint8_t,op)\
+OP_KERNEL(MPI_UINT16_T, uint16_t,op)\
+OP_KERNEL(MPI_UINT32_T, uint32_t,op)\
+OP_KERNEL(MPI_UINT64_T, uint64_t,op)\
+OP_KERNEL(MPI_AINT, MPI_Aint,op)\
+OP_KERNEL(MPI_OFFSET, MPI_Offset,op)\
+OP_KERNEL(MPI_INTEGER1, int,op)\
+OP_KERNEL(MPI_INTEGER2, int16_t,op)\
+OP_KERNEL(MPI_INTEGER4, int32_t,op)\
+OP_KERNEL(MPI_INTEGER8, int64_t,op)\
+OP_KERNEL(MPI_COUNT, long long,op)
+
+#define BOOL_OP_KERNELS(op)\
+OP_KERNEL(MPI_C_BOOL, bool,op)
+
+#define BYTE_OP_KERNELS(op)\
+OP_KERNEL(MPI_BYTE, int8_t,op)
+
+#define FLOAT_OP_KERNELS(op)\
+OP_KERNEL(MPI_FLOAT, float,op)\
+OP_KERNEL(MPI_DOUBLE, double,op)\
+OP_KERNEL(MPI_LONG_DOUBLE, long double,op)\
+OP_KERNEL(MPI_REAL, float,op)\
+OP_KERNEL(MPI_REAL4, float,op)\
+OP_KERNEL(MPI_REAL8, double,op)\
+OP_KERNEL(MPI_REAL16, long double,op)
+
+#define COMPLEX_OP_KERNELS(op)\
+OP_KERNEL(MPI_C_FLOAT_COMPLEX, float _Complex,op)\
+OP_KERNEL(MPI_C_DOUBLE_COMPLEX, double _Complex,op)\
+OP_KERNEL(MPI_C_LONG_DOUBLE_COMPLEX, long double _Complex,op)
+
+#define PAIR_OP_KERNELS(op)\
+OP_KERNEL(MPI_FLOAT_INT, float_int,op)\
+OP_KERNEL(MPI_LONG_INT, long_int,op)\
+OP_KERNEL(MPI_DOUBLE_INT, double_int,op)\
+OP_KERNEL(MPI_SHORT_INT, short_int,op)\
+OP_KERNEL(MPI_2INT, int_int,op)\
+OP_KERNEL(MPI_2FLOAT, float_float,op)\
+OP_KERNEL(MPI_2DOUBLE, double_double,op)\
+OP_KERNEL(MPI_LONG_DOUBLE_INT, long_double_int,op)\
+OP_KERNEL(MPI_2LONG, long_long,op)\
+OP_KERNEL(MPI_COMPLEX8, float_float,op)\
+OP_KERNEL(MPI_COMPLEX16, double_double,op)\
+OP_KERNEL(MPI_COMPLEX32, double_double,op)
+
+/* The kernels are looked up once per call, in a table built on first use */
+#define APPLY_OP_KERNELS(op, kernels)                                                                                  \
+  static const OpKernels op_kernels(_XBT_STRINGIFY(op), {kernels});                                                   \
+  op_kernels.apply(a, b, length, datatype);
 
 static void max_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_BEGIN_OP_LOOP()
-  APPLY_BASIC_OP_LOOP(MAX_OP)
-  APPLY_FLOAT_OP_LOOP(MAX_OP)
-  APPLY_END_OP_LOOP(MAX_OP)
+  APPLY_OP_KERNELS(MAX_OP, BASIC_OP_KERNELS(Max) FLOAT_OP_KERNELS(Max))
 }
 
 static void min_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_BEGIN_OP_LOOP()
-  APPLY_BASIC_OP_LOOP(MIN_OP)
-  APPLY_FLOAT_OP_LOOP(MIN_OP)
-  APPLY_END_OP_LOOP(MIN_OP)
+  APPLY_OP_KERNELS(MIN_OP, BASIC_OP_KERNELS(Min) FLOAT_OP_KERNELS(Min))
 }
 
 static void sum_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_BEGIN_OP_LOOP()
-  APPLY_BASIC_OP_LOOP(SUM_OP)
-  APPLY_FLOAT_OP_LOOP(SUM_OP)
-  APPLY_COMPLEX_OP_LOOP(SUM_OP)
-  APPLY_PAIR_OP_LOOP(SUM_OP_COMPLEX)
-  APPLY_END_OP_LOOP(SUM_OP)
+  APPLY_OP_KERNELS(SUM_OP, BASIC_OP_KERNELS(Sum) FLOAT_OP_KERNELS(Sum) COMPLEX_OP_KERNELS(Sum)
+                               PAIR_OP_KERNELS(SumComplex))
 }
 
 static void prod_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_BEGIN_OP_LOOP()
-  APPLY_BASIC_OP_LOOP(PROD_OP)
-  APPLY_FLOAT_OP_LOOP(PROD_OP)
-  APPLY_COMPLEX_OP_LOOP(PROD_OP)
-  APPLY_PAIR_OP_LOOP(PROD_OP_COMPLEX)
-  APPLY_END_OP_LOOP(PROD_OP)
+  APPLY_OP_KERNELS(PROD_OP, BASIC_OP_KERNELS(Prod) FLOAT_OP_KERNELS(Prod) COMPLEX_OP_KERNELS(Prod)
+                                PAIR_OP_KERNELS(ProdComplex))
 }
 
 static void land_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_BEGIN_OP_LOOP()
-  APPLY_BASIC_OP_LOOP(LAND_OP)
-  APPLY_FLOAT_OP_LOOP(LAND_OP)
-  APPLY_BOOL_OP_LOOP(LAND_OP)
-  APPLY_END_OP_LOOP(LAND_OP)
+  APPLY_OP_KERNELS(LAND_OP, BASIC_OP_KERNELS(Land) FLOAT_OP_KERNELS(Land) BOOL_OP_KERNELS(Land))
 }
 
 static void lor_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_BEGIN_OP_LOOP()
-  APPLY_BASIC_OP_LOOP(LOR_OP)
-  APPLY_FLOAT_OP_LOOP(LOR_OP)
-  APPLY_BOOL_OP_LOOP(LOR_OP)
-  APPLY_END_OP_LOOP(LOR_OP)
+  APPLY_OP_KERNELS(LOR_OP, BASIC_OP_KERNELS(Lor) FLOAT_OP_KERNELS(Lor) BOOL_OP_KERNELS(Lor))
 }
 
 static void lxor_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_BEGIN_OP_LOOP()
-  APPLY_BASIC_OP_LOOP(LXOR_OP)
-  APPLY_FLOAT_OP_LOOP(LXOR_OP)
-  APPLY_BOOL_OP_LOOP(LXOR_OP)
-  APPLY_END_OP_LOOP(LXOR_OP)
+  APPLY_OP_KERNELS(LXOR_OP, BASIC_OP_KERNELS(Lxor) FLOAT_OP_KERNELS(Lxor) BOOL_OP_KERNELS(Lxor))
 }
 
 static void band_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_BEGIN_OP_LOOP()
-  APPLY_BASIC_OP_LOOP(BAND_OP)
-  APPLY_BOOL_OP_LOOP(BAND_OP)
-  APPLY_BYTE_OP_LOOP(BAND_OP)
-  APPLY_END_OP_LOOP(BAND_OP)
+  APPLY_OP_KERNELS(BAND_OP, BASIC_OP_KERNELS(Band) BOOL_OP_KERNELS(Band) BYTE_OP_KERNELS(Band))
 }
 
 static void bor_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_BEGIN_OP_LOOP()
-  APPLY_BASIC_OP_LOOP(BOR_OP)
-  APPLY_BOOL_OP_LOOP(BOR_OP)
-  APPLY_BYTE_OP_LOOP(BOR_OP)
-  APPLY_END_OP_LOOP(BOR_OP)
+  APPLY_OP_KERNELS(BOR_OP, BASIC_OP_KERNELS(Bor) BOOL_OP_KERNELS(Bor) BYTE_OP_KERNELS(Bor))
 }
 
 static void bxor_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_BEGIN_OP_LOOP()
-  APPLY_BASIC_OP_LOOP(BXOR_OP)
-  APPLY_BOOL_OP_LOOP(BXOR_OP)
-  APPLY_BYTE_OP_LOOP(BXOR_OP)
-  APPLY_END_OP_LOOP(BXOR_OP)
+  APPLY_OP_KERNELS(BXOR_OP, BASIC_OP_KERNELS(Bxor) BOOL_OP_KERNELS(Bxor) BYTE_OP_KERNELS(Bxor))
 }
 
 static void minloc_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_BEGIN_OP_LOOP()
-  APPLY_PAIR_OP_LOOP(MINLOC_OP)
-  APPLY_END_OP_LOOP(MINLOC_OP)
+  APPLY_OP_KERNELS(MINLOC_OP, PAIR_OP_KERNELS(Minloc))
 }
 
 static void maxloc_func(void *a, void *b, int *length, MPI_Datatype * datatype)
 {
-  APPLY_BEGIN_OP_LOOP()
-  APPLY_PAIR_OP_LOOP(MAXLOC_OP)
-  APPLY_END_OP_LOOP(MAXLOC_OP)
+  APPLY_OP_KERNELS(MAXLOC_OP, PAIR_OP_KERNELS(Maxloc))
 }
 
 static void replace_func(void *a, void *b, int *length, MPI_Datatype * datatype)
@@ -269,7 +268,7 @@ void Op::apply(const void* invec, void* inoutvec, const int* len, MPI_Datatype d
   // we need to switch as the called function may silently touch global variables
   smpi_switch_data_segment(simgrid::s4u::Actor::self());
 
-  if (not smpi_process()->replaying() && *len > 0) {
+  if (not smpi_process()->skip_payload() && *len > 0) {
     XBT_DEBUG("Applying operation of length %d from %p and from/to %p", *len, invec, inoutvec);
     if (not is_fortran_op_)
       this->func_(const_cast<void*>(invec), inoutvec, const_cast<int*>(len), &datatype);
@@ -168,7 +168,8 @@ void Request::init_buffer(int count){
       buf_ = nullptr;
     }else {
       buf_ = xbt_malloc(count*type_->size());
-      if ((type_->flags() & DT_FLAG_DERIVED) && ((flags_ & MPI_REQ_SEND) != 0)) {
+      if ((type_->flags() & DT_FLAG_DERIVED) && ((flags_ & MPI_REQ_SEND) != 0) &&
+          not smpi_process()->skip_payload()) {
         type_->serialize(old_buf_, buf_, count);
       }
     }
@@ -189,6 +190,20 @@ bool Request::match_send(void* a, void* b, simgrid::kernel::activity::CommImpl*)
   return match_common(req, ref, req);
 }
 
+/* Copies the payload of a message, unless its sender chose to skip it. The receiver is told about that choice, so
+ * that it does not unserialize or reduce data that were never copied. */
+void Request::copy_payload(simgrid::kernel::activity::CommImpl* comm, void* buff, size_t buff_size)
+{
+  const auto* sender = static_cast<MPI_Request>(comm->src_data_);
+  auto* receiver     = static_cast<MPI_Request>(comm->dst_data_);
+  if (sender->flags_ & MPI_REQ_NO_PAYLOAD) {
+    receiver->flags_ |= MPI_REQ_NO_PAYLOAD;
+  } else {
+    receiver->flags_ &= ~MPI_REQ_NO_PAYLOAD;
+    smpi_comm_copy_data_callback(comm, buff, buff_size);
+  }
+}
+
 void Request::print_request(const char* message) const
 {
   XBT_VERB("%s  request %p  [buf = %p, size = %zu, src = %ld, dst = %ld, tag = %d, flags = %x]", message, this, buf_,
@@ -424,6 +439,11 @@ void Request::start()
   }
   flags_ &= ~MPI_REQ_PREPARED;
   flags_ &= ~MPI_REQ_FINISHED;
+  // Whether the payload is copied is decided by the sender, and forwarded to the receiver by copy_payload()
+  if (smpi_process()->skip_payload())
+    flags_ |= MPI_REQ_NO_PAYLOAD;
+  else
+    flags_ &= ~MPI_REQ_NO_PAYLOAD;
   this->ref();
 
   // we make a copy here, as the size is modified by simix, and we may reuse the request in another receive later
@@ -473,7 +493,7 @@ void Request::start()
 
     action_   = simcall_comm_irecv(
         process->get_actor()->get_impl(), mailbox->get_impl(), buf_, &real_size_, &match_recv,
-        process->replaying() ? &smpi_comm_null_copy_buffer_callback : smpi_comm_copy_data_callback, this, -1.0);
+        process->replaying() ? &smpi_comm_null_copy_buffer_callback : &copy_payload, this, -1.0);
     XBT_DEBUG("recv simcall posted");
 
     if (smpi_cfg_async_small_thresh() != 0 || (flags_ & MPI_REQ_RMA) != 0)
@@ -495,7 +515,7 @@ void Request::start()
       this->ref();
       if (not(type_->flags() & DT_FLAG_DERIVED)) {
         oldbuf = buf_;
-        if (not process->replaying() && oldbuf != nullptr && size_ != 0) {
+        if ((flags_ & MPI_REQ_NO_PAYLOAD) == 0 && oldbuf != nullptr && size_ != 0) {
           if (smpi_switch_data_segment(simgrid::s4u::Actor::by_pid(src_), buf_))
             XBT_DEBUG("Privatization : We are sending from a zone inside global memory. Switch data segment ");
 
@@ -561,7 +581,7 @@ void Request::start()
         simgrid::kernel::actor::ActorImpl::by_pid(src_), mailbox->get_impl(), payload_size_, -1.0, buf, real_size_,
         &match_send,
         &xbt_free_f, // how to free the userdata if a detached send fails
-        process->replaying() ? &smpi_comm_null_copy_buffer_callback : smpi_comm_copy_data_callback, this,
+        process->replaying() ? &smpi_comm_null_copy_buffer_callback : &copy_payload, this,
         // detach if msg size < eager/rdv switch limit
         detached_);
     XBT_DEBUG("send simcall posted");
@@ -926,17 +946,18 @@ void Request::finish_wait(MPI_Request* request, MPI_Status * status)
       // FIXME Handle the case of a partial shared malloc.
       if (((req->flags_ & MPI_REQ_ACCUMULATE) != 0) ||
           (datatype->flags() & DT_FLAG_DERIVED)) { // && (not smpi_is_shared(req->old_buf_))){
-        if (not smpi_process()->replaying() && smpi_switch_data_segment(simgrid::s4u::Actor::self(), req->old_buf_))
+        bool skip_payload = (req->flags_ & MPI_REQ_NO_PAYLOAD) != 0;
+        if (not skip_payload && smpi_switch_data_segment(simgrid::s4u::Actor::self(), req->old_buf_))
           XBT_VERB("Privatization : We are unserializing to a zone in global memory  Switch data segment ");
 
         if(datatype->flags() & DT_FLAG_DERIVED){
           // This part handles the problem of non-contiguous memory the unserialization at the reception
-          if ((req->flags_ & MPI_REQ_RECV) && datatype->size() != 0)
+          if ((req->flags_ & MPI_REQ_RECV) && datatype->size() != 0 && not skip_payload)
             datatype->unserialize(req->buf_, req->old_buf_, req->real_size_/datatype->size() , req->op_);
           xbt_free(req->buf_);
           req->buf_=nullptr;
         } else if (req->flags_ & MPI_REQ_RECV) { // apply op on contiguous buffer for accumulate
-          if (datatype->size() != 0) {
+          if (datatype->size() != 0 && not skip_payload) {
             int n = req->real_size_ / datatype->size();
             req->op_->apply(req->buf_, req->old_buf_, &n, datatype);
           }
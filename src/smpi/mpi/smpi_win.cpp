@@ -60,6 +60,7 @@ Win::Win(void* base, MPI_Aint size, int disp_unit, MPI_Info info, MPI_Comm comm,
   comm->add_rma_win(this);
   comm->ref();
 
+  ActorExt::PayloadNeeded payload_needed(smpi_process());
   colls::allgather(&connected_wins_[rank_], sizeof(MPI_Win), MPI_BYTE, connected_wins_.data(), sizeof(MPI_Win),
                    MPI_BYTE, comm);
 
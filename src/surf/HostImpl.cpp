@@ -30,12 +30,14 @@ HostImpl::HostImpl(const std::string& name, s4u::Host* piface) : piface_(this),
 {
   xbt_assert(s4u::Host::by_name_or_null(name_) == nullptr, "Refusing to create a second host named '%s'.", get_cname());
   s4u::Engine::get_instance()->host_register(name_, piface);
+  id_ = kernel::EngineImpl::get_instance()->add_host_id(piface);
 }
 
 HostImpl::HostImpl(const std::string& name) : piface_(this), name_(name)
 {
   xbt_assert(s4u::Host::by_name_or_null(name_) == nullptr, "Refusing to create a second host named '%s'.", get_cname());
   s4u::Engine::get_instance()->host_register(name_, &piface_);
+  id_ = kernel::EngineImpl::get_instance()->add_host_id(&piface_);
 }
 
 HostImpl::~HostImpl()
@@ -65,6 +67,7 @@ void HostImpl::destroy()
 {
   s4u::Host::on_destruction(*this->get_iface());
   s4u::Engine::get_instance()->host_unregister(std::string(name_));
+  kernel::EngineImpl::get_instance()->remove_host_id(id_);
   delete this;
 }
 
@@ -51,6 +51,7 @@ class XBT_PRIVATE HostImpl : public xbt::PropertyHolder {
   s4u::Host piface_;
   std::vector<kernel::resource::DiskImpl*> disks_;
   xbt::string name_{"noname"};
+  unsigned long id_;
   bool sealed_ = false;
 
 protected:
@@ -75,6 +76,8 @@ public:
   xbt::string const& get_name() const { return name_; }
   /** Retrieves the name of that host as a C string */
   const char* get_cname() const { return name_.c_str(); }
+  /** Retrieves the dense id of that host */
+  unsigned long get_id() const { return id_; }
 
   void turn_on() const;
   void turn_off(const kernel::actor::ActorImpl* issuer);
@@ -5,6 +5,7 @@
 
 #include "src/surf/LinkImpl.hpp"
 #include "simgrid/s4u/Engine.hpp"
+#include "src/kernel/EngineImpl.hpp"
 #include "surf/surf.hpp"
 
 #include <numeric>
@@ -25,6 +26,7 @@ LinkImpl::LinkImpl(const std::string& name) : LinkImplIntf(name), piface_(this)
     xbt_assert(not s4u::Link::by_name_or_null(name), "Link '%s' declared several times in the platform.", name.c_str());
 
   s4u::Engine::get_instance()->link_register(name, &piface_);
+  id_ = EngineImpl::get_instance()->add_link_id(&piface_);
   XBT_DEBUG("Create link '%s'", name.c_str());
 }
 
@@ -35,6 +37,7 @@ LinkImpl::LinkImpl(const std::string& name) : LinkImplIntf(name), piface_(this)
 void LinkImpl::destroy()
 {
   s4u::Link::on_destruction(this->piface_);
+  EngineImpl::get_instance()->remove_link_id(id_);
   delete this;
 }
 
@@ -25,6 +25,7 @@ namespace resource {
 class LinkImpl : public LinkImplIntf {
   s4u::Link piface_;
   s4u::Link::SharingPolicy sharing_policy_ = s4u::Link::SharingPolicy::SHARED;
+  unsigned long id_;
 
 protected:
   explicit LinkImpl(const std::string& name);
@@ -43,6 +44,7 @@ public:
   /** @brief Public interface */
   const s4u::Link* get_iface() const { return &piface_; }
   s4u::Link* get_iface() { return &piface_; }
+  unsigned long get_id() const override { return id_; }
 
   /** @brief Get the bandwidth in bytes per second of current Link */
   double get_bandwidth() const override { return bandwidth_.peak * bandwidth_.scale; }
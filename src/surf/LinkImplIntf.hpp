@@ -27,6 +27,8 @@ namespace resource {
 class LinkImplIntf : public Resource_T<LinkImplIntf>, public xbt::PropertyHolder {
 public:
   using Resource_T::Resource_T;
+  /** @brief Dense id of that link, see s4u::Link::get_id() */
+  virtual unsigned long get_id() const = 0;
   /** @brief Get the bandwidth in bytes per second of current Link */
   virtual double get_bandwidth() const = 0;
   /** @brief Update the bandwidth in bytes per second of current Link */
@@ -4,6 +4,7 @@
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
 #include "src/surf/SplitDuplexLinkImpl.hpp"
+#include "src/kernel/EngineImpl.hpp"
 
 XBT_LOG_EXTERNAL_DEFAULT_CATEGORY(res_network);
 
@@ -18,6 +19,8 @@ namespace resource {
 SplitDuplexLinkImpl::SplitDuplexLinkImpl(const std::string& name, LinkImpl* link_up, LinkImpl* link_down)
     : LinkImplIntf(name), piface_(this), link_up_(link_up), link_down_(link_down)
 {
+  /* The split-duplex links live as long as the engine, so their id is never released */
+  id_ = EngineImpl::get_instance()->add_link_id(&piface_);
 }
 
 bool SplitDuplexLinkImpl::is_used() const
@@ -27,6 +27,7 @@ class SplitDuplexLinkImpl : public LinkImplIntf {
   s4u::SplitDuplexLink piface_;
   LinkImpl* link_up_;
   LinkImpl* link_down_;
+  unsigned long id_;
 
 protected:
   SplitDuplexLinkImpl(const LinkImpl&) = delete;
@@ -37,6 +38,8 @@ public:
   /** @brief Public interface */
   const s4u::SplitDuplexLink* get_iface() const { return &piface_; }
   s4u::SplitDuplexLink* get_iface() { return &piface_; }
+  /** @brief Dense id of that link, distinct from the ids of its UP and DOWN members */
+  unsigned long get_id() const override { return id_; }
 
   /** @brief Get the bandwidth in bytes per second of current Link */
   double get_bandwidth() const override { return link_up_->get_bandwidth(); }
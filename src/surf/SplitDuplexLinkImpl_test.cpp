@@ -27,6 +27,9 @@ TEST_CASE("SplitDuplexLink: create", "")
     REQUIRE(link_down->get_bandwidth() == 100e9);
     REQUIRE(link_up == link->get_link_up());
     REQUIRE(link_down == link->get_link_down());
+    REQUIRE(e.link_by_id(link->get_id()) == link);
+    REQUIRE(link->get_id() != link_up->get_id());
+    REQUIRE(link->get_id() != link_down->get_id());
   }
 
   SECTION("create double") { REQUIRE_NOTHROW(zone->create_split_duplex_link("link", 10e6)); }
@@ -74,6 +74,7 @@ public:
   CpuImpl& operator=(const CpuImpl&) = delete;
 
   /** @brief Public interface */
+  const s4u::Host* get_iface() const { return piface_; }
   s4u::Host* get_iface() { return piface_; }
 
   CpuImpl* set_core_count(int core_count);
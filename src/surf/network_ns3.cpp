@@ -412,8 +412,8 @@ void NetworkNS3Model::update_actions_state(double now, double delta)
 
       action->get_src().route_to(&action->get_dst(), route, nullptr);
       for (auto const& link : route)
-        instr::resource_set_utilization("LINK", "bandwidth_used", link->get_cname(), action->get_category(),
-                                        (data_delta_sent) / delta, now - delta, delta);
+        instr::resource_set_utilization(*link->get_iface(), action->get_category(), (data_delta_sent) / delta,
+                                        now - delta, delta);
 
       action->last_sent_ = sgFlow->sent_bytes_;
     }
@@ -12,6 +12,7 @@
 #include "simgrid/kernel/routing/FullZone.hpp"
 #include "simgrid/kernel/routing/NetPoint.hpp"
 #include "simgrid/kernel/routing/NetZoneImpl.hpp"
+#include "simgrid/kernel/routing/StarZone.hpp"
 #include "simgrid/kernel/routing/TorusZone.hpp"
 #include "simgrid/kernel/routing/VivaldiZone.hpp"
 #include "simgrid/kernel/routing/WifiZone.hpp"
@@ -27,10 +28,14 @@
 #include "src/surf/xml/platf_private.hpp"
 
 #include <algorithm>
+#include <memory>
 #include <string>
 
 XBT_LOG_EXTERNAL_DEFAULT_CATEGORY(surf_parse);
 
+static simgrid::config::Flag<bool> cfg_lazy_clusters{
+    "platform/lazy-clusters", "Only create the hosts of the regular clusters when they are first looked up", false};
+
 namespace simgrid {
 namespace kernel {
 namespace routing {
@@ -245,10 +250,79 @@ static void sg_platf_new_cluster_hierarchical(const simgrid::kernel::routing::Cl
 }
 
 /*************************************************************************************************/
+/** @brief Create a host of a regular Cluster, with its private links and its routes */
+static simgrid::s4u::Host* sg_platf_cluster_create_member(simgrid::s4u::NetZone* zone,
+                                                          const simgrid::kernel::routing::ClusterCreationArgs* cluster,
+                                                          int radical, const simgrid::s4u::Link* backbone)
+{
+  std::string host_id = std::string(cluster->prefix) + std::to_string(radical) + cluster->suffix;
+
+  XBT_DEBUG("<host\tid=\"%s\"\tspeed=\"%f\">", host_id.c_str(), cluster->speeds.front());
+  auto* host = zone->create_host(host_id, cluster->speeds)
+                   ->set_core_count(cluster->core_amount)
+                   ->set_properties(cluster->properties)
+                   ->seal();
+
+  XBT_DEBUG("</host>");
+
+  std::string link_id = std::string(cluster->id) + "_link_" + std::to_string(radical);
+  XBT_DEBUG("<link\tid=\"%s\"\tbw=\"%f\"\tlat=\"%f\"/>", link_id.c_str(), cluster->bw, cluster->lat);
+
+  // add a loopback link
+  if (cluster->loopback_bw > 0 || cluster->loopback_lat > 0) {
+    std::string loopback_name = link_id + "_loopback";
+    XBT_DEBUG("<loopback\tid=\"%s\"\tbw=\"%f\"/>", loopback_name.c_str(), cluster->loopback_bw);
+
+    const auto* loopback = zone->create_link(loopback_name, cluster->loopback_bw)
+                               ->set_sharing_policy(simgrid::s4u::Link::SharingPolicy::FATPIPE)
+                               ->set_latency(cluster->loopback_lat)
+                               ->seal();
+
+    zone->add_route(host->get_netpoint(), host->get_netpoint(), nullptr, nullptr,
+                    {simgrid::s4u::LinkInRoute(loopback)});
+  }
+
+  // add a limiter link (shared link to account for maximal bandwidth of the node)
+  const simgrid::s4u::Link* limiter = nullptr;
+  if (cluster->limiter_link > 0) {
+    std::string limiter_name = std::string(link_id) + "_limiter";
+    XBT_DEBUG("<limiter\tid=\"%s\"\tbw=\"%f\"/>", limiter_name.c_str(), cluster->limiter_link);
+
+    limiter = zone->create_link(limiter_name, cluster->limiter_link)->seal();
+  }
+
+  // create link
+  const simgrid::s4u::Link* link;
+  if (cluster->sharing_policy == simgrid::s4u::Link::SharingPolicy::SPLITDUPLEX) {
+    link = zone->create_split_duplex_link(link_id, cluster->bw)->set_latency(cluster->lat)->seal();
+  } else {
+    link = zone->create_link(link_id, cluster->bw)->set_latency(cluster->lat)->seal();
+  }
+
+  /* adding routes */
+  std::vector<simgrid::s4u::LinkInRoute> links;
+  if (limiter)
+    links.emplace_back(limiter);
+  links.emplace_back(link, simgrid::s4u::LinkInRoute::Direction::UP);
+  if (backbone)
+    links.emplace_back(backbone);
+
+  zone->add_route(host->get_netpoint(), nullptr, nullptr, nullptr, links, true);
+  return host;
+}
+
 /** @brief Create regular Cluster */
 static void sg_platf_new_cluster_flat(simgrid::kernel::routing::ClusterCreationArgs* cluster)
 {
-  auto* zone                          = simgrid::s4u::create_star_zone(cluster->id);
+  simgrid::kernel::routing::LazyStarZone* lazy_zone = nullptr;
+  simgrid::s4u::NetZone* zone;
+  if (cfg_lazy_clusters) {
+    lazy_zone = new simgrid::kernel::routing::LazyStarZone(cluster->id, cluster->prefix, cluster->suffix,
+                                                           cluster->radicals);
+    zone      = lazy_zone->get_iface();
+  } else {
+    zone = simgrid::s4u::create_star_zone(cluster->id);
+  }
   simgrid::s4u::NetZone const* parent = current_routing ? current_routing->get_iface() : nullptr;
   if (parent)
     zone->set_parent(parent);
@@ -270,60 +344,19 @@ static void sg_platf_new_cluster_flat(simgrid::kernel::routing::ClusterCreationA
                    ->seal();
   }
 
-  for (int const& i : cluster->radicals) {
-    std::string host_id = std::string(cluster->prefix) + std::to_string(i) + cluster->suffix;
-
-    XBT_DEBUG("<host\tid=\"%s\"\tspeed=\"%f\">", host_id.c_str(), cluster->speeds.front());
-    const auto* host = zone->create_host(host_id, cluster->speeds)
-                           ->set_core_count(cluster->core_amount)
-                           ->set_properties(cluster->properties)
-                           ->seal();
-
-    XBT_DEBUG("</host>");
-
-    std::string link_id = std::string(cluster->id) + "_link_" + std::to_string(i);
-    XBT_DEBUG("<link\tid=\"%s\"\tbw=\"%f\"\tlat=\"%f\"/>", link_id.c_str(), cluster->bw, cluster->lat);
-
-    // add a loopback link
-    if (cluster->loopback_bw > 0 || cluster->loopback_lat > 0) {
-      std::string loopback_name = link_id + "_loopback";
-      XBT_DEBUG("<loopback\tid=\"%s\"\tbw=\"%f\"/>", loopback_name.c_str(), cluster->loopback_bw);
-
-      const auto* loopback = zone->create_link(loopback_name, cluster->loopback_bw)
-                                 ->set_sharing_policy(simgrid::s4u::Link::SharingPolicy::FATPIPE)
-                                 ->set_latency(cluster->loopback_lat)
-                                 ->seal();
-
-      zone->add_route(host->get_netpoint(), host->get_netpoint(), nullptr, nullptr,
-                      {simgrid::s4u::LinkInRoute(loopback)});
-    }
-
-    // add a limiter link (shared link to account for maximal bandwidth of the node)
-    const simgrid::s4u::Link* limiter = nullptr;
-    if (cluster->limiter_link > 0) {
-      std::string limiter_name = std::string(link_id) + "_limiter";
-      XBT_DEBUG("<limiter\tid=\"%s\"\tbw=\"%f\"/>", limiter_name.c_str(), cluster->limiter_link);
-
-      limiter = zone->create_link(limiter_name, cluster->limiter_link)->seal();
-    }
-
-    // create link
-    const simgrid::s4u::Link* link;
-    if (cluster->sharing_policy == simgrid::s4u::Link::SharingPolicy::SPLITDUPLEX) {
-      link = zone->create_split_duplex_link(link_id, cluster->bw)->set_latency(cluster->lat)->seal();
-    } else {
-      link = zone->create_link(link_id, cluster->bw)->set_latency(cluster->lat)->seal();
-    }
-
-    /* adding routes */
-    std::vector<simgrid::s4u::LinkInRoute> links;
-    if (limiter)
-      links.emplace_back(limiter);
-    links.emplace_back(link, simgrid::s4u::LinkInRoute::Direction::UP);
-    if (backbone)
-      links.emplace_back(backbone);
-
-    zone->add_route(host->get_netpoint(), nullptr, nullptr, nullptr, links, true);
+  if (lazy_zone) {
+    /* The hosts are created after the parsing: keep a copy of the arguments, without the radicals that the zone
+     * already knows as intervals */
+    auto args = std::make_shared<simgrid::kernel::routing::ClusterCreationArgs>(*cluster);
+    args->radicals.clear();
+    args->radicals.shrink_to_fit();
+    lazy_zone->set_materialize_cb([zone, args, backbone](int radical) {
+      return sg_platf_cluster_create_member(zone, args.get(), radical, backbone);
+    });
+    XBT_DEBUG("Cluster %s: %lu hosts will be created on demand", cluster->id.c_str(), lazy_zone->get_member_count());
+  } else {
+    for (int const& i : cluster->radicals)
+      sg_platf_cluster_create_member(zone, cluster, i, backbone);
   }
 
   // Add a router.
@@ -610,6 +643,25 @@ void sg_platf_new_hostlink(const simgrid::kernel::routing::HostLinkCreationArgs*
   zone_cluster.host_links.emplace_back(*hostlink);
 }
 
+/** @brief Applies the configuration given in the platform file, unless the user already changed it */
+void sg_platf_new_config(const std::unordered_map<std::string, std::string>& props)
+{
+  // Sort config elements before applying.
+  // That's a little waste of time, but not doing so would break the tests
+  std::vector<std::string> keys;
+  for (auto const& kv : props) {
+    keys.push_back(kv.first);
+  }
+  std::sort(keys.begin(), keys.end());
+  for (const std::string& key : keys) {
+    if (simgrid::config::is_default(key.c_str())) {
+      std::string cfg = key + ":" + props.at(key);
+      simgrid::config::set_parse(cfg);
+    } else
+      XBT_INFO("The custom configuration '%s' is already defined by user!", key.c_str());
+  }
+}
+
 void sg_platf_new_trace(simgrid::kernel::routing::ProfileCreationArgs* args)
 {
   simgrid::kernel::profile::Profile* profile;
@@ -3,6 +3,7 @@
 /* This program is free software; you can redistribute it and/or modify it
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
+#include "simgrid/kernel/Profiler.hpp"
 #include "simgrid/s4u/Engine.hpp"
 #include "src/include/surf/surf.hpp"
 #include "src/instr/instr_private.hpp"
@@ -60,6 +61,8 @@ double surf_solve(double max_date)
     if (not model->next_occurring_event_is_idempotent()) {
       continue;
     }
+    simgrid::kernel::Profiler::sample(model);
+    simgrid::kernel::Profiler::Scope scope(simgrid::kernel::Profiler::solve(model));
     double next_event = model->next_occurring_event(NOW);
     if ((time_delta < 0.0 || next_event < time_delta) && next_event >= 0.0) {
       time_delta = next_event;
@@ -88,6 +91,8 @@ double surf_solve(double max_date)
 
       XBT_DEBUG("Run the NS3 network at most %fs", time_delta);
       // run until min or next flow
+      simgrid::kernel::Profiler::sample(model);
+      simgrid::kernel::Profiler::Scope scope(simgrid::kernel::Profiler::solve(model));
       double model_next_action_end = model->next_occurring_event(time_delta);
 
       XBT_DEBUG("Min for network : %f", model_next_action_end);
@@ -137,8 +142,10 @@ double surf_solve(double max_date)
   NOW = NOW + time_delta;
 
   // Inform the models of the date change
-  for (auto const& model : simgrid::kernel::EngineImpl::get_instance()->get_all_models())
+  for (auto const& model : simgrid::kernel::EngineImpl::get_instance()->get_all_models()) {
+    simgrid::kernel::Profiler::Scope scope(simgrid::kernel::Profiler::update(model));
     model->update_actions_state(NOW, time_delta);
+  }
 
   simgrid::s4u::Engine::on_time_advance(time_delta);
 
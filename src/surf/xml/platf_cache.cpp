@@ -0,0 +1,772 @@
+/* Copyright (c) 2021. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "src/surf/xml/platf_cache.hpp"
+#include "simgrid/kernel/routing/FloydZone.hpp"
+#include "simgrid/kernel/routing/NetPoint.hpp"
+#include "simgrid/s4u/Engine.hpp"
+#include "simgrid/s4u/NetZone.hpp"
+#include "simgrid/sg_config.hpp"
+#include "simgrid/version.h"
+#include "src/internal_config.h"
+#include "src/kernel/resource/profile/Profile.hpp"
+#include "src/surf/surf_interface.hpp"
+#include "src/surf/surf_private.hpp"
+#include "xbt/file.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+
+#if HAVE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#ifdef WIN32
+#include <direct.h> // _mkdir
+#endif
+
+XBT_LOG_NEW_DEFAULT_SUBCATEGORY(surf_parse_cache, surf_parse, "Caching of the parsed platforms");
+
+static simgrid::config::Flag<std::string> cfg_platform_cache{
+    "platform/cache", "Directory in which the parsed platform files are cached (empty to disable the cache)", ""};
+
+std::unique_ptr<simgrid::kernel::routing::PlatformCacheWriter> surf_parse_cache_writer;
+
+namespace simgrid {
+namespace kernel {
+namespace routing {
+
+/* Bump this when the layout of the cache files changes */
+constexpr uint32_t PLATFORM_CACHE_FORMAT = 1;
+constexpr char PLATFORM_CACHE_MAGIC[8]   = {'S', 'G', 'P', 'L', 'A', 'T', 'F', '\0'};
+
+enum class PlatformCacheOp : uint8_t {
+  ZONE_BEGIN,
+  ZONE_PROPERTIES,
+  ZONE_SEAL,
+  FLOYD_TABLE,
+  HOST_BEGIN,
+  HOST_PROPERTIES,
+  HOST_SEAL,
+  DISK,
+  HOSTLINK,
+  ROUTER,
+  CLUSTER,
+  CABINET,
+  PEER,
+  LINK,
+  BACKBONE,
+  ROUTE,
+  BYPASS_ROUTE,
+  TRACE,
+  TRACE_CONNECT,
+  CONFIG,
+  ACTOR,
+  PLATFORM_END
+};
+
+/*************************************************************************************************/
+PlatformCacheWriter::PlatformCacheWriter(const std::string& filename, uint64_t hash) : filename_(filename)
+{
+  buffer_.append(PLATFORM_CACHE_MAGIC, sizeof(PLATFORM_CACHE_MAGIC));
+  put_raw(PLATFORM_CACHE_FORMAT);
+  put_string(SIMGRID_VERSION_STRING);
+  put_raw(hash);
+
+  /* The routes of the Floyd zones are computed when sealing them: save them before the zone seal is recorded */
+  on_seal_id_ = s4u::NetZone::on_seal.connect([this](s4u::NetZone const& zone) {
+    auto const* floyd = dynamic_cast<const FloydZone*>(zone.get_impl());
+    if (floyd == nullptr)
+      return;
+    put_raw(PlatformCacheOp::FLOYD_TABLE);
+    put_string(floyd->get_name());
+    put_raw<uint32_t>(floyd->get_predecessor_table().size());
+    for (auto const& row : floyd->get_predecessor_table())
+      put_vector(row);
+  });
+}
+
+PlatformCacheWriter::~PlatformCacheWriter()
+{
+  s4u::NetZone::on_seal.disconnect(on_seal_id_);
+}
+
+void PlatformCacheWriter::put_string(const std::string& value)
+{
+  put_raw<uint32_t>(value.size());
+  buffer_.append(value);
+}
+
+void PlatformCacheWriter::put_properties(const std::unordered_map<std::string, std::string>& props)
+{
+  put_raw<uint32_t>(props.size());
+  for (auto const& kv : props) {
+    put_string(kv.first);
+    put_string(kv.second);
+  }
+}
+
+void PlatformCacheWriter::put_profile(const profile::Profile* profile)
+{
+  put_string(profile ? profile->get_name() : "");
+}
+
+void PlatformCacheWriter::put_netpoint(const NetPoint* netpoint)
+{
+  put_string(netpoint ? netpoint->get_name() : "");
+}
+
+void PlatformCacheWriter::put_link_list(const std::vector<s4u::LinkInRoute>& links)
+{
+  put_raw<uint32_t>(links.size());
+  for (auto const& link : links) {
+    put_string(link.get_link()->get_name());
+    put_raw(link.get_direction());
+  }
+}
+
+void PlatformCacheWriter::put_link(const LinkCreationArgs& link)
+{
+  put_string(link.id);
+  put_vector(link.bandwidths);
+  put_profile(link.bandwidth_trace);
+  put_raw(link.latency);
+  put_profile(link.latency_trace);
+  put_profile(link.state_trace);
+  put_raw(link.policy);
+  put_properties(link.properties);
+}
+
+void PlatformCacheWriter::put_route(const RouteCreationArgs& route)
+{
+  put_raw(route.symmetrical);
+  put_netpoint(route.src);
+  put_netpoint(route.dst);
+  put_netpoint(route.gw_src);
+  put_netpoint(route.gw_dst);
+  put_link_list(route.link_list);
+}
+
+void PlatformCacheWriter::zone_begin(const ZoneCreationArgs& zone)
+{
+  put_raw(PlatformCacheOp::ZONE_BEGIN);
+  put_string(zone.id);
+  put_string(zone.routing);
+}
+
+void PlatformCacheWriter::zone_set_properties(const std::unordered_map<std::string, std::string>& props)
+{
+  put_raw(PlatformCacheOp::ZONE_PROPERTIES);
+  put_properties(props);
+}
+
+void PlatformCacheWriter::zone_seal()
+{
+  put_raw(PlatformCacheOp::ZONE_SEAL);
+}
+
+void PlatformCacheWriter::host_begin(const HostCreationArgs& host)
+{
+  put_raw(PlatformCacheOp::HOST_BEGIN);
+  put_string(host.id);
+  put_vector(host.speed_per_pstate);
+  put_raw(host.pstate);
+  put_raw(host.core_amount);
+  put_profile(host.speed_trace);
+  put_profile(host.state_trace);
+  put_string(host.coord);
+}
+
+void PlatformCacheWriter::host_set_properties(const std::unordered_map<std::string, std::string>& props)
+{
+  put_raw(PlatformCacheOp::HOST_PROPERTIES);
+  put_properties(props);
+}
+
+void PlatformCacheWriter::host_seal(int pstate)
+{
+  put_raw(PlatformCacheOp::HOST_SEAL);
+  put_raw(pstate);
+}
+
+void PlatformCacheWriter::disk(const DiskCreationArgs& disk)
+{
+  put_raw(PlatformCacheOp::DISK);
+  put_string(disk.id);
+  put_properties(disk.properties);
+  put_raw(disk.read_bw);
+  put_raw(disk.write_bw);
+}
+
+void PlatformCacheWriter::hostlink(const HostLinkCreationArgs& hostlink)
+{
+  put_raw(PlatformCacheOp::HOSTLINK);
+  put_string(hostlink.id);
+  put_string(hostlink.link_up);
+  put_string(hostlink.link_down);
+}
+
+void PlatformCacheWriter::router(const std::string& name, const std::string& coords)
+{
+  put_raw(PlatformCacheOp::ROUTER);
+  put_string(name);
+  put_string(coords);
+}
+
+void PlatformCacheWriter::cluster(const ClusterCreationArgs& cluster)
+{
+  put_raw(PlatformCacheOp::CLUSTER);
+  put_string(cluster.id);
+  put_string(cluster.prefix);
+  put_string(cluster.suffix);
+  put_vector(cluster.radicals);
+  put_vector(cluster.speeds);
+  put_raw(cluster.core_amount);
+  put_raw(cluster.bw);
+  put_raw(cluster.lat);
+  put_raw(cluster.bb_bw);
+  put_raw(cluster.bb_lat);
+  put_raw(cluster.loopback_bw);
+  put_raw(cluster.loopback_lat);
+  put_raw(cluster.limiter_link);
+  put_raw(cluster.topology);
+  put_string(cluster.topo_parameters);
+  put_properties(cluster.properties);
+  put_string(cluster.router_id);
+  put_raw(cluster.sharing_policy);
+  put_raw(cluster.bb_sharing_policy);
+}
+
+void PlatformCacheWriter::cabinet(const CabinetCreationArgs& cabinet)
+{
+  put_raw(PlatformCacheOp::CABINET);
+  put_string(cabinet.id);
+  put_string(cabinet.prefix);
+  put_string(cabinet.suffix);
+  put_vector(cabinet.radicals);
+  put_raw(cabinet.speed);
+  put_raw(cabinet.bw);
+  put_raw(cabinet.lat);
+}
+
+void PlatformCacheWriter::peer(const PeerCreationArgs& peer)
+{
+  put_raw(PlatformCacheOp::PEER);
+  put_string(peer.id);
+  put_raw(peer.speed);
+  put_raw(peer.bw_in);
+  put_raw(peer.bw_out);
+  put_string(peer.coord);
+  put_profile(peer.speed_trace);
+  put_profile(peer.state_trace);
+}
+
+void PlatformCacheWriter::link(const LinkCreationArgs& link)
+{
+  put_raw(PlatformCacheOp::LINK);
+  put_link(link);
+}
+
+void PlatformCacheWriter::backbone(const LinkCreationArgs& link)
+{
+  put_raw(PlatformCacheOp::BACKBONE);
+  put_link(link);
+}
+
+void PlatformCacheWriter::route(const RouteCreationArgs& route)
+{
+  put_raw(PlatformCacheOp::ROUTE);
+  put_route(route);
+}
+
+void PlatformCacheWriter::bypass_route(const RouteCreationArgs& route)
+{
+  put_raw(PlatformCacheOp::BYPASS_ROUTE);
+  put_route(route);
+}
+
+void PlatformCacheWriter::trace(const ProfileCreationArgs& trace)
+{
+  put_raw(PlatformCacheOp::TRACE);
+  put_string(trace.id);
+  put_string(trace.file);
+  put_raw(trace.periodicity);
+  put_string(trace.pc_data);
+}
+
+void PlatformCacheWriter::trace_connect(const TraceConnectCreationArgs& trace_connect)
+{
+  put_raw(PlatformCacheOp::TRACE_CONNECT);
+  put_raw(trace_connect.kind);
+  put_string(trace_connect.trace);
+  put_string(trace_connect.element);
+}
+
+void PlatformCacheWriter::config(const std::unordered_map<std::string, std::string>& props)
+{
+  put_raw(PlatformCacheOp::CONFIG);
+  put_properties(props);
+}
+
+void PlatformCacheWriter::actor(const ActorCreationArgs& actor)
+{
+  put_raw(PlatformCacheOp::ACTOR);
+  put_raw<uint32_t>(actor.args.size());
+  for (auto const& arg : actor.args)
+    put_string(arg);
+  put_properties(actor.properties);
+  put_string(actor.host);
+  put_string(actor.function);
+  put_raw(actor.start_time);
+  put_raw(actor.kill_time);
+  put_raw(actor.restart_on_failure);
+}
+
+void PlatformCacheWriter::platform_end()
+{
+  put_raw(PlatformCacheOp::PLATFORM_END);
+}
+
+void PlatformCacheWriter::save() const
+{
+  std::string dir = xbt::Path(filename_).get_dir_name();
+#ifdef WIN32
+  _mkdir(dir.c_str());
+#else
+  mkdir(dir.c_str(), S_IRWXU | S_IRWXG | S_IRWXO);
+#endif
+
+  /* Write into a temporary file first, so that concurrent runs never read a partial cache file */
+#if HAVE_MMAP
+  std::string tmp_filename = filename_ + ".tmp" + std::to_string(getpid());
+#else
+  std::string tmp_filename = filename_ + ".tmp";
+#endif
+  std::ofstream os(tmp_filename, std::ofstream::binary);
+  uint64_t size = buffer_.size();
+  os.write(buffer_.data(), buffer_.size());
+  os.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  os.close();
+  if (os.fail() || std::rename(tmp_filename.c_str(), filename_.c_str()) != 0) {
+    XBT_WARN("Cannot save the platform into the cache file %s", filename_.c_str());
+    std::remove(tmp_filename.c_str());
+    return;
+  }
+  XBT_VERB("Platform saved into the cache (%zu bytes)", buffer_.size());
+  XBT_DEBUG("Cache file: %s", filename_.c_str());
+}
+
+/*************************************************************************************************/
+/** @brief Reads a platform cache file, mapped in memory when possible */
+class PlatformCacheReader {
+  const char* data_ = nullptr;
+  size_t size_      = 0;
+  size_t pos_       = 0;
+#if HAVE_MMAP
+  void* map_ = MAP_FAILED;
+#else
+  std::string content_;
+#endif
+
+  template <class T> T get_raw()
+  {
+    xbt_assert(pos_ + sizeof(T) <= size_, "Truncated platform cache file");
+    T value;
+    memcpy(&value, data_ + pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return value;
+  }
+  template <class T> std::vector<T> get_vector()
+  {
+    auto count = get_raw<uint32_t>();
+    xbt_assert(pos_ + count * sizeof(T) <= size_, "Truncated platform cache file");
+    std::vector<T> values(count);
+    memcpy(values.data(), data_ + pos_, count * sizeof(T));
+    pos_ += count * sizeof(T);
+    return values;
+  }
+  std::string get_string();
+  std::unordered_map<std::string, std::string> get_properties();
+  profile::Profile* get_profile();
+  NetPoint* get_netpoint();
+  std::vector<s4u::LinkInRoute> get_link_list();
+  void get_link(LinkCreationArgs* link);
+  void get_route(RouteCreationArgs* route);
+
+public:
+  explicit PlatformCacheReader(const std::string& filename);
+  PlatformCacheReader(const PlatformCacheReader&) = delete;
+  PlatformCacheReader& operator=(const PlatformCacheReader&) = delete;
+  ~PlatformCacheReader();
+
+  bool check_header(uint64_t hash);
+  void replay();
+};
+
+PlatformCacheReader::PlatformCacheReader(const std::string& filename)
+{
+#if HAVE_MMAP
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    return;
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_size > 0) {
+    map_ = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map_ != MAP_FAILED) {
+      data_ = static_cast<const char*>(map_);
+      size_ = st.st_size;
+    }
+  }
+  close(fd);
+#else
+  std::ifstream is(filename, std::ifstream::binary);
+  content_.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+  data_ = content_.data();
+  size_ = content_.size();
+#endif
+}
+
+PlatformCacheReader::~PlatformCacheReader()
+{
+#if HAVE_MMAP
+  if (map_ != MAP_FAILED)
+    munmap(map_, size_);
+#endif
+}
+
+bool PlatformCacheReader::check_header(uint64_t hash)
+{
+  /* The size of the content is appended to the file, to detect the truncated ones */
+  uint64_t size;
+  if (size_ < sizeof(PLATFORM_CACHE_MAGIC) + sizeof(size) ||
+      memcmp(data_, PLATFORM_CACHE_MAGIC, sizeof(PLATFORM_CACHE_MAGIC)) != 0)
+    return false;
+  memcpy(&size, data_ + size_ - sizeof(size), sizeof(size));
+  if (size != size_ - sizeof(size))
+    return false;
+  size_ = size;
+  pos_  = sizeof(PLATFORM_CACHE_MAGIC);
+
+  return get_raw<uint32_t>() == PLATFORM_CACHE_FORMAT && get_string() == SIMGRID_VERSION_STRING &&
+         get_raw<uint64_t>() == hash;
+}
+
+std::string PlatformCacheReader::get_string()
+{
+  auto length = get_raw<uint32_t>();
+  xbt_assert(pos_ + length <= size_, "Truncated platform cache file");
+  std::string value(data_ + pos_, length);
+  pos_ += length;
+  return value;
+}
+
+std::unordered_map<std::string, std::string> PlatformCacheReader::get_properties()
+{
+  std::unordered_map<std::string, std::string> props;
+  auto count = get_raw<uint32_t>();
+  for (uint32_t i = 0; i < count; i++) {
+    std::string key = get_string();
+    props.emplace(key, get_string());
+  }
+  return props;
+}
+
+profile::Profile* PlatformCacheReader::get_profile()
+{
+  std::string name = get_string();
+  return name.empty() ? nullptr : profile::Profile::from_file(name);
+}
+
+NetPoint* PlatformCacheReader::get_netpoint()
+{
+  std::string name = get_string();
+  if (name.empty())
+    return nullptr;
+  NetPoint* netpoint = s4u::Engine::get_instance()->netpoint_by_name_or_null(name);
+  xbt_assert(netpoint, "Netpoint '%s' of the platform cache not found", name.c_str());
+  return netpoint;
+}
+
+std::vector<s4u::LinkInRoute> PlatformCacheReader::get_link_list()
+{
+  std::vector<s4u::LinkInRoute> links;
+  auto count = get_raw<uint32_t>();
+  links.reserve(count);
+  for (uint32_t i = 0; i < count; i++) {
+    std::string name = get_string();
+    auto direction   = get_raw<s4u::LinkInRoute::Direction>();
+    const s4u::Link* link;
+    if (direction == s4u::LinkInRoute::Direction::NONE)
+      link = s4u::Link::by_name(name);
+    else
+      link = s4u::SplitDuplexLink::by_name(name);
+    links.emplace_back(link, direction);
+  }
+  return links;
+}
+
+void PlatformCacheReader::get_link(LinkCreationArgs* link)
+{
+  link->id              = get_string();
+  link->bandwidths      = get_vector<double>();
+  link->bandwidth_trace = get_profile();
+  link->latency         = get_raw<double>();
+  link->latency_trace   = get_profile();
+  link->state_trace     = get_profile();
+  link->policy          = get_raw<s4u::Link::SharingPolicy>();
+  link->properties      = get_properties();
+}
+
+void PlatformCacheReader::get_route(RouteCreationArgs* route)
+{
+  route->symmetrical = get_raw<bool>();
+  route->src         = get_netpoint();
+  route->dst         = get_netpoint();
+  route->gw_src      = get_netpoint();
+  route->gw_dst      = get_netpoint();
+  route->link_list   = get_link_list();
+}
+
+/** @brief Calls the sg_platf_* functions in the same order and with the same arguments as the XML parser did */
+void PlatformCacheReader::replay()
+{
+  while (pos_ < size_) {
+    switch (get_raw<PlatformCacheOp>()) {
+      case PlatformCacheOp::ZONE_BEGIN: {
+        ZoneCreationArgs zone;
+        zone.id      = get_string();
+        zone.routing = get_string();
+        sg_platf_new_zone_begin(&zone);
+        break;
+      }
+      case PlatformCacheOp::ZONE_PROPERTIES:
+        sg_platf_new_zone_set_properties(get_properties());
+        break;
+      case PlatformCacheOp::ZONE_SEAL:
+        sg_platf_new_zone_seal();
+        break;
+      case PlatformCacheOp::FLOYD_TABLE: {
+        std::string name = get_string();
+        std::vector<std::vector<int>> table(get_raw<uint32_t>());
+        for (auto& row : table)
+          row = get_vector<int>();
+        const s4u::NetZone* zone = s4u::Engine::get_instance()->netzone_by_name_or_null(name);
+        auto* floyd              = zone ? dynamic_cast<FloydZone*>(zone->get_impl()) : nullptr;
+        xbt_assert(floyd, "Floyd zone '%s' of the platform cache not found", name.c_str());
+        floyd->set_precomputed_predecessors(std::move(table));
+        break;
+      }
+      case PlatformCacheOp::HOST_BEGIN: {
+        HostCreationArgs host;
+        host.id               = get_string();
+        host.speed_per_pstate = get_vector<double>();
+        host.pstate           = get_raw<int>();
+        host.core_amount      = get_raw<int>();
+        host.speed_trace      = get_profile();
+        host.state_trace      = get_profile();
+        host.coord            = get_string();
+        sg_platf_new_host_begin(&host);
+        break;
+      }
+      case PlatformCacheOp::HOST_PROPERTIES:
+        sg_platf_new_host_set_properties(get_properties());
+        break;
+      case PlatformCacheOp::HOST_SEAL:
+        sg_platf_new_host_seal(get_raw<int>());
+        break;
+      case PlatformCacheOp::DISK: {
+        DiskCreationArgs disk;
+        disk.id         = get_string();
+        disk.properties = get_properties();
+        disk.read_bw    = get_raw<double>();
+        disk.write_bw   = get_raw<double>();
+        sg_platf_new_disk(&disk);
+        break;
+      }
+      case PlatformCacheOp::HOSTLINK: {
+        HostLinkCreationArgs hostlink;
+        hostlink.id        = get_string();
+        hostlink.link_up   = get_string();
+        hostlink.link_down = get_string();
+        sg_platf_new_hostlink(&hostlink);
+        break;
+      }
+      case PlatformCacheOp::ROUTER: {
+        std::string name = get_string();
+        sg_platf_new_router(name, get_string());
+        break;
+      }
+      case PlatformCacheOp::CLUSTER: {
+        ClusterCreationArgs cluster;
+        cluster.id                = get_string();
+        cluster.prefix            = get_string();
+        cluster.suffix            = get_string();
+        cluster.radicals          = get_vector<int>();
+        cluster.speeds            = get_vector<double>();
+        cluster.core_amount       = get_raw<int>();
+        cluster.bw                = get_raw<double>();
+        cluster.lat               = get_raw<double>();
+        cluster.bb_bw             = get_raw<double>();
+        cluster.bb_lat            = get_raw<double>();
+        cluster.loopback_bw       = get_raw<double>();
+        cluster.loopback_lat      = get_raw<double>();
+        cluster.limiter_link      = get_raw<double>();
+        cluster.topology          = get_raw<ClusterTopology>();
+        cluster.topo_parameters   = get_string();
+        cluster.properties        = get_properties();
+        cluster.router_id         = get_string();
+        cluster.sharing_policy    = get_raw<s4u::Link::SharingPolicy>();
+        cluster.bb_sharing_policy = get_raw<s4u::Link::SharingPolicy>();
+        sg_platf_new_tag_cluster(&cluster);
+        break;
+      }
+      case PlatformCacheOp::CABINET: {
+        CabinetCreationArgs cabinet;
+        cabinet.id       = get_string();
+        cabinet.prefix   = get_string();
+        cabinet.suffix   = get_string();
+        cabinet.radicals = get_vector<int>();
+        cabinet.speed    = get_raw<double>();
+        cabinet.bw       = get_raw<double>();
+        cabinet.lat      = get_raw<double>();
+        sg_platf_new_cabinet(&cabinet);
+        break;
+      }
+      case PlatformCacheOp::PEER: {
+        PeerCreationArgs peer;
+        peer.id          = get_string();
+        peer.speed       = get_raw<double>();
+        peer.bw_in       = get_raw<double>();
+        peer.bw_out      = get_raw<double>();
+        peer.coord       = get_string();
+        peer.speed_trace = get_profile();
+        peer.state_trace = get_profile();
+        sg_platf_new_peer(&peer);
+        break;
+      }
+      case PlatformCacheOp::LINK: {
+        LinkCreationArgs link;
+        get_link(&link);
+        sg_platf_new_link(&link);
+        break;
+      }
+      case PlatformCacheOp::BACKBONE: {
+        auto link = std::make_unique<LinkCreationArgs>();
+        get_link(link.get());
+        routing_cluster_add_backbone(std::move(link));
+        break;
+      }
+      case PlatformCacheOp::ROUTE: {
+        RouteCreationArgs route;
+        get_route(&route);
+        sg_platf_new_route(&route);
+        break;
+      }
+      case PlatformCacheOp::BYPASS_ROUTE: {
+        RouteCreationArgs route;
+        get_route(&route);
+        sg_platf_new_bypass_route(&route);
+        break;
+      }
+      case PlatformCacheOp::TRACE: {
+        ProfileCreationArgs trace;
+        trace.id          = get_string();
+        trace.file        = get_string();
+        trace.periodicity = get_raw<double>();
+        trace.pc_data     = get_string();
+        sg_platf_new_trace(&trace);
+        break;
+      }
+      case PlatformCacheOp::TRACE_CONNECT: {
+        TraceConnectCreationArgs trace_connect;
+        trace_connect.kind    = get_raw<TraceConnectKind>();
+        trace_connect.trace   = get_string();
+        trace_connect.element = get_string();
+        sg_platf_trace_connect(&trace_connect);
+        break;
+      }
+      case PlatformCacheOp::CONFIG:
+        sg_platf_new_config(get_properties());
+        break;
+      case PlatformCacheOp::ACTOR: {
+        ActorCreationArgs actor;
+        actor.args.resize(get_raw<uint32_t>());
+        for (auto& arg : actor.args)
+          arg = get_string();
+        actor.properties        = get_properties();
+        std::string host        = get_string();
+        std::string function    = get_string();
+        actor.host              = host.c_str();
+        actor.function          = function.c_str();
+        actor.start_time        = get_raw<double>();
+        actor.kill_time         = get_raw<double>();
+        actor.restart_on_failure = get_raw<bool>();
+        sg_platf_new_actor(&actor);
+        break;
+      }
+      case PlatformCacheOp::PLATFORM_END:
+        s4u::Engine::on_platform_created();
+        break;
+      default:
+        xbt_die("Corrupted platform cache file");
+    }
+  }
+}
+
+} // namespace routing
+} // namespace kernel
+} // namespace simgrid
+
+/* FNV-1a: there is no need for a cryptographic hash to detect the changes of a platform file */
+static uint64_t hash_file(FILE* file)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  char buffer[65536];
+  size_t read;
+  while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    for (size_t i = 0; i < read; i++) {
+      hash ^= static_cast<unsigned char>(buffer[i]);
+      hash *= 1099511628211ULL;
+    }
+  }
+  return hash;
+}
+
+std::string surf_parse_cache_filename(const std::string& file, uint64_t* hash)
+{
+  if (cfg_platform_cache.get().empty())
+    return "";
+
+  FILE* platf = surf_fopen(file, "rb");
+  if (platf == nullptr) // Let the parser complain about it
+    return "";
+  *hash = hash_file(platf);
+  fclose(platf);
+
+  char hex[17];
+  snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(*hash));
+  return cfg_platform_cache.get() + "/" + simgrid::xbt::Path(file).get_base_name() + "." + hex + ".cache";
+}
+
+bool surf_parse_cache_load(const std::string& cache_file, uint64_t hash, const std::string& file)
+{
+  simgrid::kernel::routing::PlatformCacheReader reader(cache_file);
+  if (not reader.check_header(hash)) {
+    XBT_VERB("Platform not found in the cache: parsing %s", file.c_str());
+    XBT_DEBUG("Cache file: %s", cache_file.c_str());
+    return false;
+  }
+
+  XBT_VERB("Loading the platform from the cache");
+  XBT_DEBUG("Cache file: %s", cache_file.c_str());
+  /* The profiles are still read from their files, found relatively to the platform file */
+  surf_path.push_back(simgrid::xbt::Path(file).get_dir_name());
+  reader.replay();
+  surf_path.pop_back();
+  return true;
+}
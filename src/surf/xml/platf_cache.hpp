@@ -0,0 +1,93 @@
+/* platf_cache.hpp - Saving the parsed platforms, to create them again without parsing their file */
+
+/* Copyright (c) 2021. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#ifndef SURF_PLATF_CACHE_HPP
+#define SURF_PLATF_CACHE_HPP
+
+#include "src/surf/xml/platf_private.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace simgrid {
+namespace kernel {
+namespace routing {
+
+/** @brief Records the platform elements created by the XML parser, to save them into the platform cache
+ *
+ * The elements are recorded as the parser passes them to the sg_platf_* functions, before these functions get the
+ * chance to modify their arguments. The predecessor tables of the Floyd zones are recorded when the zones get sealed,
+ * since their computation is the most expensive part of the creation of such zones.
+ */
+class PlatformCacheWriter {
+  std::string filename_;
+  std::string buffer_;
+  unsigned int on_seal_id_;
+
+  template <class T> void put_raw(T value) { buffer_.append(reinterpret_cast<const char*>(&value), sizeof(T)); }
+  template <class T> void put_vector(const std::vector<T>& values)
+  {
+    put_raw<uint32_t>(values.size());
+    buffer_.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+  }
+  void put_string(const std::string& value);
+  void put_properties(const std::unordered_map<std::string, std::string>& props);
+  void put_profile(const profile::Profile* profile);
+  void put_netpoint(const NetPoint* netpoint);
+  void put_link_list(const std::vector<s4u::LinkInRoute>& links);
+  void put_link(const LinkCreationArgs& link);
+  void put_route(const RouteCreationArgs& route);
+
+public:
+  PlatformCacheWriter(const std::string& filename, uint64_t hash);
+  PlatformCacheWriter(const PlatformCacheWriter&) = delete;
+  PlatformCacheWriter& operator=(const PlatformCacheWriter&) = delete;
+  ~PlatformCacheWriter();
+
+  void zone_begin(const ZoneCreationArgs& zone);
+  void zone_set_properties(const std::unordered_map<std::string, std::string>& props);
+  void zone_seal();
+  void host_begin(const HostCreationArgs& host);
+  void host_set_properties(const std::unordered_map<std::string, std::string>& props);
+  void host_seal(int pstate);
+  void disk(const DiskCreationArgs& disk);
+  void hostlink(const HostLinkCreationArgs& hostlink);
+  void router(const std::string& name, const std::string& coords);
+  void cluster(const ClusterCreationArgs& cluster);
+  void cabinet(const CabinetCreationArgs& cabinet);
+  void peer(const PeerCreationArgs& peer);
+  void link(const LinkCreationArgs& link);
+  void backbone(const LinkCreationArgs& link);
+  void route(const RouteCreationArgs& route);
+  void bypass_route(const RouteCreationArgs& route);
+  void trace(const ProfileCreationArgs& trace);
+  void trace_connect(const TraceConnectCreationArgs& trace_connect);
+  void config(const std::unordered_map<std::string, std::string>& props);
+  void actor(const ActorCreationArgs& actor);
+  void platform_end();
+
+  /** @brief Writes the recorded platform into the cache file */
+  void save() const;
+};
+
+} // namespace routing
+} // namespace kernel
+} // namespace simgrid
+
+/** The recorder of the platform file being parsed, if it must be saved into the platform cache */
+XBT_PRIVATE extern std::unique_ptr<simgrid::kernel::routing::PlatformCacheWriter> surf_parse_cache_writer;
+
+/** Gets the file caching that platform file and computes the hash of its content, or returns an empty string if the
+ * platform cache is disabled */
+XBT_PRIVATE std::string surf_parse_cache_filename(const std::string& file, uint64_t* hash);
+/** Creates the platform saved in that cache file. Returns false if that file is missing or stale. */
+XBT_PRIVATE bool surf_parse_cache_load(const std::string& cache_file, uint64_t hash, const std::string& file);
+
+#endif
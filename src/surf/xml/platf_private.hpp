@@ -15,6 +15,7 @@
 #include "src/surf/xml/simgrid_dtd.h"
 
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -207,6 +208,7 @@ XBT_PUBLIC void sg_platf_new_route(simgrid::kernel::routing::RouteCreationArgs*
 XBT_PUBLIC void sg_platf_new_bypass_route(simgrid::kernel::routing::RouteCreationArgs* route); // Add a bypass route
 
 XBT_PUBLIC void sg_platf_new_trace(simgrid::kernel::routing::ProfileCreationArgs* trace);
+XBT_PRIVATE void sg_platf_new_config(const std::unordered_map<std::string, std::string>& props);
 
 
 XBT_PUBLIC void sg_platf_new_actor(simgrid::kernel::routing::ActorCreationArgs* actor);
@@ -7,6 +7,7 @@
 #include "src/surf/cpu_interface.hpp"
 #include "src/surf/network_interface.hpp"
 #include "src/surf/surf_interface.hpp"
+#include "src/surf/xml/platf_cache.hpp"
 #include "src/surf/xml/platf_private.hpp"
 
 #include <vector>
@@ -57,50 +58,9 @@ void sg_platf_trace_connect(simgrid::kernel::routing::TraceConnectCreationArgs*
   }
 }
 
-/* This function acts as a main in the parsing area. */
-void parse_platform_file(const std::string& file)
+/* Connect the profiles given by <trace_connect> tags to their resources */
+static void connect_profiles()
 {
-  const char* cfile = file.c_str();
-  size_t len        = strlen(cfile);
-  bool is_lua       = len > 3 && file[len - 3] == 'l' && file[len - 2] == 'u' && file[len - 1] == 'a';
-
-  sg_platf_init();
-
-  /* Check if file extension is "lua". If so, we will use
-   * the lua bindings to parse the platform file (since it is
-   * written in lua). If not, we will use the (old?) XML parser
-   */
-  if (is_lua) {
-#if SIMGRID_HAVE_LUA
-    static bool already_warned = false;
-    if (not already_warned) { // XBT_ATTRIB_DEPRECATED_v332
-      XBT_WARN("You are using a lua platform file. This feature is deprecated and will disappear after SimGrid v3.31.");
-      already_warned = true;
-    }
-    lua_State* L = luaL_newstate();
-    luaL_openlibs(L);
-
-    luaL_loadfile(L, cfile); // This loads the file without executing it.
-
-    /* Run the script */
-    xbt_assert(lua_pcall(L, 0, 0, 0) == 0, "FATAL ERROR:\n  %s: %s\n\n", "Lua call failed. Error message:",
-               lua_tostring(L, -1));
-    lua_close(L);
-    return;
-#else
-    XBT_WARN("This looks like a lua platform file, but your SimGrid was not compiled with lua. Loading it as XML.");
-#endif
-  }
-
-  // Use XML parser
-
-  /* init the flex parser */
-  surf_parse_open(file);
-
-  /* Do the actual parsing */
-  surf_parse();
-
-  /* connect all profiles relative to hosts */
   for (auto const& elm : trace_connect_list_host_avail) {
     surf_parse_assert(traces_set_list.find(elm.first) != traces_set_list.end(), std::string("<trace_connect kind=\"HOST_AVAIL\">: Trace ")+elm.first+" undefined.");
     auto profile = traces_set_list.at(elm.first);
@@ -145,6 +105,71 @@ void parse_platform_file(const std::string& file)
     surf_parse_assert(link, std::string("<trace_connect kind=\"LATENCY\">: Link ") + elm.second + " undefined.");
     link->set_latency_profile(profile);
   }
+}
+
+/* This function acts as a main in the parsing area. */
+void parse_platform_file(const std::string& file)
+{
+  const char* cfile = file.c_str();
+  size_t len        = strlen(cfile);
+  bool is_lua       = len > 3 && file[len - 3] == 'l' && file[len - 2] == 'u' && file[len - 1] == 'a';
+
+  sg_platf_init();
+
+  /* Check if file extension is "lua". If so, we will use
+   * the lua bindings to parse the platform file (since it is
+   * written in lua). If not, we will use the (old?) XML parser
+   */
+  if (is_lua) {
+#if SIMGRID_HAVE_LUA
+    static bool already_warned = false;
+    if (not already_warned) { // XBT_ATTRIB_DEPRECATED_v332
+      XBT_WARN("You are using a lua platform file. This feature is deprecated and will disappear after SimGrid v3.31.");
+      already_warned = true;
+    }
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+
+    luaL_loadfile(L, cfile); // This loads the file without executing it.
+
+    /* Run the script */
+    xbt_assert(lua_pcall(L, 0, 0, 0) == 0, "FATAL ERROR:\n  %s: %s\n\n", "Lua call failed. Error message:",
+               lua_tostring(L, -1));
+    lua_close(L);
+    return;
+#else
+    XBT_WARN("This looks like a lua platform file, but your SimGrid was not compiled with lua. Loading it as XML.");
+#endif
+  }
+
+  // Use XML parser, unless that file was already parsed and saved into the platform cache
+  uint64_t hash          = 0;
+  std::string cache_file = surf_parse_cache_filename(file, &hash);
+  if (not cache_file.empty()) {
+    if (surf_parse_cache_load(cache_file, hash, file)) {
+      connect_profiles();
+      return;
+    }
+    surf_parse_cache_writer = std::make_unique<simgrid::kernel::routing::PlatformCacheWriter>(cache_file, hash);
+  }
+
+  try {
+    /* init the flex parser */
+    surf_parse_open(file);
+
+    /* Do the actual parsing */
+    surf_parse();
+
+    connect_profiles();
+
+    surf_parse_close();
+  } catch (...) {
+    surf_parse_cache_writer.reset();
+    throw;
+  }
 
-  surf_parse_close();
+  if (surf_parse_cache_writer) {
+    surf_parse_cache_writer->save();
+    surf_parse_cache_writer.reset();
+  }
 }
@@ -11,6 +11,7 @@
 #include "src/kernel/resource/profile/Profile.hpp"
 #include "src/surf/network_interface.hpp"
 #include "src/surf/surf_interface.hpp"
+#include "src/surf/xml/platf_cache.hpp"
 #include "src/surf/xml/platf_private.hpp"
 #include "surf/surf.hpp"
 #include "xbt/file.hpp"
@@ -220,6 +221,8 @@ void STag_surfxml_platform() {
              "Please update your code, or use another, more adapted, file.");
 }
 void ETag_surfxml_platform(){
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->platform_end();
   simgrid::s4u::Engine::on_platform_created();
 }
 
@@ -253,15 +256,22 @@ void STag_surfxml_host()
                          : nullptr;
   host.coord       = A_surfxml_host_coordinates;
 
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->host_begin(host);
   sg_platf_new_host_begin(&host);
 }
 
 void ETag_surfxml_host()
 {
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->host_set_properties(property_sets.back());
   sg_platf_new_host_set_properties(property_sets.back());
   property_sets.pop_back();
 
-  sg_platf_new_host_seal(surf_parse_get_int(A_surfxml_host_pstate));
+  int pstate = surf_parse_get_int(A_surfxml_host_pstate);
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->host_seal(pstate);
+  sg_platf_new_host_seal(pstate);
 }
 
 void STag_surfxml_disk() {
@@ -279,6 +289,8 @@ void ETag_surfxml_disk() {
   disk.write_bw = xbt_parse_get_bandwidth(surf_parsed_filename, surf_parse_lineno, A_surfxml_disk_write___bw,
                                           "write_bw of disk " + disk.id);
 
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->disk(disk);
   sg_platf_new_disk(&disk);
 }
 
@@ -289,10 +301,14 @@ void STag_surfxml_host___link(){
   host_link.id        = A_surfxml_host___link_id;
   host_link.link_up   = A_surfxml_host___link_up;
   host_link.link_down = A_surfxml_host___link_down;
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->hostlink(host_link);
   sg_platf_new_hostlink(&host_link);
 }
 
 void STag_surfxml_router(){
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->router(A_surfxml_router_id, A_surfxml_router_coordinates);
   sg_platf_new_router(A_surfxml_router_id, A_surfxml_router_coordinates);
 }
 
@@ -378,6 +394,8 @@ void ETag_surfxml_cluster(){
     surf_parse_error(std::string("Invalid bb sharing policy in cluster ") + cluster.id);
   }
 
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->cluster(cluster);
   sg_platf_new_tag_cluster(&cluster);
 }
 
@@ -398,6 +416,8 @@ void STag_surfxml_cabinet(){
                                    "lat of cabinet " + cabinet.id);
   explodesRadical(A_surfxml_cabinet_radical, &cabinet.radicals);
 
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->cabinet(cabinet);
   sg_platf_new_cabinet(&cabinet);
 }
 
@@ -427,6 +447,8 @@ void STag_surfxml_peer(){
     XBT_WARN("The latency attribute in <peer> is now deprecated. Use the z coordinate instead of '%s'.",
              A_surfxml_peer_lat);
 
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->peer(peer);
   sg_platf_new_peer(&peer);
 }
 
@@ -476,6 +498,8 @@ void ETag_surfxml_link(){
     surf_parse_error(std::string("Invalid sharing policy in link ") + link.id);
   }
 
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->link(link);
   sg_platf_new_link(&link);
 }
 
@@ -526,6 +550,8 @@ void ETag_surfxml_backbone()
                                      "latency of backbone " + link->id);
   link->policy  = simgrid::s4u::Link::SharingPolicy::SHARED;
 
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->backbone(*link);
   routing_cluster_add_backbone(std::move(link));
 }
 
@@ -577,6 +603,8 @@ void ETag_surfxml_route(){
 
   route.link_list.swap(parsed_link_list);
 
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->route(route);
   sg_platf_new_route(&route);
 }
 
@@ -605,6 +633,8 @@ void ETag_surfxml_zoneRoute()
                          A_surfxml_zoneRoute_symmetrical == A_surfxml_zoneRoute_symmetrical_YES ||
                          A_surfxml_zoneRoute_symmetrical == A_surfxml_zoneRoute_symmetrical_yes);
 
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->route(ASroute);
   sg_platf_new_route(&ASroute);
 }
 
@@ -617,6 +647,8 @@ void ETag_surfxml_bypassRoute(){
 
   route.link_list.swap(parsed_link_list);
 
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->bypass_route(route);
   sg_platf_new_bypass_route(&route);
 }
 
@@ -641,6 +673,8 @@ void ETag_surfxml_bypassZoneRoute()
   ASroute.gw_src = sg_netpoint_by_name_or_null(A_surfxml_bypassZoneRoute_gw___src);
   ASroute.gw_dst = sg_netpoint_by_name_or_null(A_surfxml_bypassZoneRoute_gw___dst);
 
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->bypass_route(ASroute);
   sg_platf_new_bypass_route(&ASroute);
 }
 
@@ -652,6 +686,8 @@ void ETag_surfxml_trace(){
   trace.periodicity = surf_parse_get_double(A_surfxml_trace_periodicity);
   trace.pc_data = surfxml_pcdata;
 
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->trace(trace);
   sg_platf_new_trace(&trace);
 }
 
@@ -682,6 +718,8 @@ void STag_surfxml_trace___connect()
   default:
     surf_parse_error("Invalid trace kind");
   }
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->trace_connect(trace_connect);
   sg_platf_trace_connect(&trace_connect);
 }
 
@@ -703,14 +741,21 @@ void STag_surfxml_zone()
   simgrid::kernel::routing::ZoneCreationArgs zone;
   zone.id      = A_surfxml_zone_id;
   zone.routing = A_surfxml_zone_routing;
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->zone_begin(zone);
   sg_platf_new_zone_begin(&zone);
 }
 
 void ETag_surfxml_zone()
 {
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->zone_set_properties(property_sets.back());
   sg_platf_new_zone_set_properties(property_sets.back());
   property_sets.pop_back();
   sg_platf_new_zone_seal();
+  // Recorded after the routes that the Floyd zones computed while sealing, since they are needed before sealing them
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->zone_seal();
 }
 
 void STag_surfxml_config()
@@ -725,22 +770,9 @@ void STag_surfxml_config()
 
 void ETag_surfxml_config()
 {
-  // Sort config elements before applying.
-  // That's a little waste of time, but not doing so would break the tests
-  auto current_property_set = property_sets.back();
-
-  std::vector<std::string> keys;
-  for (auto const& kv : current_property_set) {
-    keys.push_back(kv.first);
-  }
-  std::sort(keys.begin(), keys.end());
-  for (const std::string& key : keys) {
-    if (simgrid::config::is_default(key.c_str())) {
-      std::string cfg = key + ":" + current_property_set.at(key);
-      simgrid::config::set_parse(cfg);
-    } else
-      XBT_INFO("The custom configuration '%s' is already defined by user!", key.c_str());
-  }
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->config(property_sets.back());
+  sg_platf_new_config(property_sets.back());
   XBT_DEBUG("End configuration name = %s",A_surfxml_config_id);
 
   property_sets.pop_back();
@@ -795,6 +827,8 @@ void ETag_surfxml_actor()
     surf_parse_error("Invalid on failure behavior");
   }
 
+  if (surf_parse_cache_writer)
+    surf_parse_cache_writer->actor(actor);
   sg_platf_new_actor(&actor);
 }
 
@@ -0,0 +1,193 @@
+/* Copyright (c) 2021. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+#include "src/include/catch.hpp"
+#include "xbt/indexed_heap.hpp"
+#include "xbt/utility.hpp"
+
+#include <boost/heap/fibonacci_heap.hpp>
+#include <boost/heap/pairing_heap.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+struct Elem {
+  int key;
+  std::size_t* position;
+  bool operator<(const Elem& other) const { return key < other.key; }
+};
+
+class ElemPosition {
+public:
+  void operator()(const Elem& elem, std::size_t pos) const { *elem.position = pos; }
+};
+
+/* Benchmark: push N dates, update N randomly chosen elements, and pop everything */
+constexpr int BENCH_SIZE = 1000000;
+
+struct Dated {
+  double date;
+  unsigned long rank; // ties are broken in insertion order, as for the actions and timers
+  std::size_t* position;
+  bool operator<(const Dated& other) const { return date < other.date || (date == other.date && rank < other.rank); }
+};
+
+class DatedPosition {
+public:
+  void operator()(const Dated& elem, std::size_t pos) const { *elem.position = pos; }
+};
+
+struct BenchInput {
+  std::vector<double> dates;
+  std::vector<std::pair<int, double>> updates; // element, new date
+  BenchInput() : dates(BENCH_SIZE), updates(BENCH_SIZE)
+  {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> dist(0.0, 1000.0);
+    std::uniform_int_distribution<int> elem(0, BENCH_SIZE - 1);
+    for (auto& date : dates)
+      date = dist(gen);
+    for (auto& update : updates)
+      update = {elem(gen), dist(gen)};
+  }
+};
+
+class Chrono {
+  std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+
+public:
+  double lap()
+  {
+    auto now       = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double, std::milli>(now - start_).count();
+    start_         = now;
+    return elapsed;
+  }
+};
+
+void bench_report(const char* name, double push, double update, double pop, long disorders)
+{
+  std::printf("%-32s push: %7.1f ms, update: %7.1f ms, pop: %7.1f ms\n", name, push, update, pop);
+  REQUIRE(disorders == 0);
+}
+
+template <unsigned Arity> void bench_indexed_heap(const char* name, const BenchInput& input)
+{
+  std::vector<std::size_t> positions(BENCH_SIZE);
+  simgrid::xbt::IndexedHeap<Dated, std::less<Dated>, DatedPosition, Arity> heap;
+  unsigned long rank = 0;
+  long disorders     = 0;
+  Chrono chrono;
+  for (int i = 0; i < BENCH_SIZE; i++)
+    heap.push({input.dates[i], rank++, &positions[i]});
+  double push = chrono.lap();
+  for (auto const& update : input.updates)
+    heap.update(positions[update.first], {update.second, rank++, &positions[update.first]});
+  double update = chrono.lap();
+  for (double last = 0.0; not heap.empty(); heap.pop()) {
+    disorders += heap.top().date < last;
+    last = heap.top().date;
+  }
+  bench_report(name, push, update, chrono.lap(), disorders);
+}
+
+template <class Heap> void bench_boost_heap(const char* name, const BenchInput& input)
+{
+  std::vector<typename Heap::handle_type> handles(BENCH_SIZE);
+  Heap heap;
+  long disorders = 0;
+  Chrono chrono;
+  for (int i = 0; i < BENCH_SIZE; i++)
+    handles[i] = heap.push({input.dates[i], i});
+  double push = chrono.lap();
+  for (auto const& update : input.updates)
+    heap.update(handles[update.first], {update.second, update.first});
+  double update = chrono.lap();
+  for (double last = 0.0; not heap.empty(); heap.pop()) {
+    disorders += heap.top().first < last;
+    last = heap.top().first;
+  }
+  bench_report(name, push, update, chrono.lap(), disorders);
+}
+} // namespace
+
+TEST_CASE("xbt::IndexedHeap: d-ary heap with updatable elements", "IndexedHeap")
+{
+  SECTION("Plain priority queue")
+  {
+    simgrid::xbt::IndexedHeap<int> heap;
+    std::vector<int> values(1000);
+    std::iota(values.begin(), values.end(), 0);
+    std::shuffle(values.begin(), values.end(), std::mt19937(42));
+    for (int v : values)
+      heap.push(v);
+
+    REQUIRE(heap.size() == values.size());
+    for (int expected = 0; expected < 1000; expected++) {
+      REQUIRE(heap.top() == expected);
+      heap.pop();
+    }
+    REQUIRE(heap.empty());
+  }
+
+  SECTION("Update and remove elements given their position")
+  {
+    constexpr int N = 500;
+    std::vector<std::size_t> positions(N);
+    std::vector<int> keys(N);
+    simgrid::xbt::IndexedHeap<Elem, std::less<Elem>, ElemPosition, 3> heap;
+    std::mt19937 gen(12345);
+    std::uniform_int_distribution<int> dist(0, 10 * N);
+
+    for (int i = 0; i < N; i++) {
+      keys[i] = dist(gen);
+      heap.push({keys[i], &positions[i]});
+    }
+    for (int i = 0; i < N; i++)
+      REQUIRE(heap.at(positions[i]).position == &positions[i]);
+
+    /* Increase or decrease the keys of half of the elements, and remove a tenth of them */
+    std::vector<bool> removed(N, false);
+    for (int i = 0; i < N; i += 2) {
+      keys[i] = dist(gen);
+      heap.update(positions[i], {keys[i], &positions[i]});
+    }
+    for (int i = 1; i < N; i += 10) {
+      heap.erase(positions[i]);
+      removed[i] = true;
+    }
+
+    std::vector<int> expected;
+    for (int i = 0; i < N; i++)
+      if (not removed[i])
+        expected.push_back(keys[i]);
+    std::sort(expected.begin(), expected.end());
+
+    REQUIRE(heap.size() == expected.size());
+    for (int key : expected) {
+      REQUIRE(heap.top().key == key);
+      heap.pop();
+    }
+    REQUIRE(heap.empty());
+  }
+}
+
+TEST_CASE("xbt::IndexedHeap: throughput compared to the boost heaps", "[.][bench]")
+{
+  using Pair = std::pair<double, int>;
+  using Comparator = boost::heap::compare<simgrid::xbt::HeapComparator<Pair>>;
+  const BenchInput input;
+
+  bench_indexed_heap<2>("IndexedHeap (binary)", input);
+  bench_indexed_heap<4>("IndexedHeap (4-ary, default)", input);
+  bench_boost_heap<boost::heap::pairing_heap<Pair, boost::heap::constant_time_size<false>, boost::heap::stable<true>,
+                                             Comparator>>("boost pairing_heap (stable)", input);
+  bench_boost_heap<boost::heap::fibonacci_heap<Pair, Comparator>>("boost fibonacci_heap", input);
+}
@@ -51,6 +51,79 @@ bool ReplayReader::get(ReplayAction* action)
   return not fs.eof();
 }
 
+/** @brief Expands a loop of the traces where the repeated sequences of actions were folded
+ *
+ * Such loops are given as "<actor> loop <iterations>", the actions of the loop body (possibly with other loops), and
+ * "<actor> end_loop". Only the body of the loop is kept in memory, and its actions are given back one at a time.
+ */
+class LoopExpander {
+  struct Frame {
+    size_t begin;
+    size_t end;
+    unsigned long remaining;
+  };
+  std::vector<ReplayAction> body_;
+  std::vector<size_t> loop_ends_; // position of the matching end_loop, for the actions of body_ that begin a loop
+  std::vector<Frame> frames_;
+  size_t pos_ = 0;
+
+  static unsigned long get_iterations(const ReplayAction& loop)
+  {
+    unsigned long iterations = std::stoul(loop[2]);
+    xbt_assert(iterations > 0, "Invalid iteration count in the trace of %s: %s", loop[0].c_str(), loop[2].c_str());
+    return iterations;
+  }
+
+public:
+  static bool is_loop(const ReplayAction& action) { return action.size() == 3 && action[1] == "loop"; }
+
+  /* Reads the body of the given loop with read(), up to its end_loop */
+  LoopExpander(const ReplayAction& loop, const std::function<bool(ReplayAction&)>& read)
+  {
+    std::vector<size_t> open_loops;
+    ReplayAction action;
+    while (true) {
+      action.clear();
+      xbt_assert(read(action), "Unterminated loop in the trace of %s", loop[0].c_str());
+      if (action.size() >= 2 && action[1] == "end_loop") {
+        if (open_loops.empty())
+          break;
+        loop_ends_[open_loops.back()] = body_.size();
+        open_loops.pop_back();
+      } else if (is_loop(action)) {
+        open_loops.push_back(body_.size());
+      }
+      body_.push_back(std::move(action));
+      loop_ends_.push_back(0);
+    }
+    frames_.push_back({0, body_.size(), get_iterations(loop)});
+  }
+
+  bool next(ReplayAction& action)
+  {
+    while (not frames_.empty()) {
+      Frame& frame = frames_.back();
+      if (pos_ == frame.end) {
+        frame.remaining--;
+        if (frame.remaining > 0) {
+          pos_ = frame.begin;
+        } else {
+          pos_ = frame.end + 1;
+          frames_.pop_back();
+        }
+      } else if (is_loop(body_[pos_])) {
+        frames_.push_back({pos_ + 1, loop_ends_[pos_], get_iterations(body_[pos_])});
+        pos_++;
+      } else {
+        action = body_[pos_];
+        pos_++;
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
 static ReplayAction* get_action(const char* name)
 {
   ReplayAction* action;
@@ -108,6 +181,19 @@ static void handle_action(ReplayAction& action)
   }
 }
 
+/* Handles the given action, or all the actions of the loop that it begins, whose body is read with read() */
+static void handle_or_expand_action(ReplayAction& action, const std::function<bool(ReplayAction&)>& read)
+{
+  if (not LoopExpander::is_loop(action)) {
+    handle_action(action);
+    return;
+  }
+  LoopExpander loop(action, read);
+  ReplayAction current;
+  while (loop.next(current))
+    handle_action(current);
+}
+
 /**
  * @ingroup XBT_replay
  * @brief function used internally to actually run the replay
@@ -119,11 +205,19 @@ int replay_runner(const char* actor_name, const char* trace_filename)
     xbt_assert(trace_filename == nullptr,
                "Passing nullptr to replay_runner() means that you want to use a shared trace, but you did not provide "
                "any. Please use xbt_replay_set_tracefile().");
+    auto read = [actor_name](ReplayAction& action) {
+      ReplayAction* evt = get_action(actor_name);
+      if (not evt)
+        return false;
+      action = std::move(*evt);
+      delete evt;
+      return true;
+    };
     while (true) {
       simgrid::xbt::ReplayAction* evt = simgrid::xbt::get_action(actor_name);
       if (not evt)
         break;
-      simgrid::xbt::handle_action(*evt);
+      handle_or_expand_action(*evt, read);
       delete evt;
     }
     if (action_queues.find(actor_name_string) != action_queues.end()) {
@@ -137,9 +231,10 @@ int replay_runner(const char* actor_name, const char* trace_filename)
                "replay_runner().");
     simgrid::xbt::ReplayAction evt;
     simgrid::xbt::ReplayReader reader(trace_filename);
+    auto read = [&reader](ReplayAction& action) { return reader.get(&action); };
     while (reader.get(&evt)) {
       if (evt.front().compare(actor_name) == 0) {
-        simgrid::xbt::handle_action(evt);
+        handle_or_expand_action(evt, read);
       } else {
         XBT_WARN("Ignore trace element not for me (target='%s', I am '%s')", evt.front().c_str(), actor_name);
       }
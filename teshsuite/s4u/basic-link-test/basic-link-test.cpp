@@ -30,6 +30,7 @@ int main(int argc, char** argv)
     XBT_INFO("%s: latency = %.5f, bandwidth = %f", l->get_cname(), l->get_latency(), l->get_bandwidth());
     l->set_data(&user_data);
     xbt_assert(user_data == *static_cast<const std::string*>(l->get_data()), "User data was corrupted.");
+    xbt_assert(e.link_by_id(l->get_id()) == l, "Link %s not found from its id", l->get_cname());
   }
 
   return 0;
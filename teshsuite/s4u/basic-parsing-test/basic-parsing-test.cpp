@@ -66,6 +66,8 @@ int main(int argc, char** argv)
   XBT_INFO("Workstation number: %zu, link number: %zu", e.get_host_count(), e.get_link_count());
 
   std::vector<sg4::Host*> hosts = e.get_all_hosts();
+  for (auto* host : hosts)
+    xbt_assert(e.host_by_id(host->get_id()) == host, "Host %s not found from its id", host->get_cname());
   if (argc >= 3) {
     if (strcmp(argv[2], "ONE_LINK") == 0)
       test_one_link(hosts);
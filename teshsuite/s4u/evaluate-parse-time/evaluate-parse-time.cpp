@@ -4,6 +4,9 @@
  * under the terms of the license (GNU LGPL) which comes with this package. */
 
 // teshsuite/s4u/evaluate-parse-time/evaluate-parse-time examples/platforms/g5k.xml
+//
+// To compare the cold and cached load times, run it twice with the same platform cache:
+// teshsuite/s4u/evaluate-parse-time/evaluate-parse-time examples/platforms/g5k.xml --cfg=platform/cache:/tmp/platf-cache
 
 #include <cstdio>
 
@@ -0,0 +1,59 @@
+/* Copyright (c) 2021. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Checks that the self-profiler of the simulation kernel (debug/profile) counts each scope once: the models and the
+ * tracing are reached from the other phases, but the times of all the phases and models never exceed the duration
+ * of the simulation. */
+
+#include "simgrid/kernel/Profiler.hpp"
+#include "simgrid/s4u.hpp"
+
+#include <chrono>
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(s4u_test, "Messages specific for this s4u example");
+
+namespace sg4 = simgrid::s4u;
+using simgrid::kernel::Profiler;
+
+static void sender(int count)
+{
+  auto mailbox = sg4::Mailbox::by_name("mailbox");
+  for (int i = 0; i < count; i++)
+    mailbox->put(new int(i), 1e6);
+  mailbox->put(new int(-1), 0);
+}
+
+static void receiver()
+{
+  auto mailbox = sg4::Mailbox::by_name("mailbox");
+  while (*mailbox->get_unique<int>() >= 0)
+    sg4::this_actor::execute(1e8);
+}
+
+int main(int argc, char* argv[])
+{
+  sg4::Engine e(&argc, argv);
+  xbt_assert(argc == 2, "Usage: %s platform_file", argv[0]);
+  auto start = std::chrono::steady_clock::now();
+  e.load_platform(argv[1]);
+
+  sg4::Actor::create("sender", e.host_by_name("Tremblay"), sender, 10);
+  sg4::Actor::create("receiver", e.host_by_name("Jupiter"), receiver);
+
+  e.run();
+  double duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  const Profiler& profiler = e.get_profiler();
+  double profiled          = 0.0;
+  for (int i = 0; i < Profiler::PHASE_COUNT; i++)
+    profiled += profiler.get_phase(static_cast<Profiler::Phase>(i)).elapsed;
+  for (auto const& kv : profiler.get_models())
+    profiled += kv.second.solve.elapsed + kv.second.update.elapsed;
+
+  xbt_assert(profiled <= duration, "The profiled times sum up to %f s, but the simulation only lasted %f s", profiled,
+             duration);
+  XBT_INFO("The profiled times do not exceed the duration of the simulation");
+  return 0;
+}
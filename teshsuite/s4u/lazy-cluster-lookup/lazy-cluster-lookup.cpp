@@ -0,0 +1,43 @@
+/* Copyright (c) 2021. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* The hosts of a lazy cluster are created when first looked up, even when that lookup is done by an actor. Several
+ * actors look up the same hosts at once here, which must create each of them only once, also with parallel contexts. */
+
+#include "simgrid/s4u.hpp"
+
+XBT_LOG_NEW_DEFAULT_CATEGORY(s4u_test, "Messages specific for this s4u test");
+
+static void receiver()
+{
+  auto msg = simgrid::s4u::Mailbox::by_name(simgrid::s4u::this_actor::get_host()->get_name())->get_unique<int>();
+  XBT_INFO("Received message %d", *msg);
+}
+
+static void looker(int id)
+{
+  /* Two lookers look each host up */
+  std::string name         = "node-" + std::to_string(10 + id / 2) + ".simgrid.org";
+  simgrid::s4u::Host* host = simgrid::s4u::Host::by_name(name);
+  XBT_INFO("Found %s (speed: %g)", host->get_cname(), host->get_speed());
+  if (id % 2 == 0)
+    simgrid::s4u::Actor::create("receiver", host, receiver);
+  else
+    simgrid::s4u::Mailbox::by_name(name)->put(new int(id), 1e6);
+}
+
+int main(int argc, char* argv[])
+{
+  simgrid::s4u::Engine e(&argc, argv);
+  e.load_platform(argv[1]);
+
+  simgrid::s4u::Host* host = simgrid::s4u::Host::by_name("node-0.simgrid.org");
+  for (int id = 0; id < 8; id++)
+    simgrid::s4u::Actor::create("looker", host, looker, id);
+  e.run();
+
+  XBT_INFO("%zu hosts were created", e.get_host_count());
+  return 0;
+}
@@ -0,0 +1,160 @@
+/* Copyright (c) 2021. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Checks the predefined reduction operations on the predefined datatypes, with MPI_Reduce_local.
+ * With -b, also measures the throughput of MPI_SUM, MPI_MAX and MPI_MIN on int, float and double (in GB/s of reduced
+ * data, using the real clock of the machine and not the simulated one). */
+
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Buffers sizes that are not a multiple of the vector widths, to check the remainders too */
+#define COUNT 1021
+
+static int errors = 0;
+
+#define CHECK_OP(type, mpi_type, op, mpi_op)                                                                           \
+  do {                                                                                                                 \
+    type in[COUNT];                                                                                                    \
+    type inout[COUNT];                                                                                                 \
+    type expected[COUNT];                                                                                              \
+    for (int i = 0; i < COUNT; i++) {                                                                                  \
+      in[i]       = (type)(i % 7 + (i % 3 == 0 ? 0 : 1));                                                              \
+      inout[i]    = (type)(i % 5 + (i % 4 == 0 ? 0 : 2));                                                              \
+      expected[i] = inout[i];                                                                                          \
+      op(in[i], expected[i]);                                                                                          \
+    }                                                                                                                  \
+    MPI_Reduce_local(in, inout, COUNT, mpi_type, mpi_op);                                                              \
+    if (memcmp(inout, expected, sizeof(inout)) != 0) {                                                                 \
+      printf("Wrong result of %s on %s\n", #mpi_op, #mpi_type);                                                        \
+      errors++;                                                                                                        \
+    }                                                                                                                  \
+  } while (0)
+
+#define SUM(a, b) (b) = (b) + (a)
+#define PROD(a, b) (b) = (b) * (a)
+#define MAX(a, b) (b) = (a) > (b) ? (a) : (b)
+#define MIN(a, b) (b) = (a) < (b) ? (a) : (b)
+#define LAND(a, b) (b) = (a) && (b)
+#define LOR(a, b) (b) = (a) || (b)
+#define LXOR(a, b) (b) = !(a) != !(b)
+#define BAND(a, b) (b) = (b) & (a)
+#define BOR(a, b) (b) = (b) | (a)
+#define BXOR(a, b) (b) = (b) ^ (a)
+
+#define CHECK_ARITHMETIC_OPS(type, mpi_type)                                                                           \
+  CHECK_OP(type, mpi_type, SUM, MPI_SUM);                                                                              \
+  CHECK_OP(type, mpi_type, PROD, MPI_PROD);                                                                            \
+  CHECK_OP(type, mpi_type, MAX, MPI_MAX);                                                                              \
+  CHECK_OP(type, mpi_type, MIN, MPI_MIN);                                                                              \
+  CHECK_OP(type, mpi_type, LAND, MPI_LAND);                                                                            \
+  CHECK_OP(type, mpi_type, LOR, MPI_LOR);                                                                              \
+  CHECK_OP(type, mpi_type, LXOR, MPI_LXOR)
+
+#define CHECK_BITWISE_OPS(type, mpi_type)                                                                              \
+  CHECK_OP(type, mpi_type, BAND, MPI_BAND);                                                                            \
+  CHECK_OP(type, mpi_type, BOR, MPI_BOR);                                                                              \
+  CHECK_OP(type, mpi_type, BXOR, MPI_BXOR)
+
+struct double_int {
+  double value;
+  int index;
+};
+
+static void check_loc_ops(void)
+{
+  struct double_int in[COUNT];
+  struct double_int max[COUNT];
+  struct double_int min[COUNT];
+  for (int i = 0; i < COUNT; i++) {
+    in[i].value  = i % 7;
+    in[i].index  = i;
+    max[i].value = i % 5;
+    max[i].index = COUNT - i;
+    min[i]       = max[i];
+  }
+  MPI_Reduce_local(in, max, COUNT, MPI_DOUBLE_INT, MPI_MAXLOC);
+  MPI_Reduce_local(in, min, COUNT, MPI_DOUBLE_INT, MPI_MINLOC);
+  for (int i = 0; i < COUNT; i++) {
+    double other = i % 5;
+    int max_index = in[i].value > other ? i : (in[i].value < other ? COUNT - i : (i < COUNT - i ? i : COUNT - i));
+    int min_index = in[i].value < other ? i : (in[i].value > other ? COUNT - i : (i < COUNT - i ? i : COUNT - i));
+    if (max[i].index != max_index || min[i].index != min_index) {
+      printf("Wrong result of MPI_MAXLOC or MPI_MINLOC on MPI_DOUBLE_INT at %d\n", i);
+      errors++;
+      break;
+    }
+  }
+}
+
+static double wall_clock(void)
+{
+/* SMPI replaces clock_gettime() with the simulated clock, but we want the real one here */
+#undef clock_gettime
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+static void bench_op(const char* name, MPI_Datatype type, MPI_Op op, int count, int iterations)
+{
+  int size;
+  MPI_Type_size(type, &size);
+  char* in    = calloc(count, size);
+  char* inout = calloc(count, size);
+  double start = wall_clock();
+  for (int i = 0; i < iterations; i++)
+    MPI_Reduce_local(in, inout, count, type, op);
+  double elapsed = wall_clock() - start;
+  printf("%-16s %8.2f GB/s\n", name, (double)count * size * iterations / elapsed / 1e9);
+  free(in);
+  free(inout);
+}
+
+int main(int argc, char* argv[])
+{
+  MPI_Init(&argc, &argv);
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  if (rank == 0) {
+    MPI_Datatype dup;
+    MPI_Type_dup(MPI_DOUBLE, &dup);
+    CHECK_ARITHMETIC_OPS(int, MPI_INT);
+    CHECK_ARITHMETIC_OPS(long, MPI_LONG);
+    CHECK_ARITHMETIC_OPS(unsigned char, MPI_UNSIGNED_CHAR);
+    CHECK_ARITHMETIC_OPS(short, MPI_SHORT);
+    CHECK_ARITHMETIC_OPS(float, MPI_FLOAT);
+    CHECK_ARITHMETIC_OPS(double, MPI_DOUBLE);
+    CHECK_ARITHMETIC_OPS(double, dup);
+    CHECK_BITWISE_OPS(int, MPI_INT);
+    CHECK_BITWISE_OPS(long, MPI_LONG);
+    CHECK_BITWISE_OPS(unsigned char, MPI_UNSIGNED_CHAR);
+    CHECK_BITWISE_OPS(short, MPI_SHORT);
+    check_loc_ops();
+    MPI_Type_free(&dup);
+    printf("Reduction operations checked, %d error(s)\n", errors);
+
+    if (argc > 1 && strcmp(argv[1], "-b") == 0) {
+      int count      = argc > 2 ? atoi(argv[2]) : 1 << 16;
+      int iterations = argc > 3 ? atoi(argv[3]) : 1000;
+      bench_op("MPI_SUM int", MPI_INT, MPI_SUM, count, iterations);
+      bench_op("MPI_SUM float", MPI_FLOAT, MPI_SUM, count, iterations);
+      bench_op("MPI_SUM double", MPI_DOUBLE, MPI_SUM, count, iterations);
+      bench_op("MPI_MAX int", MPI_INT, MPI_MAX, count, iterations);
+      bench_op("MPI_MAX float", MPI_FLOAT, MPI_MAX, count, iterations);
+      bench_op("MPI_MAX double", MPI_DOUBLE, MPI_MAX, count, iterations);
+      bench_op("MPI_MIN int", MPI_INT, MPI_MIN, count, iterations);
+      bench_op("MPI_MIN float", MPI_FLOAT, MPI_MIN, count, iterations);
+      bench_op("MPI_MIN double", MPI_DOUBLE, MPI_MIN, count, iterations);
+    }
+  }
+
+  MPI_Finalize();
+  return 0;
+}
@@ -0,0 +1,45 @@
+/* Copyright (c) 2021. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Iterative exchanges between neighbors in a ring, whose time-independent trace is made of nested loops */
+
+#include <mpi.h>
+#include <stdio.h>
+
+#define ITERATIONS 50
+#define EXCHANGES 4
+#define COUNT 1024
+
+int main(int argc, char* argv[])
+{
+  int rank;
+  int size;
+  double send[COUNT];
+  double recv[COUNT];
+  double sum = 0;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  for (int i = 0; i < COUNT; i++)
+    send[i] = rank + i;
+
+  for (int it = 0; it < ITERATIONS; it++) {
+    for (int ex = 0; ex < EXCHANGES; ex++) {
+      MPI_Request requests[2];
+      MPI_Irecv(recv, COUNT, MPI_DOUBLE, (rank + size - 1) % size, 0, MPI_COMM_WORLD, &requests[0]);
+      MPI_Isend(send, COUNT, MPI_DOUBLE, (rank + 1) % size, 0, MPI_COMM_WORLD, &requests[1]);
+      MPI_Waitall(2, requests, MPI_STATUSES_IGNORE);
+    }
+    double local = recv[0];
+    MPI_Allreduce(&local, &sum, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  if (rank == 0)
+    printf("Sum after %d iterations: %g\n", ITERATIONS, sum);
+  MPI_Finalize();
+  return 0;
+}
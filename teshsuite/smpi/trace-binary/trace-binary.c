@@ -0,0 +1,39 @@
+/* Copyright (c) 2021. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Exchanges between neighbors in a ring and reductions, whose traces are written in both Paje and binary formats */
+
+#include <mpi.h>
+#include <stdio.h>
+
+#define ITERATIONS 10
+#define COUNT 1024
+
+int main(int argc, char* argv[])
+{
+  int rank;
+  int size;
+  double send[COUNT];
+  double recv[COUNT];
+  double sum = 0;
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  for (int i = 0; i < COUNT; i++)
+    send[i] = rank + i;
+
+  for (int it = 0; it < ITERATIONS; it++) {
+    MPI_Sendrecv(send, COUNT, MPI_DOUBLE, (rank + 1) % size, 0, recv, COUNT, MPI_DOUBLE, (rank + size - 1) % size, 0,
+                 MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    double local = recv[0];
+    MPI_Allreduce(&local, &sum, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  }
+
+  if (rank == 0)
+    printf("Sum after %d iterations: %g\n", ITERATIONS, sum);
+  MPI_Finalize();
+  return 0;
+}
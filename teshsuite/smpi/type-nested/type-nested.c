@@ -0,0 +1,188 @@
+/* Copyright (c) 2021. The SimGrid Team.
+ * All rights reserved.                                                     */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Packs, unpacks and accumulates nested derived datatypes, and compares the result with their type map.
+ * The committed types are compiled into plans, except the ones with too many blocks that are walked recursively. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "mpi.h"
+
+#define BIG_BLOCKS 70000 /* More blocks than a plan can hold */
+#define MEDIUM_BLOCKS 30000
+
+/* Checks count elements of type on a buffer of buffer_size integers, where the type selects the n integers of
+ * expected, in this order */
+static void check(MPI_Datatype type, int count, const int* expected, int n, int buffer_size)
+{
+  char name[MPI_MAX_OBJECT_NAME];
+  int len;
+  int errors = 0;
+  MPI_Type_get_name(type, name, &len);
+  int* buffer = malloc(buffer_size * sizeof(int));
+  int* packed = malloc(n * sizeof(int));
+
+  /* Packing gives the selected integers */
+  for (int i = 0; i < buffer_size; i++)
+    buffer[i] = i;
+  int position = 0;
+  MPI_Pack(buffer, count, type, packed, n * sizeof(int), &position, MPI_COMM_WORLD);
+  if (position != (int)(n * sizeof(int)))
+    errors++;
+  for (int i = 0; i < n; i++)
+    if (packed[i] != expected[i])
+      errors++;
+
+  /* Unpacking only writes the selected integers */
+  for (int i = 0; i < buffer_size; i++)
+    buffer[i] = -1;
+  position = 0;
+  MPI_Unpack(packed, n * sizeof(int), &position, buffer, count, type, MPI_COMM_WORLD);
+  for (int i = 0; i < n; i++)
+    if (buffer[expected[i]] != expected[i])
+      errors++;
+    else
+      buffer[expected[i]] = -1;
+  for (int i = 0; i < buffer_size; i++)
+    if (buffer[i] != -1)
+      errors++;
+
+  /* Accumulating only adds to the selected integers */
+  MPI_Win win;
+  for (int i = 0; i < buffer_size; i++)
+    buffer[i] = i;
+  MPI_Win_create(buffer, buffer_size * sizeof(int), sizeof(int), MPI_INFO_NULL, MPI_COMM_WORLD, &win);
+  MPI_Win_fence(0, win);
+  MPI_Accumulate(packed, n, MPI_INT, 0, 0, count, type, MPI_SUM, win);
+  MPI_Win_fence(0, win);
+  MPI_Win_free(&win);
+  for (int i = 0; i < n; i++)
+    if (buffer[expected[i]] != 2 * expected[i])
+      errors++;
+    else
+      buffer[expected[i]] /= 2;
+  for (int i = 0; i < buffer_size; i++)
+    if (buffer[i] != i)
+      errors++;
+
+  printf("%s: %d integers, %d errors\n", name, n, errors);
+  free(packed);
+  free(buffer);
+}
+
+int main(int argc, char** argv)
+{
+  int* expected = malloc(2 * BIG_BLOCKS * sizeof(int));
+  int n;
+
+  MPI_Init(&argc, &argv);
+
+  /* indexed: {0, 1, 5}, extent 6 */
+  MPI_Datatype indexed;
+  int indexed_lengths[2] = {2, 1};
+  int indexed_displs[2]  = {0, 5};
+  MPI_Type_indexed(2, indexed_lengths, indexed_displs, MPI_INT, &indexed);
+
+  /* vector of 3 blocks of 2 indexed types, every 4 indexed types: extent 60 */
+  MPI_Datatype vector_of_indexed;
+  MPI_Type_vector(3, 2, 4, indexed, &vector_of_indexed);
+  MPI_Type_set_name(vector_of_indexed, "vector of indexed");
+  MPI_Type_commit(&vector_of_indexed);
+  n = 0;
+  for (int elem = 0; elem < 2; elem++)
+    for (int block = 0; block < 3; block++)
+      for (int i = 0; i < 2; i++) {
+        int start     = elem * 60 + (block * 4 + i) * 6;
+        expected[n++] = start;
+        expected[n++] = start + 1;
+        expected[n++] = start + 5;
+      }
+  check(vector_of_indexed, 2, expected, n, 120);
+
+  /* vector: {0, 3}, extent 4 */
+  MPI_Datatype vector;
+  MPI_Type_vector(2, 1, 3, MPI_INT, &vector);
+
+  /* indexed of vectors: 1 vector at 0 and 2 vectors at 3 vectors: {0, 3, 12, 15, 16, 19}, extent 20 */
+  MPI_Datatype indexed_of_vector;
+  int nested_lengths[2] = {1, 2};
+  int nested_displs[2]  = {0, 3};
+  MPI_Type_indexed(2, nested_lengths, nested_displs, vector, &indexed_of_vector);
+  MPI_Type_set_name(indexed_of_vector, "indexed of vectors");
+  MPI_Type_commit(&indexed_of_vector);
+  const int indexed_of_vector_map[6] = {0, 3, 12, 15, 16, 19};
+  n = 0;
+  for (int elem = 0; elem < 3; elem++)
+    for (int i = 0; i < 6; i++)
+      expected[n++] = elem * 20 + indexed_of_vector_map[i];
+  check(indexed_of_vector, 3, expected, n, 60);
+
+  /* struct of 2 integers, a vector and an indexed of vectors: {0, 1, 2, 5, 10, 13, 22, 25, 26, 29}, extent 30 */
+  MPI_Datatype structure;
+  int struct_lengths[3]        = {2, 1, 1};
+  MPI_Aint struct_displs[3]    = {0, 2 * sizeof(int), 10 * sizeof(int)};
+  MPI_Datatype struct_types[3] = {MPI_INT, vector, indexed_of_vector};
+  MPI_Type_create_struct(3, struct_lengths, struct_displs, struct_types, &structure);
+  MPI_Type_set_name(structure, "struct of vectors and indexed");
+  MPI_Type_commit(&structure);
+  const int structure_map[10] = {0, 1, 2, 5, 10, 13, 22, 25, 26, 29};
+  n = 0;
+  for (int elem = 0; elem < 2; elem++)
+    for (int i = 0; i < 10; i++)
+      expected[n++] = elem * 30 + structure_map[i];
+  check(structure, 2, expected, n, 60);
+
+  /* hvector of 2 structs, 40 integers apart: extent 70 */
+  MPI_Datatype hvector_of_struct;
+  MPI_Type_create_hvector(2, 1, 40 * sizeof(int), structure, &hvector_of_struct);
+  MPI_Type_set_name(hvector_of_struct, "hvector of structs");
+  MPI_Type_commit(&hvector_of_struct);
+  n = 0;
+  for (int elem = 0; elem < 2; elem++)
+    for (int block = 0; block < 2; block++)
+      for (int i = 0; i < 10; i++)
+        expected[n++] = elem * 70 + block * 40 + structure_map[i];
+  check(hvector_of_struct, 2, expected, n, 140);
+
+  /* vector of many blocks, that still fits in a plan */
+  MPI_Datatype medium_vector;
+  MPI_Type_vector(MEDIUM_BLOCKS, 1, 2, MPI_INT, &medium_vector);
+  MPI_Type_set_name(medium_vector, "vector of 30000 blocks");
+  MPI_Type_commit(&medium_vector);
+  n = 0;
+  for (int i = 0; i < MEDIUM_BLOCKS; i++)
+    expected[n++] = 2 * i;
+  check(medium_vector, 1, expected, n, 2 * MEDIUM_BLOCKS);
+
+  /* struct of an integer and of a vector with too many blocks for a plan: {0, 1, 3, 5, ...} */
+  MPI_Datatype big_vector;
+  MPI_Type_vector(BIG_BLOCKS, 1, 2, MPI_INT, &big_vector);
+  MPI_Datatype big_struct;
+  int big_lengths[2]        = {1, 1};
+  MPI_Aint big_displs[2]    = {0, sizeof(int)};
+  MPI_Datatype big_types[2] = {MPI_INT, big_vector};
+  MPI_Type_create_struct(2, big_lengths, big_displs, big_types, &big_struct);
+  MPI_Type_set_name(big_struct, "struct of a vector of 70000 blocks");
+  MPI_Type_commit(&big_struct);
+  n             = 0;
+  expected[n++] = 0;
+  for (int i = 0; i < BIG_BLOCKS; i++)
+    expected[n++] = 1 + 2 * i;
+  check(big_struct, 1, expected, n, 2 * BIG_BLOCKS);
+
+  MPI_Type_free(&big_struct);
+  MPI_Type_free(&big_vector);
+  MPI_Type_free(&medium_vector);
+  MPI_Type_free(&hvector_of_struct);
+  MPI_Type_free(&structure);
+  MPI_Type_free(&indexed_of_vector);
+  MPI_Type_free(&vector);
+  MPI_Type_free(&vector_of_indexed);
+  MPI_Type_free(&indexed);
+  free(expected);
+  MPI_Finalize();
+  return 0;
+}
@@ -0,0 +1,132 @@
+/* Copyright (c) 2021. The SimGrid Team. All rights reserved.               */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Checks that the messages between buffers allocated with MPI_Alloc_mem are correctly transferred, even when the
+ * buffers are modified after the transfers (which matters when smpi/zero-copy-thresh is set, so that the pages are
+ * remapped instead of copied). */
+
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Not a multiple of the page size, so that the buffers end in the middle of a page */
+#define SIZE (1024 * 1024 + 100)
+
+static int errors = 0;
+
+static void fill(unsigned char* buf, int from, int to, int seed)
+{
+  for (int i = from; i < to; i++)
+    buf[i] = (unsigned char)(i * seed + i / 4096 + seed);
+}
+
+static void check(const char* what, const unsigned char* buf, const unsigned char* expected, int size)
+{
+  if (memcmp(buf, expected, size) != 0) {
+    printf("%s: unexpected content\n", what);
+    errors++;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  int rank;
+  int size;
+  unsigned char* a;
+  unsigned char* b;
+  unsigned char* expected = malloc(SIZE);
+
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &size);
+  if (size != 3) {
+    if (rank == 0)
+      printf("This test needs 3 processes\n");
+    MPI_Finalize();
+    return 0;
+  }
+  MPI_Alloc_mem(SIZE, MPI_INFO_NULL, &a);
+  MPI_Alloc_mem(SIZE, MPI_INFO_NULL, &b);
+  memset(b, 0, SIZE);
+
+  /* Rank 0 sends its buffer to rank 1 */
+  if (rank == 0) {
+    fill(a, 0, SIZE, 1);
+    MPI_Send(a, SIZE, MPI_BYTE, 1, 0, MPI_COMM_WORLD);
+  } else if (rank == 1) {
+    MPI_Recv(b, SIZE, MPI_BYTE, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  /* Both buffers are then modified: this must not change the other one */
+  if (rank == 0)
+    fill(a, 0, SIZE / 2, 2);
+  else if (rank == 1)
+    fill(b, 3 * SIZE / 4, SIZE, 3);
+  MPI_Barrier(MPI_COMM_WORLD);
+  if (rank == 0) {
+    fill(expected, 0, SIZE / 2, 2);
+    fill(expected, SIZE / 2, SIZE, 1);
+    check("Modified send buffer", a, expected, SIZE);
+  } else if (rank == 1) {
+    fill(expected, 0, 3 * SIZE / 4, 1);
+    fill(expected, 3 * SIZE / 4, SIZE, 3);
+    check("Modified receive buffer", b, expected, SIZE);
+  }
+
+  /* Partly modified buffers are sent again to rank 2, from the sender and from the receiver of the first message */
+  if (rank == 0 || rank == 1) {
+    MPI_Send(rank == 0 ? a : b, SIZE, MPI_BYTE, 2, 0, MPI_COMM_WORLD);
+  } else {
+    for (int src = 0; src < 2; src++) {
+      MPI_Recv(src == 0 ? a : b, SIZE, MPI_BYTE, src, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+      fill(expected, 0, src == 0 ? SIZE / 2 : 3 * SIZE / 4, src == 0 ? 2 : 1);
+      fill(expected, src == 0 ? SIZE / 2 : 3 * SIZE / 4, SIZE, src == 0 ? 1 : 3);
+      check(src == 0 ? "Resent buffer" : "Forwarded buffer", src == 0 ? a : b, expected, SIZE);
+    }
+  }
+
+  /* Buffers that do not start at the beginning of a page, with the same offset or not */
+  if (rank == 0) {
+    MPI_Send(a + 1, SIZE - 1, MPI_BYTE, 1, 0, MPI_COMM_WORLD);
+    MPI_Send(a + 1, SIZE - 2, MPI_BYTE, 2, 0, MPI_COMM_WORLD);
+  } else if (rank == 1) {
+    MPI_Recv(b + 1, SIZE - 1, MPI_BYTE, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    fill(expected, 0, 1, 1);
+    fill(expected, 1, SIZE / 2, 2);
+    fill(expected, SIZE / 2, SIZE, 1);
+    check("Unaligned buffer", b, expected, SIZE);
+  } else {
+    MPI_Recv(a + 2, SIZE - 2, MPI_BYTE, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    fill(expected, 0, SIZE / 2, 2);
+    fill(expected, SIZE / 2, SIZE, 1);
+    check("Misaligned buffer", a + 2, expected + 1, SIZE - 2);
+  }
+
+  /* Messages from and to buffers that were not allocated with MPI_Alloc_mem */
+  unsigned char* c = malloc(SIZE);
+  if (rank == 0) {
+    fill(c, 0, SIZE, 4);
+    MPI_Send(c, SIZE, MPI_BYTE, 1, 0, MPI_COMM_WORLD);
+    MPI_Recv(a, SIZE, MPI_BYTE, 1, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    fill(expected, 0, SIZE, 4);
+    check("Buffer sent back", a, expected, SIZE);
+  } else if (rank == 1) {
+    MPI_Recv(b, SIZE, MPI_BYTE, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    MPI_Send(b, SIZE, MPI_BYTE, 0, 0, MPI_COMM_WORLD);
+  }
+  free(c);
+
+  int total;
+  MPI_Reduce(&errors, &total, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+  if (rank == 0)
+    printf("Zero-copy transfers checked, %d error(s)\n", total);
+  MPI_Free_mem(a);
+  MPI_Free_mem(b);
+  free(expected);
+  MPI_Finalize();
+  return 0;
+}
@@ -90,6 +90,7 @@ set(SMPI_SRC
   src/smpi/internals/smpi_bench.cpp
   src/smpi/internals/smpi_memory.cpp
   src/smpi/internals/smpi_shared.cpp
+  src/smpi/internals/smpi_zero_copy.cpp
   src/smpi/internals/smpi_deployment.cpp
   src/smpi/internals/smpi_global.cpp
   src/smpi/internals/smpi_host.cpp
@@ -155,12 +156,14 @@ set(SMPI_SRC
   src/smpi/bindings/smpi_f77_type.cpp
   src/smpi/colls/smpi_coll.cpp
   src/smpi/colls/smpi_nbc_impl.cpp
+  src/smpi/colls/smpi_analytical_colls.cpp
   src/smpi/colls/smpi_automatic_selector.cpp
   src/smpi/colls/smpi_default_selector.cpp
   src/smpi/colls/smpi_mpich_selector.cpp
   src/smpi/colls/smpi_intel_mpi_selector.cpp
   src/smpi/colls/smpi_openmpi_selector.cpp
   src/smpi/colls/smpi_mvapich2_selector.cpp
+  src/smpi/colls/smpi_table_selector.cpp
   src/smpi/colls/allgather/allgather-2dmesh.cpp
   src/smpi/colls/allgather/allgather-3dmesh.cpp
   src/smpi/colls/allgather/allgather-GB.cpp
@@ -343,6 +346,7 @@ set(SURF_SRC
 
   src/kernel/EngineImpl.cpp
   src/kernel/EngineImpl.hpp
+  src/kernel/Profiler.cpp
 
   src/surf/cpu_cas01.cpp
   src/surf/cpu_interface.cpp
@@ -358,6 +362,8 @@ set(SURF_SRC
   src/surf/surf_c_bindings.cpp
   src/surf/surf_interface.cpp
   src/surf/xml/platf.hpp
+  src/surf/xml/platf_cache.cpp
+  src/surf/xml/platf_cache.hpp
   src/surf/xml/platf_private.hpp
   src/surf/xml/surfxml_sax_cb.cpp
   src/surf/xml/surfxml_parseplatf.cpp
@@ -375,6 +381,7 @@ set(PLUGINS_SRC
   src/plugins/link_energy_wifi.cpp
   src/plugins/host_load.cpp
   src/plugins/link_load.cpp
+  src/plugins/metrics.cpp
   src/plugins/file_system/s4u_FileSystem.cpp
   src/plugins/vm/VirtualMachineImpl.hpp
   src/plugins/vm/s4u_VirtualMachine.cpp
@@ -551,6 +558,8 @@ set(LUA_SRC
   )
 
 set(TRACING_SRC
+  src/instr/instr_binary_trace.cpp
+  src/instr/instr_binary_trace.hpp
   src/instr/instr_config.cpp
   src/instr/instr_interface.cpp
   src/instr/instr_paje_containers.cpp
@@ -565,6 +574,7 @@ set(TRACING_SRC
   src/instr/instr_platform.cpp
   src/instr/instr_private.hpp
   src/instr/instr_smpi.hpp
+  src/instr/instr_ti_loops.cpp
   src/instr/instr_resource_utilization.cpp
   )
 
@@ -684,6 +694,7 @@ set(headers_to_install
   include/simgrid/plugins/file_system.h
   include/simgrid/plugins/live_migration.h
   include/simgrid/plugins/load.h
+  include/simgrid/plugins/metrics.h
   include/simgrid/plugins/ProducerConsumer.hpp
   include/simgrid/smpi/smpi_replay.hpp
   include/simgrid/instr.h
@@ -693,6 +704,7 @@ set(headers_to_install
   include/simgrid/forward.h
   include/simgrid/simix.h
   include/simgrid/simix.hpp
+  include/simgrid/kernel/Profiler.hpp
   include/simgrid/kernel/Timer.hpp
   include/simgrid/kernel/future.hpp
   include/simgrid/disk.h
@@ -766,6 +778,7 @@ set(headers_to_install
   include/xbt/functional.hpp
   include/xbt/function_types.h
   include/xbt/graph.h
+  include/xbt/indexed_heap.hpp
   include/xbt/log.h
   include/xbt/log.hpp
   include/xbt/mallocator.h
@@ -1081,6 +1094,7 @@ set(CMAKEFILES_TXT
 
   tools/CMakeLists.txt
   tools/graphicator/CMakeLists.txt
+  tools/trace-converter/CMakeLists.txt
   tools/tesh/CMakeLists.txt
   )
 
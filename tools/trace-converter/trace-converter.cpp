@@ -0,0 +1,172 @@
+/* Copyright (c) 2021. The SimGrid Team.
+ * All rights reserved.                                                     */
+
+/* This program is free software; you can redistribute it and/or modify it
+ * under the terms of the license (GNU LGPL) which comes with this package. */
+
+/* Converts the binary traces (written with tracing/paje/encoding:Binary) into the Paje trace that would have been
+ * written without that option, or into a CSV file listing the timed events with the names of their containers and
+ * types. */
+
+#include "simgrid/Exception.hpp"
+#include "src/instr/instr_binary_trace.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+using simgrid::instr::BinaryTraceReader;
+using simgrid::instr::BinaryTraceRecord;
+using simgrid::instr::PajeEventType;
+
+static void convert_to_paje(BinaryTraceReader& reader, std::ostream& os)
+{
+  os << reader.get_paje_header();
+  BinaryTraceRecord record;
+  while (reader.next(record)) {
+    os << record.event_type;
+    for (auto const& field : record.fields)
+      os << ' ' << field;
+    os << '\n';
+  }
+}
+
+static std::string csv_field(const std::string& str)
+{
+  if (str.find_first_of(",\"\n") == std::string::npos)
+    return str;
+  std::string quoted = "\"";
+  for (char c : str) {
+    if (c == '"')
+      quoted += '"';
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+static std::string unquote(const std::string& str)
+{
+  return str.substr(1, str.size() - 2);
+}
+
+static void convert_to_csv(BinaryTraceReader& reader, std::ostream& os)
+{
+  static const std::unordered_map<int, std::string> event_names = {
+      {static_cast<int>(PajeEventType::CreateContainer), "PajeCreateContainer"},
+      {static_cast<int>(PajeEventType::DestroyContainer), "PajeDestroyContainer"},
+      {static_cast<int>(PajeEventType::SetVariable), "PajeSetVariable"},
+      {static_cast<int>(PajeEventType::AddVariable), "PajeAddVariable"},
+      {static_cast<int>(PajeEventType::SubVariable), "PajeSubVariable"},
+      {static_cast<int>(PajeEventType::SetState), "PajeSetState"},
+      {static_cast<int>(PajeEventType::PushState), "PajePushState"},
+      {static_cast<int>(PajeEventType::PopState), "PajePopState"},
+      {static_cast<int>(PajeEventType::ResetState), "PajeResetState"},
+      {static_cast<int>(PajeEventType::StartLink), "PajeStartLink"},
+      {static_cast<int>(PajeEventType::EndLink), "PajeEndLink"},
+      {static_cast<int>(PajeEventType::NewEvent), "PajeNewEvent"}};
+  std::unordered_map<std::string, std::string> types;
+  std::unordered_map<std::string, std::string> values;
+  std::unordered_map<std::string, std::string> containers;
+
+  os << "event,time,container,type,value,endpoint,key,size\n";
+  BinaryTraceRecord record;
+  while (reader.next(record)) {
+    if (not reader.get_root_container_id().empty()) // the root container is not created by any record
+      containers.emplace(reader.get_root_container_id(), reader.get_root_container_name());
+    const auto& fields = record.fields;
+    std::string value;
+    std::string endpoint;
+    std::string key;
+    std::string size;
+    switch (record.event_type) {
+      case PajeEventType::DefineContainerType:
+      case PajeEventType::DefineVariableType:
+      case PajeEventType::DefineStateType:
+      case PajeEventType::DefineEventType:
+        types[fields[0]] = fields[2];
+        continue;
+      case PajeEventType::DefineLinkType:
+        types[fields[0]] = fields[4];
+        continue;
+      case PajeEventType::DefineEntityValue:
+        values[fields[0]] = fields[2];
+        continue;
+      case PajeEventType::CreateContainer:
+        containers[fields[1]] = unquote(fields[4]);
+        os << "PajeCreateContainer," << fields[0] << ',' << csv_field(containers[fields[1]]) << ','
+           << csv_field(types[fields[2]]) << ',' << csv_field(containers[fields[3]]) << ",,,\n";
+        continue;
+      case PajeEventType::DestroyContainer:
+        os << "PajeDestroyContainer," << fields[0] << ',' << csv_field(containers[fields[2]]) << ','
+           << csv_field(types[fields[1]]) << ",,,,\n";
+        continue;
+      case PajeEventType::SetVariable:
+      case PajeEventType::AddVariable:
+      case PajeEventType::SubVariable:
+        value = fields[3];
+        break;
+      case PajeEventType::SetState:
+      case PajeEventType::PushState:
+      case PajeEventType::PopState:
+      case PajeEventType::ResetState: {
+        size_t next = 3;
+        if (record.state_has_value)
+          value = values[fields[next++]];
+        if (next < fields.size() && (fields[next].empty() || fields[next].front() != '"'))
+          size = fields[next];
+        break;
+      }
+      case PajeEventType::StartLink:
+      case PajeEventType::EndLink:
+        value    = fields[3];
+        endpoint = containers[fields[4]];
+        key      = fields[5];
+        if (fields.size() > 6)
+          size = fields[6];
+        break;
+      case PajeEventType::NewEvent:
+        value = values[fields[3]];
+        break;
+      default:
+        continue;
+    }
+    os << event_names.at(static_cast<int>(record.event_type)) << ',' << fields[0] << ','
+       << csv_field(containers[fields[2]]) << ',' << csv_field(types[fields[1]]) << ',' << csv_field(value) << ','
+       << csv_field(endpoint) << ',' << csv_field(key) << ',' << csv_field(size) << '\n';
+  }
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 3 || argc > 4 || (std::string(argv[1]) != "paje" && std::string(argv[1]) != "csv")) {
+    std::cerr << "Usage: " << argv[0] << " <paje|csv> <binary trace> [output file]\n";
+    return 1;
+  }
+  std::ifstream input(argv[2], std::ifstream::in | std::ifstream::binary);
+  if (input.fail()) {
+    std::cerr << argv[0] << ": cannot open " << argv[2] << "\n";
+    return 1;
+  }
+  std::ofstream output;
+  if (argc == 4) {
+    output.open(argv[3], std::ofstream::out | std::ofstream::binary);
+    if (output.fail()) {
+      std::cerr << argv[0] << ": cannot open " << argv[3] << " for writing\n";
+      return 1;
+    }
+  }
+  std::ostream& os = argc == 4 ? output : std::cout;
+
+  try {
+    BinaryTraceReader reader(input);
+    if (std::string(argv[1]) == "paje")
+      convert_to_paje(reader, os);
+    else
+      convert_to_csv(reader, os);
+  } catch (const simgrid::TracingError& e) {
+    std::cerr << argv[0] << ": " << argv[2] << ": " << e.what() << "\n";
+    return 1;
+  }
+  return 0;
+}